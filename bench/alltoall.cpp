@@ -0,0 +1,129 @@
+/*
+ * UPC++ benchmark: Team alltoall latency
+ *
+ * The first `team_ranks` ranks of world form a team by world().split() and
+ * repeatedly exchange `block` bytes with every team member through
+ * upcxx::alltoall() until the time runs out. Block sizes up to
+ * UPCXX_ALLTOALL_BRUCK_MAX take Bruck's algorithm, larger ones go
+ * pairwise, eagerly up to UPCXX_ALLTOALL_EAGER_MAX and by rput beyond. To
+ * compare algorithms at one size, run once with each setting:
+ *
+ *   UPCXX_ALLTOALL_BRUCK_MAX=0 ./alltoall
+ *   UPCXX_ALLTOALL_BRUCK_MAX=1048576 ./alltoall
+ *
+ * Reported dimensions:
+ *
+ *   team_ranks: Team size.
+ *
+ *   block: Bytes sent to each team member.
+ *
+ *   algo = {bruck|eager|rput}: Algorithm this block size took, going by
+ *     the environment as this run saw it.
+ *
+ * Reported measurements:
+ *
+ *   lat = Seconds per alltoall.
+ *
+ *   bw = Bytes per second sent by each rank, not counting its own block.
+ *
+ * Environment variables:
+ *
+ *   team_ranks (integer list, default=powers of 2 below rank_n, and rank_n):
+ *     Team sizes.
+ *
+ *   blocks (integer list, default="8 64 256 1024 8192 65536"): Block
+ *     sizes in bytes.
+ *
+ *   wait_secs (decimal, default=0.5): Seconds to run each measurement.
+ */
+
+#include <upcxx/upcxx.hpp>
+
+#include "common/os_env.hpp"
+#include "common/report.hpp"
+#include "common/timer.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace bench;
+
+int main() {
+  upcxx::init();
+
+  const int me = upcxx::rank_me(), n = upcxx::rank_n();
+
+  vector<int> default_ranks;
+  for(int r = 1; r < n; r *= 2)
+    default_ranks.push_back(r);
+  default_ranks.push_back(n);
+
+  vector<int> ranks = os_env<vector<int>>("team_ranks", default_ranks);
+  vector<int> blocks = os_env<vector<int>>("blocks", vector<int>({8, 64, 256, 1024, 8192, 65536}));
+  double wait_secs = os_env<double>("wait_secs", 0.5);
+  long bruck_max = os_env<long>("UPCXX_ALLTOALL_BRUCK_MAX", 256);
+  long eager_max = os_env<long>("UPCXX_ALLTOALL_EAGER_MAX", 8192);
+
+  struct result { int ranks, block; double lat; };
+  vector<result> results;
+
+  for(int team_n: ranks) {
+    if(team_n < 1 || team_n > n)
+      continue;
+
+    upcxx::team tm = upcxx::world().split(me < team_n ? 0 : upcxx::team::color_none, me);
+
+    if(me < team_n) {
+      for(int block: blocks) {
+        vector<char> src(size_t(team_n)*block, char(me)), dst(size_t(team_n)*block);
+        long passed = 0;
+
+        upcxx::barrier(tm);
+        timer tim;
+        double secs;
+        // Run in doubling rounds. Rank 0 decides after each whether time is
+        // up, so all ranks pass the same number of alltoalls.
+        for(long round = 1; true; round *= 2) {
+          for(long i = 0; i < round; i++)
+            upcxx::alltoall(src.data(), dst.data(), block, tm).wait();
+          passed += round;
+
+          secs = tim.elapsed();
+          if(upcxx::broadcast(secs >= wait_secs, 0, tm).wait())
+            break;
+        }
+
+        for(int r = 0; r < team_n; r++)
+          UPCXX_ASSERT_ALWAYS(dst[size_t(r)*block] == char(r));
+
+        results.push_back({team_n, block, secs/passed});
+      }
+    }
+
+    tm.destroy();
+  }
+
+  if(me == 0) {
+    report rep(__FILE__);
+
+    for(result const &r: results) {
+      char const *algo = r.block <= bruck_max ? "bruck" :
+                         r.block <= eager_max ? "eager" :
+                                                "rput";
+      rep.emit({"lat", "bw"},
+        column("lat", r.lat) &
+        column("bw", (r.ranks - 1)*double(r.block)/r.lat) &
+        column("team_ranks", r.ranks) &
+        column("block", r.block) &
+        column("algo", algo)
+      );
+    }
+    rep.blank();
+  }
+
+  if (!upcxx::rank_me())  std::cout << "SUCCESS" << std::endl;
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * UPC++ benchmark: World barrier latency
+ *
+ * All ranks repeatedly pass upcxx::barrier() (or a window of
+ * upcxx::barrier_async()) until the time runs out. The barrier
+ * implementation is chosen at startup by UPCXX_BARRIER, so compare them
+ * by running once with each value, for instance with 64 or more ranks
+ * per node:
+ *
+ *   UPCXX_BARRIER=gasnet ./barrier
+ *   UPCXX_BARRIER=hier ./barrier
+ *
+ * Reported dimensions:
+ *
+ *   impl = {gasnet|hier}: UPCXX_BARRIER as this run saw it.
+ *
+ *   via = {sync|async}:
+ *     sync: upcxx::barrier().
+ *     async: `window` upcxx::barrier_async()'s in flight, waited on
+ *       together.
+ *
+ *   window: barrier_async()'s per wait, 1 for sync.
+ *
+ * Reported measurements:
+ *
+ *   lat = Seconds per barrier.
+ *
+ * Environment variables:
+ *
+ *   windows (integer list, default="1 8"): barrier_async() window sizes.
+ *
+ *   wait_secs (decimal, default=1): Seconds to run each measurement.
+ */
+
+#include <upcxx/upcxx.hpp>
+
+#include "common/os_env.hpp"
+#include "common/report.hpp"
+#include "common/timer.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace bench;
+
+int main() {
+  upcxx::init();
+
+  vector<int> windows = os_env<vector<int>>("windows", vector<int>({1, 8}));
+  double wait_secs = os_env<double>("wait_secs", 1.0);
+  string impl = os_env<string>("UPCXX_BARRIER", string("gasnet"));
+
+  struct result { char const *via; int window; double lat; };
+  vector<result> results;
+
+  auto measure = [&](char const *via, int window, bool sync) {
+    long passed = 0;
+    vector<upcxx::future<>> futs(window);
+
+    upcxx::barrier();
+    timer tim;
+    double secs;
+    // Run in doubling rounds. Rank 0 decides after each whether time is up,
+    // so all ranks pass the same number of barriers.
+    for(long round = 1; true; round *= 2) {
+      for(long i = 0; i < round; i++) {
+        if(sync)
+          upcxx::barrier();
+        else {
+          for(int w = 0; w < window; w++)
+            futs[w] = upcxx::barrier_async();
+          for(int w = 0; w < window; w++)
+            futs[w].wait();
+        }
+      }
+      passed += round*window;
+
+      secs = tim.elapsed();
+      if(upcxx::broadcast(secs >= wait_secs, 0).wait())
+        break;
+    }
+
+    results.push_back({via, window, secs/passed});
+  };
+
+  measure("sync", 1, true);
+  for(int window: windows)
+    measure("async", window, false);
+
+  if(upcxx::rank_me() == 0) {
+    report rep(__FILE__);
+
+    for(result const &r: results) {
+      rep.emit({"lat"},
+        column("lat", r.lat) &
+        column("impl", impl) &
+        column("via", r.via) &
+        column("window", r.window)
+      );
+    }
+    rep.blank();
+  }
+
+  if (!upcxx::rank_me())  std::cout << "SUCCESS" << std::endl;
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * UPC++ benchmark: Distributed hash map
+ *
+ * Every rank inserts its share of string keys into a distributed map, then
+ * looks up as many keys chosen at random from the whole key space. The
+ * programmer's guide maps (example/prog-guide/dmap*.hpp), which send one rpc
+ * per key, are compared against upcxx::dist_unordered_map, which aggregates
+ * operations per destination.
+ *
+ * Reported dimensions:
+ *
+ *   op = {insert|find}
+ *
+ *   via:
+ *     guide: example/prog-guide/dmap.hpp, one rpc and future per insert/find.
+ *     guide_ff: example/prog-guide/dmap-ff.hpp, inserts are rpc_ff's.
+ *     batched: dist_unordered_map::insert (futures) and find.
+ *     batched_ff: dist_unordered_map::insert_ff and find.
+ *
+ *   batch: the dist_unordered_map batch size (0 for the guide maps).
+ *
+ * Reported measurements:
+ *
+ *   ops = Operations per second summed over all ranks, each phase timed
+ *     from the barrier before it to the barrier after it.
+ *
+ * Environment variables:
+ *
+ *   keys (integer, default=100000): Keys inserted per rank.
+ *
+ *   batches (integer list, default="64 256 1024"): dist_unordered_map batch
+ *     sizes to measure.
+ *
+ *   val_len (integer, default=16): Length of each value string.
+ */
+
+#include <upcxx/upcxx.hpp>
+
+#include "common/operator_new.hpp"
+#include "common/os_env.hpp"
+#include "common/report.hpp"
+#include "common/timer.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Both guide headers name their class DistrMap.
+namespace guide {
+  #include "../example/prog-guide/dmap.hpp"
+}
+namespace guide_ff {
+  #include "../example/prog-guide/dmap-ff.hpp"
+}
+
+using namespace std;
+using namespace bench;
+
+int keys_per_rank;
+int val_len;
+
+string key_of(long i) {
+  return "k" + to_string(i);
+}
+
+struct rates { double insert, find; };
+
+// Runs `insert(i)` over this rank's keys then `finish()`, and then `find(k)`
+// on random keys, timing each phase between barriers.
+template<typename Insert, typename Finish, typename Find>
+rates run(Insert insert, Finish finish, Find find) {
+  const long me = upcxx::rank_me(), n = upcxx::rank_n();
+  rates ans;
+
+  upcxx::barrier();
+  timer t;
+  for(long i = 0; i < keys_per_rank; i++)
+    insert(me*keys_per_rank + i);
+  finish();
+  upcxx::barrier();
+  ans.insert = double(n*keys_per_rank)/t.reset();
+
+  std::mt19937_64 rng(me);
+  std::vector<upcxx::future<>> found;
+  found.reserve(keys_per_rank);
+  for(long i = 0; i < keys_per_rank; i++)
+    found.push_back(find(rng() % (n*keys_per_rank)));
+  upcxx::when_all(found.begin(), found.end()).wait();
+  upcxx::barrier();
+  ans.find = double(n*keys_per_rank)/t.reset();
+
+  return ans;
+}
+
+// Waits until rpc_ff-inserted keys have all arrived: every rank counts what
+// it sent to each owner, and owners spin until their shard holds that many.
+template<typename LocalSize>
+void quiesce(std::vector<long> &sent, LocalSize local_size) {
+  long expect = 0;
+  for(int r = 0; r < upcxx::rank_n(); r++) {
+    long x = upcxx::reduce_one(sent[r], upcxx::op_fast_add, r).wait();
+    if(r == upcxx::rank_me()) expect = x;
+  }
+  while(local_size() != expect)
+    upcxx::progress();
+}
+
+int main() {
+  upcxx::init();
+
+  keys_per_rank = os_env<int>("keys", 100000);
+  val_len = os_env<int>("val_len", 16);
+  vector<int> batches = os_env<vector<int>>("batches", vector<int>({64, 256, 1024}));
+
+  const string val(val_len, 'v');
+  vector<pair<row<char const*, int>, rates>> results;
+
+  {
+    guide::DistrMap m;
+    vector<upcxx::future<>> done;
+    rates r = run(
+      [&](long i) { done.push_back(m.insert(key_of(i), val)); },
+      [&]() { upcxx::when_all(done.begin(), done.end()).wait(); },
+      [&](long i) { return m.find(key_of(i)).then([](string const&) {}); }
+    );
+    results.push_back({column("via", "guide") & column("batch", 0), r});
+  }
+
+  {
+    guide_ff::DistrMap m;
+    vector<long> sent(upcxx::rank_n(), 0);
+    rates r = run(
+      [&](long i) { string k = key_of(i); sent[m.get_target_rank(k)] += 1; m.insert(k, val); },
+      [&]() { quiesce(sent, [&]() { return long(m.local_size()); }); },
+      [&](long i) { return m.find(key_of(i)).then([](string const&) {}); }
+    );
+    results.push_back({column("via", "guide_ff") & column("batch", 0), r});
+  }
+
+  for(int batch: batches) {
+    upcxx::dist_unordered_map<string, string> m(upcxx::world(), batch);
+    vector<upcxx::future<>> done;
+    rates r = run(
+      [&](long i) { done.push_back(m.insert(key_of(i), val)); },
+      [&]() { upcxx::when_all(done.begin(), done.end()).wait(); },
+      [&](long i) { return m.find(key_of(i)).then([](bool, string const&) {}); }
+    );
+    results.push_back({column("via", "batched") & column("batch", batch), r});
+  }
+
+  for(int batch: batches) {
+    upcxx::dist_unordered_map<string, string> m(upcxx::world(), batch);
+    vector<long> sent(upcxx::rank_n(), 0);
+    rates r = run(
+      [&](long i) { string k = key_of(i); sent[m.owner_of(k)] += 1; m.insert_ff(k, val); },
+      [&]() { m.flush(); quiesce(sent, [&]() { return long(m.local().size()); }); },
+      [&](long i) { return m.find(key_of(i)).then([](bool, string const&) {}); }
+    );
+    results.push_back({column("via", "batched_ff") & column("batch", batch), r});
+  }
+
+  if(upcxx::rank_me() == 0) {
+    report rep(__FILE__);
+
+    for(auto const &x: results) {
+      for(char const *op: {"insert", "find"}) {
+        rep.emit({"ops"},
+          column("ops", op[0] == 'i' ? x.second.insert : x.second.find) &
+          column("op", op) &
+          column("keys", keys_per_rank) &
+          opnew_row() &
+          x.first
+        );
+      }
+    }
+    rep.blank();
+  }
+
+  if (!upcxx::rank_me())  std::cout << "SUCCESS" << std::endl;
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * UPC++ benchmark: Ghost-cell exchange of a 3D distributed array
+ *
+ * Ranks are arranged in a near-cubic 3D process grid. Each owns a cube of
+ * doubles in a periodic upcxx::dist_array, and repeatedly exchanges the
+ * ghost faces with its six neighbours until the time runs out. This is the
+ * regular-neighbour version of nebr_exchange.cpp.
+ *
+ * Reported dimensions:
+ *
+ *   edge: Elements per side of each rank's cube.
+ *
+ *   ghost: Ghost width in elements.
+ *
+ *   via = {sync|async}:
+ *     sync: dist_array::exchange(), which barriers before and after.
+ *     async: dist_array::exchange_async() followed by a single barrier,
+ *       which is enough when every step writes the interior only after
+ *       reading ghosts.
+ *
+ * Reported measurements:
+ *
+ *   steps = Exchanges per second.
+ *
+ *   bw = Ghost bytes received per second, averaged over ranks.
+ *
+ * Environment variables:
+ *
+ *   edges (integer list, default="16 64"): Cube edge lengths.
+ *
+ *   ghosts (integer list, default="1 2"): Ghost widths.
+ *
+ *   wait_secs (decimal, default=1): Seconds to run each measurement.
+ */
+
+#include <upcxx/upcxx.hpp>
+#include <upcxx/dist_array.hpp>
+
+#include "common/os_env.hpp"
+#include "common/report.hpp"
+#include "common/timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace bench;
+
+// Splits n into three factors as close to each other as possible.
+array<upcxx::intrank_t, 3> grid_of(int n) {
+  array<upcxx::intrank_t, 3> g{{1, 1, 1}};
+  for(int f = 2; n > 1; ) {
+    if(n % f == 0) {
+      *min_element(g.begin(), g.end()) *= f;
+      n /= f;
+    }
+    else
+      f += 1;
+  }
+  return g;
+}
+
+int main() {
+  upcxx::init();
+
+  vector<size_t> edges = os_env<vector<size_t>>("edges", vector<size_t>({16, 64}));
+  vector<size_t> ghosts = os_env<vector<size_t>>("ghosts", vector<size_t>({1, 2}));
+  double wait_secs = os_env<double>("wait_secs", 1.0);
+
+  const auto procs = grid_of(upcxx::rank_n());
+
+  struct result { size_t edge, ghost; char const *via; double steps, bw; };
+  vector<result> results;
+
+  for(size_t edge: edges) {
+    for(size_t ghost: ghosts) {
+      if(ghost > edge) continue;
+
+      upcxx::dist_array<double, 3> a(
+        {{edge*procs[0], edge*procs[1], edge*procs[2]}}, procs, ghost, /*periodic=*/true
+      );
+      const double face_bytes = 6.0*edge*edge*ghost*sizeof(double);
+
+      for(char const *via: {"sync", "async"}) {
+        bool sync = via[0] == 's';
+        long steps = 0;
+
+        upcxx::barrier();
+        timer tim;
+        double secs;
+        // Run in doubling rounds. Rank 0 decides after each whether time is
+        // up, so all ranks run the same number of steps.
+        for(long round = 1; true; round *= 2) {
+          for(long i = 0; i < round; i++) {
+            if(sync)
+              a.exchange();
+            else {
+              a.exchange_async().wait();
+              upcxx::barrier();
+            }
+          }
+          steps += round;
+
+          secs = tim.elapsed();
+          if(upcxx::broadcast(secs >= wait_secs, 0).wait())
+            break;
+        }
+
+        results.push_back({edge, ghost, via, steps/secs, steps*face_bytes/secs});
+      }
+    }
+  }
+
+  if(upcxx::rank_me() == 0) {
+    report rep(__FILE__);
+
+    for(result const &r: results) {
+      rep.emit({"steps", "bw"},
+        column("steps", r.steps) &
+        column("bw", r.bw) &
+        column("edge", r.edge) &
+        column("ghost", r.ghost) &
+        column("via", r.via)
+      );
+    }
+    rep.blank();
+  }
+
+  if (!upcxx::rank_me())  std::cout << "SUCCESS" << std::endl;
+  upcxx::finalize();
+  return 0;
+}
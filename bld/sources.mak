@@ -7,6 +7,7 @@ libupcxx_sources = \
 	backend/gasnet/runtime.cpp   \
 	backend/gasnet/upc_link.c    \
 	future/core.cpp              \
+	alltoall.cpp                 \
 	atomic.cpp                   \
 	barrier.cpp                  \
 	broadcast.cpp                \
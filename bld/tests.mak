@@ -11,12 +11,46 @@ testprograms_seq = \
 	barrier.cpp \
 	rpc_barrier.cpp \
 	rpc_ff_ring.cpp \
+	rpc_aggregate.cpp \
+	rpc_cutover.cpp \
+	rpc_rdzv_pool.cpp \
+	perf_counters.cpp \
+	wait_policy.cpp \
+	bcast_tree.cpp \
+	reduce_tree.cpp \
+	shm_ring.cpp \
+	hcb_flood.cpp \
+	object_cache.cpp \
+	when_all_range.cpp \
+	coroutine.cpp \
+	rpc_presize.cpp \
+	view_nested.cpp \
+	registry.cpp \
+	dist_unordered_map.cpp \
+	dist_array.cpp \
+	atomic_cpu.cpp \
+	atomic_bulk.cpp \
+	atomic_bulk_gex.cpp \
+	atomic_bulk_am.cpp \
+	barrier_hier.cpp \
+	barrier_hier_groups.cpp \
+	team_ranks.cpp \
+	team_create.cpp \
+	alltoall.cpp \
 	rput.cpp \
 	vis.cpp \
 	vis_stress.cpp \
 	uts/uts_ranks.cpp
 
 testprograms_par = \
+	alloc_threads.cpp \
+	thread_churn.cpp \
+	progress_thread.cpp \
 	rput_thread.cpp \
+	shm_ring.cpp \
+	object_cache.cpp \
 	uts/uts_hybrid.cpp \
 	view.cpp
+
+# Extra compiler flags for individual tests, dropped if the compiler rejects them
+testflags_coroutine.cpp = -std=c++20
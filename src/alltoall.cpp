@@ -0,0 +1,350 @@
+#include <upcxx/alltoall.hpp>
+#include <upcxx/allocate.hpp>
+#include <upcxx/rput.hpp>
+#include <upcxx/view.hpp>
+#include <upcxx/backend/gasnet/runtime.hpp>
+#include <upcxx/backend/gasnet/runtime_internal.hpp>
+
+#include <cstring>
+
+using namespace upcxx;
+using namespace std;
+
+namespace gasnet = upcxx::backend::gasnet;
+
+////////////////////////////////////////////////////////////////////////
+// Both algorithms run on AMs tagged with the collective's id, so like
+// gasnet::am_coll they work over any team, and whatever arrives before we
+// join waits in the collective's registered state.
+
+namespace {
+  void alltoall_complete(gasnet::handle_cb *cb) {
+    // Completions target the master persona, which is active (the caller
+    // asserted so, or we are in its progress).
+    cb->handle = reinterpret_cast<std::uintptr_t>(GEX_EVENT_INVALID);
+    detail::persona_scope_redundant master_on_top(backend::master, detail::the_persona_tls);
+    gasnet::register_cb(cb);
+  }
+
+  std::unique_ptr<char[]> alltoall_copy(upcxx::view<char> bytes) {
+    std::unique_ptr<char[]> buf{new char[bytes.size()]};
+    std::copy(bytes.begin(), bytes.end(), buf.get());
+    return buf;
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // Bruck: ceil(log2(n)) rounds. Slot i of `tmp` holds the block bound for
+  // rank me+i. Round k forwards every slot with bit k set to rank me+2^k,
+  // so after the last round slot i holds the block from rank me-i.
+
+  struct bruck_state {
+    bool joined = false;
+    std::vector<std::unique_ptr<char[]>> inbox; // by round, from rank me-2^round
+
+    // Filled in when we join.
+    team_id tm_id;
+    intrank_t n, me;
+    std::size_t block;
+    char *dst;
+    std::unique_ptr<char[]> tmp;
+    std::vector<char> pack;
+    int round;
+    bool sent; // this round's message is out
+    gasnet::handle_cb *cb;
+  };
+
+  void bruck_advance(upcxx::digest id, bruck_state *st) {
+    while(true) {
+      intrank_t dist = intrank_t(1) << st->round;
+
+      if(dist >= st->n) {
+        for(intrank_t i=0; i < st->n; i++) {
+          intrank_t from = (st->me - i + st->n) % st->n;
+          std::memcpy(st->dst + from*st->block, st->tmp.get() + i*st->block, st->block);
+        }
+
+        detail::registry.erase(id);
+        gasnet::handle_cb *cb = st->cb;
+        delete st;
+        alltoall_complete(cb);
+        return;
+      }
+
+      if(!st->sent) {
+        char *p = st->pack.data();
+        for(intrank_t i=0; i < st->n; i++) {
+          if(i & dist) {
+            std::memcpy(p, st->tmp.get() + i*st->block, st->block);
+            p += st->block;
+          }
+        }
+
+        int round = st->round;
+        backend::send_am_master<progress_level::internal>(
+          st->tm_id.here(), (st->me + dist) % st->n,
+          upcxx::bind(
+            [=](upcxx::view<char> bytes) {
+              bruck_state *st = detail::registered_state<bruck_state>(id);
+
+              if(st->inbox.size() <= std::size_t(round))
+                st->inbox.resize(round + 1);
+              st->inbox[round] = alltoall_copy(bytes);
+
+              if(st->joined && st->round == round)
+                bruck_advance(id, st);
+            },
+            upcxx::make_view(st->pack.data(), p)
+          )
+        );
+        st->sent = true;
+      }
+
+      if(st->inbox.size() <= std::size_t(st->round) || !st->inbox[st->round])
+        return; // resumed by its arrival
+
+      char const *p = st->inbox[st->round].get();
+      for(intrank_t i=0; i < st->n; i++) {
+        if(i & dist) {
+          std::memcpy(st->tmp.get() + i*st->block, p, st->block);
+          p += st->block;
+        }
+      }
+      st->inbox[st->round].reset();
+      st->round += 1;
+      st->sent = false;
+    }
+  }
+
+  void bruck(
+      const team &tm, std::size_t block, const char *src, char *dst,
+      gasnet::handle_cb *cb
+    ) {
+    upcxx::digest id = const_cast<team&>(tm).next_collective_id(detail::internal_only());
+    bruck_state *st = detail::registered_state<bruck_state>(id);
+
+    intrank_t n = tm.rank_n(), me = tm.rank_me();
+
+    st->joined = true;
+    st->tm_id = tm.id();
+    st->n = n;
+    st->me = me;
+    st->block = block;
+    st->dst = dst;
+    st->tmp.reset(new char[n*block]);
+    st->pack.resize(((n + 1)/2)*block); // most slots any round sends
+    st->round = 0;
+    st->sent = false;
+    st->cb = cb;
+
+    for(intrank_t i=0; i < n; i++)
+      std::memcpy(st->tmp.get() + i*block, src + ((me + i) % n)*block, block);
+
+    bruck_advance(id, st);
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // Pairwise: rank me+k's block goes straight to it for k = 1..n-1. Blocks
+  // up to alltoall_eager_max bytes ride in an AM. Larger ones are rput by
+  // the sender once the receiver has sent it a landing address, which is in
+  // `dst` itself when that is in the shared segment. Empty blocks send
+  // nothing.
+
+  struct pairwise_state {
+    bool joined = false;
+    std::vector<std::pair<intrank_t, std::unique_ptr<char[]>>> early_blocks; // eager blocks before we joined
+    std::vector<std::pair<intrank_t, global_ptr<char>>> early_lands; // landing addresses before we joined
+
+    // Filled in when we join.
+    intrank_t me;
+    const char *src;
+    char *dst;
+    std::vector<std::size_t> send_bytes, send_offs, recv_bytes, recv_offs;
+    global_ptr<char> landing; // staging for large blocks when `dst` is private
+    std::vector<char*> staged; // by sender, where its rput lands if not in `dst`
+    int awaiting; // blocks to arrive plus our rputs to complete
+    gasnet::handle_cb *cb;
+  };
+
+  void pairwise_done_one(upcxx::digest id, pairwise_state *st) {
+    if(0 != --st->awaiting)
+      return;
+
+    if(st->landing)
+      upcxx::deallocate(st->landing);
+
+    detail::registry.erase(id);
+    gasnet::handle_cb *cb = st->cb;
+    delete st;
+    alltoall_complete(cb);
+  }
+
+  void pairwise_rput(upcxx::digest id, pairwise_state *st, intrank_t to, global_ptr<char> gp) {
+    intrank_t me = st->me;
+
+    upcxx::rput(
+      st->src + st->send_offs[to], gp, st->send_bytes[to],
+      remote_cx::as_rpc(
+        [](upcxx::digest id, intrank_t from) {
+          pairwise_state *st = detail::registered_state<pairwise_state>(id);
+          if(st->staged[from] != nullptr)
+            std::memcpy(st->dst + st->recv_offs[from], st->staged[from], st->recv_bytes[from]);
+          pairwise_done_one(id, st);
+        },
+        id, me
+      ) |
+      operation_cx::as_future()
+    ).then([=]() {
+      pairwise_done_one(id, detail::registered_state<pairwise_state>(id));
+    });
+  }
+
+  void pairwise(
+      const team &tm, std::size_t elt_sz,
+      const char *src, const std::size_t *send_counts, const std::size_t *send_displs,
+      char *dst, const std::size_t *recv_counts, const std::size_t *recv_displs,
+      std::size_t count,
+      gasnet::handle_cb *cb
+    ) {
+    upcxx::digest id = const_cast<team&>(tm).next_collective_id(detail::internal_only());
+    pairwise_state *st = detail::registered_state<pairwise_state>(id);
+
+    intrank_t n = tm.rank_n(), me = tm.rank_me();
+    std::size_t eager_max = gasnet::alltoall_eager_max;
+
+    st->joined = true;
+    st->me = me;
+    st->src = src;
+    st->dst = dst;
+    st->send_bytes.resize(n);
+    st->send_offs.resize(n);
+    st->recv_bytes.resize(n);
+    st->recv_offs.resize(n);
+    st->staged.assign(n, nullptr);
+    st->awaiting = 1; // released below once everything is started
+    st->cb = cb;
+
+    for(intrank_t r=0; r < n; r++) {
+      st->send_bytes[r] = elt_sz*(send_counts ? send_counts[r] : count);
+      st->send_offs[r] = elt_sz*(send_displs ? send_displs[r] : r*count);
+      st->recv_bytes[r] = elt_sz*(recv_counts ? recv_counts[r] : count);
+      st->recv_offs[r] = elt_sz*(recv_displs ? recv_displs[r] : r*count);
+    }
+
+    UPCXX_ASSERT(st->send_bytes[me] == st->recv_bytes[me]);
+    if(st->recv_bytes[me] != 0)
+      std::memmove(dst + st->recv_offs[me], src + st->send_offs[me], st->recv_bytes[me]);
+
+    // Incoming: count every nonempty block, and send each large one's
+    // sender its landing address.
+    std::size_t stage_bytes = 0;
+    for(intrank_t r=0; r < n; r++) {
+      if(r == me || st->recv_bytes[r] == 0)
+        continue;
+      st->awaiting += 1;
+      if(st->recv_bytes[r] > eager_max && !upcxx::try_global_ptr(dst + st->recv_offs[r]))
+        stage_bytes += st->recv_bytes[r];
+    }
+
+    char *stage = nullptr;
+    if(stage_bytes != 0) {
+      st->landing = upcxx::allocate<char>(stage_bytes);
+      UPCXX_ASSERT_ALWAYS(st->landing, "alltoall: out of shared segment staging "<<stage_bytes<<" bytes");
+      stage = st->landing.local();
+    }
+
+    for(intrank_t k=1; k < n; k++) {
+      intrank_t r = (me - k + n) % n;
+      std::size_t bytes = st->recv_bytes[r];
+      if(bytes <= eager_max)
+        continue;
+
+      global_ptr<char> gp = upcxx::try_global_ptr(dst + st->recv_offs[r]);
+      if(!gp) {
+        st->staged[r] = stage;
+        gp = upcxx::to_global_ptr(stage);
+        stage += bytes;
+      }
+
+      backend::send_am_master<progress_level::internal>(
+        tm, r,
+        upcxx::bind(
+          [=](global_ptr<char> gp) {
+            pairwise_state *st = detail::registered_state<pairwise_state>(id);
+
+            if(st->joined)
+              pairwise_rput(id, st, me, gp);
+            else
+              st->early_lands.push_back({me, gp});
+          },
+          gp
+        )
+      );
+    }
+
+    // Outgoing: eager blocks now, large ones once their address is here.
+    for(intrank_t k=1; k < n; k++) {
+      intrank_t r = (me + k) % n;
+      std::size_t bytes = st->send_bytes[r];
+      if(bytes == 0)
+        continue;
+
+      if(bytes > eager_max) {
+        st->awaiting += 1;
+        continue;
+      }
+
+      const char *p = src + st->send_offs[r];
+      backend::send_am_master<progress_level::internal>(
+        tm, r,
+        upcxx::bind(
+          [=](upcxx::view<char> bytes) {
+            pairwise_state *st = detail::registered_state<pairwise_state>(id);
+
+            if(st->joined) {
+              std::copy(bytes.begin(), bytes.end(), st->dst + st->recv_offs[me]);
+              pairwise_done_one(id, st);
+            }
+            else
+              st->early_blocks.push_back({me, alltoall_copy(bytes)});
+          },
+          upcxx::make_view(p, p + bytes)
+        )
+      );
+    }
+
+    for(auto &from_block: st->early_blocks) {
+      intrank_t from = from_block.first;
+      std::memcpy(dst + st->recv_offs[from], from_block.second.get(), st->recv_bytes[from]);
+      st->awaiting -= 1;
+    }
+    st->early_blocks.clear();
+
+    for(auto const &from_gp: st->early_lands)
+      pairwise_rput(id, st, from_gp.first, from_gp.second);
+    st->early_lands.clear();
+
+    pairwise_done_one(id, st);
+  }
+}
+
+void detail::alltoall_trivial(
+    const team &tm, std::size_t elt_sz,
+    const void *src, const std::size_t *send_counts, const std::size_t *send_displs,
+    void *dst, const std::size_t *recv_counts, const std::size_t *recv_displs,
+    std::size_t count,
+    backend::gasnet::handle_cb *cb
+  ) {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+
+  // Every rank of an alltoall passes the same count, so they all agree on
+  // Bruck. alltoallv ranks can't know each other's sizes.
+  if(send_counts == nullptr && elt_sz*count <= gasnet::alltoall_bruck_max)
+    bruck(tm, elt_sz*count, static_cast<const char*>(src), static_cast<char*>(dst), cb);
+  else
+    pairwise(
+      tm, elt_sz,
+      static_cast<const char*>(src), send_counts, send_displs,
+      static_cast<char*>(dst), recv_counts, recv_displs,
+      count, cb
+    );
+}
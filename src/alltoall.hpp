@@ -0,0 +1,133 @@
+#ifndef _3f6c2a8e_91d4_4b57_a0e3_5c7d2e18b4f9
+#define _3f6c2a8e_91d4_4b57_a0e3_5c7d2e18b4f9
+
+#include <upcxx/backend.hpp>
+#include <upcxx/completion.hpp>
+#include <upcxx/serialization.hpp>
+#include <upcxx/team.hpp>
+
+namespace upcxx {
+  namespace detail {
+    ////////////////////////////////////////////////////////////////////
+    // alltoall_event_values: Value for completions_state's EventValues
+    // template argument.
+
+    struct alltoall_event_values {
+      template<typename Event>
+      using tuple_t = std::tuple<>;
+    };
+
+    // Exchanges blocks of `elt_sz`-byte elements between all ranks of `tm`.
+    // Block r of `src` goes to rank r, landing as our block of its `dst`.
+    // With null count and displacement arrays every block has `count`
+    // elements and block r starts at element r*count.
+    void alltoall_trivial(
+      const team &tm, std::size_t elt_sz,
+      const void *src, const std::size_t *send_counts, const std::size_t *send_displs,
+      void *dst, const std::size_t *recv_counts, const std::size_t *recv_displs,
+      std::size_t count,
+      backend::gasnet::handle_cb *cb
+    );
+
+    template<typename Cxs>
+    struct alltoall_cb final: backend::gasnet::handle_cb {
+      detail::completions_state<
+        /*EventPredicate=*/detail::event_is_here,
+        /*EventValues=*/detail::alltoall_event_values,
+        Cxs> cxs_state;
+
+      alltoall_cb(Cxs &&cxs): cxs_state(std::move(cxs)) {}
+
+      void execute_and_delete(backend::gasnet::handle_cb_successor) override {
+        cxs_state.template operator()<operation_cx_event>();
+        delete this;
+      }
+    };
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // upcxx::alltoall
+
+  // Sends block r of `src` (elements [r*count, (r+1)*count)) to team rank r,
+  // and receives block r of `dst` from it. Both buffers must stay valid
+  // until operation completion.
+  template<typename T,
+           typename Cxs = completions<future_cx<operation_cx_event>>>
+  typename detail::completions_returner<
+      /*EventPredicate=*/detail::event_is_here,
+      /*EventValues=*/detail::alltoall_event_values,
+      Cxs
+    >::return_t
+  alltoall(
+      T const *src, T *dst, std::size_t count,
+      const team &tm = upcxx::world(),
+      Cxs cxs = completions<future_cx<operation_cx_event>>{{}}
+    ) {
+    static_assert(
+      upcxx::is_trivially_serializable<T>::value,
+      "Only TriviallySerializable types permitted for `upcxx::alltoall`."
+    );
+
+    auto *cb = new detail::alltoall_cb<Cxs>(std::move(cxs));
+
+    detail::completions_returner<
+        /*EventPredicate=*/detail::event_is_here,
+        /*EventValues=*/detail::alltoall_event_values,
+        Cxs>
+      returner(cb->cxs_state);
+
+    detail::alltoall_trivial(
+      tm, sizeof(T),
+      src, nullptr, nullptr,
+      dst, nullptr, nullptr,
+      count, cb
+    );
+
+    return returner();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // upcxx::alltoallv
+
+  // Like alltoall, but the block for team rank r is `send_counts[r]`
+  // elements at `src + send_displs[r]`, and the one from rank r is
+  // `recv_counts[r]` elements at `dst + recv_displs[r]`. Rank r's
+  // send_counts[me] must equal our recv_counts[r]. The count and
+  // displacement arrays are read before this returns.
+  template<typename T,
+           typename Cxs = completions<future_cx<operation_cx_event>>>
+  typename detail::completions_returner<
+      /*EventPredicate=*/detail::event_is_here,
+      /*EventValues=*/detail::alltoall_event_values,
+      Cxs
+    >::return_t
+  alltoallv(
+      T const *src, std::size_t const *send_counts, std::size_t const *send_displs,
+      T *dst, std::size_t const *recv_counts, std::size_t const *recv_displs,
+      const team &tm = upcxx::world(),
+      Cxs cxs = completions<future_cx<operation_cx_event>>{{}}
+    ) {
+    static_assert(
+      upcxx::is_trivially_serializable<T>::value,
+      "Only TriviallySerializable types permitted for `upcxx::alltoallv`."
+    );
+
+    auto *cb = new detail::alltoall_cb<Cxs>(std::move(cxs));
+
+    detail::completions_returner<
+        /*EventPredicate=*/detail::event_is_here,
+        /*EventValues=*/detail::alltoall_event_values,
+        Cxs>
+      returner(cb->cxs_state);
+
+    detail::alltoall_trivial(
+      tm, sizeof(T),
+      src, send_counts, send_displs,
+      dst, recv_counts, recv_displs,
+      0, cb
+    );
+
+    return returner();
+  }
+}
+#endif
@@ -1,13 +1,21 @@
 #include <upcxx/diagnostic.hpp>
 #include <upcxx/atomic.hpp>
+#include <upcxx/bind.hpp>
+#include <upcxx/team.hpp>
+#include <upcxx/view.hpp>
+#include <upcxx/backend/gasnet/runtime.hpp>
 #include <upcxx/backend/gasnet/runtime_internal.hpp>
 
 #if UPCXX_BACKEND_GASNET
   #include <gasnet_ratomic.h>
 #endif
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 namespace gasnet = upcxx::backend::gasnet;
 namespace detail = upcxx::detail;
@@ -121,6 +129,111 @@ gex_Event_t atomic_domain_untyped<8,2>::inject(
 } } // namespace upcxx::detail
   
 namespace {
+  inline void op_nbi(gex_AD_t ad, uint32_t *r, intrank_t rank, void *p, gex_OP_t op, uint32_t a, gex_Flags_t f) {
+    gex_AD_OpNBI_U32(ad, r, rank, p, op, a, 0, f);
+  }
+  inline void op_nbi(gex_AD_t ad, int32_t *r, intrank_t rank, void *p, gex_OP_t op, int32_t a, gex_Flags_t f) {
+    gex_AD_OpNBI_I32(ad, r, rank, p, op, a, 0, f);
+  }
+  inline void op_nbi(gex_AD_t ad, float *r, intrank_t rank, void *p, gex_OP_t op, float a, gex_Flags_t f) {
+    gex_AD_OpNBI_FLT(ad, r, rank, p, op, a, 0, f);
+  }
+  inline void op_nbi(gex_AD_t ad, uint64_t *r, intrank_t rank, void *p, gex_OP_t op, uint64_t a, gex_Flags_t f) {
+    gex_AD_OpNBI_U64(ad, r, rank, p, op, a, 0, f);
+  }
+  inline void op_nbi(gex_AD_t ad, int64_t *r, intrank_t rank, void *p, gex_OP_t op, int64_t a, gex_Flags_t f) {
+    gex_AD_OpNBI_I64(ad, r, rank, p, op, a, 0, f);
+  }
+  inline void op_nbi(gex_AD_t ad, double *r, intrank_t rank, void *p, gex_OP_t op, double a, gex_Flags_t f) {
+    gex_AD_OpNBI_DBL(ad, r, rank, p, op, a, 0, f);
+  }
+
+  // Addition that wraps for signed integers, as the atomics themselves do.
+  template<typename T>
+  T wrap_add(T a, T b, std::true_type/*integral*/) {
+    using U = typename std::make_unsigned<T>::type;
+    return T(U(a) + U(b));
+  }
+  template<typename T>
+  T wrap_add(T a, T b, std::false_type/*integral*/) {
+    return a + b;
+  }
+
+  upcxx::future<> event_as_future(gex_Event_t h) {
+    if(h == GEX_EVENT_INVALID)
+      return upcxx::make_future();
+    return gasnet::register_handle_as_future(h);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Remote bulk batches travel as internal-level AMs, like the single ops
+  // gasnet itself carries, so the target needs no user-level progress.
+
+  // A member's registered handle for a domain. Batches that arrive before
+  // the member has constructed the domain wait here.
+  struct bulk_target {
+    std::uintptr_t ad = 0;
+    std::vector<std::function<void(std::uintptr_t)>> early;
+  };
+
+  // A batch at its target: copies of the shipped operands, and room for the
+  // fetched values that go back.
+  template<typename P>
+  struct bulk_batch {
+    atomic_op opcode;
+    gex_Flags_t flags;
+    intrank_t from;
+    std::uintptr_t reply;
+    std::vector<void*> raws;
+    std::vector<P> vals, got;
+  };
+
+  // The initiator's side of a batch, addressed by the reply.
+  template<typename P>
+  struct bulk_reply {
+    upcxx::detail::future_header_promise<> *pro; // holds ref
+    P *results;
+    std::vector<std::size_t> index;
+  };
+
+  template<typename AD>
+  void bulk_apply(std::uintptr_t ad, bulk_batch<typename AD::proxy_type> *b) {
+    using P = typename AD::proxy_type;
+
+    gex_Event_t h = AD::inject_bulk(
+      ad, b->got.empty() ? nullptr : b->got.data(), upcxx::rank_me(),
+      b->raws.data(), b->opcode, b->vals.data(), b->raws.size(),
+      b->flags | GEX_FLAG_RANK_IS_JOBRANK
+    );
+
+    auto send_reply = [=]() {
+      upcxx::backend::send_am_master<upcxx::progress_level::internal>(
+        upcxx::world(), b->from,
+        upcxx::bind(
+          [](std::uintptr_t reply, upcxx::view<P> got) {
+            bulk_reply<P> *r = reinterpret_cast<bulk_reply<P>*>(reply);
+            std::size_t j = 0;
+            for(P x: got)
+              r->results[r->index[j++]] = x;
+            upcxx::backend::fulfill_during<upcxx::progress_level::user>(
+              /*move ref*/r->pro, std::tuple<>()
+            );
+            delete r;
+          },
+          b->reply, upcxx::make_view(b->got)
+        )
+      );
+      delete b;
+    };
+
+    if(h == GEX_EVENT_INVALID)
+      send_reply();
+    else {
+      gasnet::handle_cb *cb = gasnet::make_handle_cb(std::move(send_reply));
+      cb->handle = reinterpret_cast<std::uintptr_t>(h);
+      gasnet::register_cb(cb);
+    }
+  }
 
   // check a handful of enum mappings to ensure no insert/delete errors
   static_assert((int)upcxx::atomic_op::mul == GEX_OP_MULT, "Uh-oh");
@@ -146,13 +259,37 @@ upcxx::detail::atomic_domain_untyped<size,bit_flavor>::atomic_domain_untyped(
   }
 
   parent_tm_ = &tm;
+
+  // Every member agrees: if the team spans nodes then each member has some
+  // other member off its node, and init agreed on UPCXX_CPU_ATOMICS
+  // job-wide. gex_AD_Create is collective, so a member going its own way
+  // would hang the others.
+  cpu_atomics = gasnet::cpu_atomics_enabled && tm.rank_n() <= backend::pshm_peer_n;
+  for (intrank_t r = 0; cpu_atomics && r < tm.rank_n(); r++)
+    cpu_atomics = backend::rank_is_local(tm[r]);
   
-  if(opmask) {
+  if(opmask && cpu_atomics) {
+    // No gasnet domain, so that nothing reaches this memory except through
+    // CPU atomics.
+    ad_gex_handle = 1;
+  } else if(opmask) {
+    UPCXX_ASSERT_ALWAYS(!tm.base(detail::internal_only()).via_world,
+      "atomic_domain over a team from team::create() or team::split_async() "
+      "requires CPU atomics, so the team must be confined to one node.");
+
     // Create the gasnet atomic domain for the world team.
     gex_AD_Create(reinterpret_cast<gex_AD_t*>(&ad_gex_handle),
                   gasnet::handle_of(tm), 
                   dt, opmask, /*flags=*/0);
     UPCXX_ASSERT(ad_gex_handle, "Error in gex_AD_Create");
+
+    bulk_id = const_cast<team&>(tm).next_collective_id(detail::internal_only());
+    bulk_target *t = detail::registered_state<bulk_target>(bulk_id);
+    t->ad = ad_gex_handle;
+    for(auto &apply: t->early)
+      apply(t->ad);
+    t->early.clear();
+    bulk_registered = true;
   } else { // this is a "null" domain
     ad_gex_handle = 1;
   }
@@ -167,9 +304,15 @@ void upcxx::detail::atomic_domain_untyped<size,bit_flavor>::destroy(entry_barrie
   UPCXX_ASSERT(ad_gex_handle, "attempted to destroy() and atomic_domain which was not constructed");
   
   if(atomic_gex_ops) {
-    gex_AD_Destroy(reinterpret_cast<gex_AD_t>(ad_gex_handle));
+    if(!cpu_atomics)
+      gex_AD_Destroy(reinterpret_cast<gex_AD_t>(ad_gex_handle));
     atomic_gex_ops = 0;
   }
+  if(bulk_registered) {
+    delete detail::registered_state<bulk_target>(bulk_id);
+    detail::registry.erase(bulk_id);
+    bulk_registered = false;
+  }
   ad_gex_handle = 0;
 }
 
@@ -183,6 +326,147 @@ upcxx::detail::atomic_domain_untyped<size,bit_flavor>::~atomic_domain_untyped()
   }
 }
 
+template<std::size_t size, int bit_flavor>
+gex_Event_t upcxx::detail::atomic_domain_untyped<size,bit_flavor>::inject_bulk(
+    std::uintptr_t ad, proxy_type *results, intrank_t jobrank, void *const *raws,
+    atomic_op opcode, proxy_type const *vals, std::size_t n, gex_Flags_t flags
+  ) {
+  gex_NBI_BeginAccessRegion(0);
+  for(std::size_t i=0; i < n; i++)
+    op_nbi(reinterpret_cast<gex_AD_t>(ad), results ? results + i : nullptr,
+           jobrank, raws[i], (gex_OP_t)opcode, vals[i], flags);
+  return gex_NBI_EndAccessRegion(0);
+}
+
+template<std::size_t size, int bit_flavor>
+upcxx::future<> upcxx::detail::atomic_domain_untyped<size,bit_flavor>::bulk(
+    atomic_op opcode, global_ptr<proxy_type> const *gptrs,
+    proxy_type const *vals, proxy_type *results, std::size_t n,
+    std::memory_order order
+  ) const {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+
+  if(cpu_atomics) {
+    for(std::size_t i=0; i < n; i++) {
+      proxy_type r = atomic_cpu_apply<proxy_type>(
+        backend::localize_memory_nonnull(gptrs[i].rank_, reinterpret_cast<std::uintptr_t>(gptrs[i].raw_ptr_)),
+        opcode, vals ? vals[i] : proxy_type(0), proxy_type(0), order
+      );
+      if(results) results[i] = r;
+    }
+    return upcxx::make_future();
+  }
+
+  const gex_Flags_t flags = memory_order_flags(order);
+
+  // Targets on our node are issued right away, all in one access region,
+  // fetching straight into `results`. The rest are grouped by rank.
+  struct group {
+    std::vector<std::uintptr_t> addrs; // raw pointers, only meaningful there
+    std::vector<proxy_type> vals;
+    std::vector<std::size_t> index; // position in the caller's arrays
+  };
+  std::unordered_map<intrank_t, group> remote;
+  group *last = nullptr;
+  intrank_t last_rank = -1;
+
+  gex_NBI_BeginAccessRegion(0);
+  for(std::size_t i=0; i < n; i++) {
+    intrank_t rank = gptrs[i].rank_;
+    proxy_type v = vals ? vals[i] : proxy_type(0);
+
+    if(gasnet::bulk_atomics_local && backend::rank_is_local(rank))
+      op_nbi(reinterpret_cast<gex_AD_t>(ad_gex_handle), results ? results + i : nullptr,
+             rank, gptrs[i].raw_ptr_, (gex_OP_t)opcode, v, flags | GEX_FLAG_RANK_IS_JOBRANK);
+    else {
+      if(rank != last_rank) {
+        last = &remote[rank];
+        last_rank = rank;
+      }
+      last->addrs.push_back(reinterpret_cast<std::uintptr_t>(gptrs[i].raw_ptr_));
+      last->vals.push_back(v);
+      if(results) last->index.push_back(i);
+    }
+  }
+  gex_Event_t h = gex_NBI_EndAccessRegion(0);
+
+  if(remote.empty())
+    return event_as_future(h);
+
+  std::vector<future<>> done;
+  done.reserve(1 + remote.size());
+  done.push_back(event_as_future(h));
+
+  // Summing operands is only sound when nothing is fetched. Floating point
+  // is left alone since it would change rounding.
+  const bool combine = results == nullptr && bit_flavor != 2 &&
+    (opcode == atomic_op::add || opcode == atomic_op::sub);
+
+  for(auto &rank_group: remote) {
+    intrank_t rank = rank_group.first;
+    group &g = rank_group.second;
+
+    if(combine && g.addrs.size() > 1) {
+      std::vector<std::pair<std::uintptr_t, proxy_type>> ops(g.addrs.size());
+      for(std::size_t j=0; j < ops.size(); j++)
+        ops[j] = {g.addrs[j], g.vals[j]};
+      std::sort(ops.begin(), ops.end(),
+        [](std::pair<std::uintptr_t, proxy_type> const &a,
+           std::pair<std::uintptr_t, proxy_type> const &b) {
+          return a.first < b.first;
+        });
+
+      g.addrs.clear();
+      g.vals.clear();
+      for(auto const &op: ops) {
+        if(!g.addrs.empty() && g.addrs.back() == op.first)
+          g.vals.back() = wrap_add(g.vals.back(), op.second, std::is_integral<proxy_type>());
+        else {
+          g.addrs.push_back(op.first);
+          g.vals.push_back(op.second);
+        }
+      }
+    }
+
+    bulk_reply<proxy_type> *r = new bulk_reply<proxy_type>;
+    r->pro = new detail::future_header_promise<>;
+    r->results = results;
+    r->index = std::move(g.index);
+    done.push_back(detail::promise_get_future(r->pro));
+
+    backend::send_am_master<progress_level::internal>(
+      upcxx::world(), rank,
+      upcxx::bind(
+        [](upcxx::digest id, atomic_op opcode, gex_Flags_t flags, bool fetch,
+           intrank_t from, std::uintptr_t reply,
+           view<std::uintptr_t> addrs, view<proxy_type> vals) {
+          auto *b = new bulk_batch<proxy_type>;
+          b->opcode = opcode;
+          b->flags = flags;
+          b->from = from;
+          b->reply = reply;
+          for(std::uintptr_t a: addrs)
+            b->raws.push_back(reinterpret_cast<void*>(a));
+          b->vals.assign(vals.begin(), vals.end());
+          b->got.resize(fetch ? b->raws.size() : 0);
+
+          using self = atomic_domain_untyped<size,bit_flavor>;
+          bulk_target *t = detail::registered_state<bulk_target>(id);
+          if(t->ad != 0)
+            bulk_apply<self>(t->ad, b);
+          else
+            t->early.push_back([=](std::uintptr_t ad) { bulk_apply<self>(ad, b); });
+        },
+        bulk_id, opcode, flags, results != nullptr,
+        upcxx::rank_me(), reinterpret_cast<std::uintptr_t>(r),
+        make_view(g.addrs), make_view(g.vals)
+      )
+    );
+  }
+
+  return when_all(done.begin(), done.end());
+}
+
 template struct upcxx::detail::atomic_domain_untyped<4,0>;
 template struct upcxx::detail::atomic_domain_untyped<4,1>;
 template struct upcxx::detail::atomic_domain_untyped<4,2>;
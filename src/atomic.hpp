@@ -3,14 +3,17 @@
 
 #include <upcxx/backend.hpp>
 #include <upcxx/completion.hpp>
+#include <upcxx/digest.hpp>
 #include <upcxx/global_ptr.hpp>
 
 #include <upcxx/backend/gasnet/runtime.hpp>
 
 #include <gasnet_fwd.h>
 
+#include <atomic>
 #include <climits>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <type_traits>
@@ -44,6 +47,15 @@ namespace upcxx {
     extern const char *atomic_op_str(upcxx::atomic_op op);
     extern std::string opset_to_string(gex_OP_t opset);
 
+    // True for the operations that produce a value.
+    inline bool atomic_op_fetches(upcxx::atomic_op op) {
+      return 0 != (static_cast<gex_OP_t>(op) & (
+        GEX_OP_GET | GEX_OP_FCAS | GEX_OP_FADD | GEX_OP_FSUB | GEX_OP_FINC |
+        GEX_OP_FDEC | GEX_OP_FMULT | GEX_OP_FMIN | GEX_OP_FMAX | GEX_OP_FAND |
+        GEX_OP_FOR | GEX_OP_FXOR
+      ));
+    }
+
     inline int memory_order_flags(std::memory_order order) {
       switch (order) {
         case std::memory_order_acquire: return GEX_FLAG_AD_ACQ;
@@ -82,6 +94,105 @@ namespace upcxx {
       return std::is_floating_point<T>::value ? 2 : (std::is_unsigned<T>::value ? 0 : 1);
     }
 
+    // Performs `op` on *p with CPU atomics and returns the value fetched
+    // (the prior value, or the loaded one). Memory ordering is provided with
+    // fences around a relaxed access, which is also how `load` can be given
+    // release and `store` acquire semantics.
+    template<typename T, bool integral = std::is_integral<T>::value>
+    struct atomic_cpu;
+
+    template<typename T>
+    struct atomic_cpu<T, /*integral=*/true> {
+      using U = typename std::make_unsigned<T>::type;
+
+      template<typename Fn>
+      static T update(std::atomic<T> *a, Fn fn) {
+        T old = a->load(std::memory_order_relaxed);
+        while(!a->compare_exchange_weak(old, fn(old), std::memory_order_relaxed))
+          {}
+        return old;
+      }
+
+      static T apply(std::atomic<T> *a, atomic_op op, T v1, T v2) {
+        constexpr auto rlx = std::memory_order_relaxed;
+        switch(op) {
+        case atomic_op::load: return a->load(rlx);
+        case atomic_op::store: a->store(v1, rlx); return v1;
+        case atomic_op::compare_exchange:
+          a->compare_exchange_strong(v1, v2, rlx);
+          return v1;
+        case atomic_op::add: case atomic_op::fetch_add: return a->fetch_add(v1, rlx);
+        case atomic_op::sub: case atomic_op::fetch_sub: return a->fetch_sub(v1, rlx);
+        case atomic_op::inc: case atomic_op::fetch_inc: return a->fetch_add(1, rlx);
+        case atomic_op::dec: case atomic_op::fetch_dec: return a->fetch_sub(1, rlx);
+        case atomic_op::bit_and: case atomic_op::fetch_bit_and: return a->fetch_and(v1, rlx);
+        case atomic_op::bit_or: case atomic_op::fetch_bit_or: return a->fetch_or(v1, rlx);
+        case atomic_op::bit_xor: case atomic_op::fetch_bit_xor: return a->fetch_xor(v1, rlx);
+        case atomic_op::mul: case atomic_op::fetch_mul:
+          // wraps like the other arithmetic instead of overflowing
+          return update(a, [=](T x) { return T(U(x)*U(v1)); });
+        case atomic_op::min: case atomic_op::fetch_min:
+          return update(a, [=](T x) { return v1 < x ? v1 : x; });
+        case atomic_op::max: case atomic_op::fetch_max:
+          return update(a, [=](T x) { return v1 > x ? v1 : x; });
+        }
+        return T(0); // unreachable
+      }
+    };
+
+    template<typename T>
+    struct atomic_cpu<T, /*integral=*/false> {
+      template<typename Fn>
+      static T update(std::atomic<T> *a, Fn fn) {
+        T old = a->load(std::memory_order_relaxed);
+        while(!a->compare_exchange_weak(old, fn(old), std::memory_order_relaxed))
+          {}
+        return old;
+      }
+
+      // bitwise ops are rejected for floating types by the domain constructor
+      static T apply(std::atomic<T> *a, atomic_op op, T v1, T v2) {
+        constexpr auto rlx = std::memory_order_relaxed;
+        switch(op) {
+        case atomic_op::load: return a->load(rlx);
+        case atomic_op::store: a->store(v1, rlx); return v1;
+        case atomic_op::compare_exchange:
+          a->compare_exchange_strong(v1, v2, rlx);
+          return v1;
+        case atomic_op::add: case atomic_op::fetch_add:
+          return update(a, [=](T x) { return x + v1; });
+        case atomic_op::sub: case atomic_op::fetch_sub:
+          return update(a, [=](T x) { return x - v1; });
+        case atomic_op::inc: case atomic_op::fetch_inc:
+          return update(a, [=](T x) { return x + T(1); });
+        case atomic_op::dec: case atomic_op::fetch_dec:
+          return update(a, [=](T x) { return x - T(1); });
+        case atomic_op::mul: case atomic_op::fetch_mul:
+          return update(a, [=](T x) { return x*v1; });
+        case atomic_op::min: case atomic_op::fetch_min:
+          return update(a, [=](T x) { return v1 < x ? v1 : x; });
+        case atomic_op::max: case atomic_op::fetch_max:
+          return update(a, [=](T x) { return v1 > x ? v1 : x; });
+        default: break;
+        }
+        return T(0); // unreachable
+      }
+    };
+
+    template<typename T>
+    inline T atomic_cpu_apply(void *p, atomic_op op, T v1, T v2, std::memory_order order) {
+      static_assert(sizeof(std::atomic<T>) == sizeof(T), "std::atomic<T> is not layout compatible with T");
+
+      if(order == std::memory_order_release || order == std::memory_order_acq_rel)
+        std::atomic_thread_fence(std::memory_order_release);
+
+      T ans = atomic_cpu<T>::apply(reinterpret_cast<std::atomic<T>*>(p), op, v1, v2);
+
+      if(order == std::memory_order_acquire || order == std::memory_order_acq_rel)
+        std::atomic_thread_fence(std::memory_order_acquire);
+      return ans;
+    }
+
     // 6 combinations explicitly instantiated in atomic.cpp TU:
     // {size=4,8} X {bit_flavor=0,1,2}
     template<std::size_t size, int bit_flavor>
@@ -102,12 +213,24 @@ namespace upcxx {
       //   a constructed but empty domain which was not registered with gasnet 
       //  (hence ad_gex_handle was not produced by gasnet). 
       // atomic_gex_ops != 0, ad_gex_handle != 0 : 
-      //   a live domain constructed by gasnet.
+      //   a live domain constructed by gasnet, or by us if cpu_atomics
+      //   (then ad_gex_handle == 1).
 
       // The or'd values for the atomic operations.
       gex_OP_t atomic_gex_ops = 0;
       // The opaque gasnet atomic domain handle.
       std::uintptr_t ad_gex_handle = 0;
+      // Every member of the team shares our node, so all operations are
+      // done with CPU atomics on the downcast pointer and gasnet is not
+      // involved. Since no rank reaches the memory through gasnet (and so
+      // possibly a NIC), CPU atomics are coherent with everything else
+      // done through this domain.
+      bool cpu_atomics = false;
+      // Registry id under which each member finds its own ad_gex_handle
+      // when a peer's bulk batch arrives, so the batch can be applied
+      // through the target's domain. Only registered if gasnet is used.
+      digest bulk_id;
+      bool bulk_registered = false;
 
       const team *parent_tm_;
       
@@ -121,6 +244,20 @@ namespace upcxx {
       ~atomic_domain_untyped();
 
       void destroy(entry_barrier eb);
+
+      // Applies `opcode` to each gptrs[i] with operand vals[i] (ignored if
+      // the op takes none). Fetched values are written to results[i] when
+      // results is not null. Defined in atomic.cpp.
+      future<> bulk(atomic_op opcode, global_ptr<proxy_type> const *gptrs,
+                    proxy_type const *vals, proxy_type *results, std::size_t n,
+                    std::memory_order order) const;
+
+      // Issues n operations on `jobrank` in one gasnet NBI access region and
+      // returns its event.
+      static gex_Event_t inject_bulk(std::uintptr_t ad, proxy_type *results,
+        intrank_t jobrank, void *const *raws, atomic_op opcode,
+        proxy_type const *vals, std::size_t n, gex_Flags_t flags
+      );
     };
 
   } // namespace detail 
@@ -211,6 +348,21 @@ namespace upcxx {
         // we only have local completion, not remote
         using cxs_here_t = detail::completions_state<detail::event_is_here,
             fetch_aop_event_values, Cxs>;
+
+        if(this->cpu_atomics) {
+          UPCXX_ASSERT(backend::rank_is_local(gptr.rank_),
+                       "Global pointer for a CPU atomic_domain must reference shared memory on this node");
+          cxs_here_t state(std::move(cxs));
+          auto returner = detail::completions_returner<detail::event_is_here,
+              fetch_aop_event_values, Cxs>{state};
+
+          T result = static_cast<T>(detail::atomic_cpu_apply<proxy_type>(
+            backend::localize_memory_nonnull(gptr.rank_, reinterpret_cast<std::uintptr_t>(gptr.raw_ptr_)),
+            aop, static_cast<proxy_type>(val1), static_cast<proxy_type>(val2), order
+          ));
+          state.template operator()<operation_cx_event>(std::move(result));
+          return returner();
+        }
         
         // Create the callback object
         auto *cb = new fetch_op_cb<cxs_here_t>{cxs_here_t{std::move(cxs)}};
@@ -261,6 +413,17 @@ namespace upcxx {
         
         auto returner = detail::completions_returner<detail::event_is_here,
             nofetch_aop_event_values, Cxs>{cb.state_here};
+
+        if(this->cpu_atomics) {
+          UPCXX_ASSERT(backend::rank_is_local(gptr.rank_),
+                       "Global pointer for a CPU atomic_domain must reference shared memory on this node");
+          detail::atomic_cpu_apply<proxy_type>(
+            backend::localize_memory_nonnull(gptr.rank_, reinterpret_cast<std::uintptr_t>(gptr.raw_ptr_)),
+            aop, static_cast<proxy_type>(val1), static_cast<proxy_type>(val2), order
+          );
+          cb.state_here.template operator()<operation_cx_event>();
+          return returner();
+        }
         
         // execute the backend gasnet function
         gex_Event_t h = this->inject( this->ad_gex_handle,
@@ -294,10 +457,14 @@ namespace upcxx {
         this->ad_gex_handle = that.ad_gex_handle;
         this->atomic_gex_ops = that.atomic_gex_ops;
         this->parent_tm_ = that.parent_tm_;
+        this->cpu_atomics = that.cpu_atomics;
+        this->bulk_id = that.bulk_id;
+        this->bulk_registered = that.bulk_registered;
         // revert `that` to non-constructed state
         that.atomic_gex_ops = 0;
         that.ad_gex_handle = 0;
         that.parent_tm_ = nullptr;
+        that.bulk_registered = false;
       }
 
       #if 0 // disabling move-assignment, for now
@@ -317,6 +484,10 @@ namespace upcxx {
       #endif
       
       // The constructor takes a vector of operations. Currently, flags is currently unsupported.
+      // A team from team::create() or team::split_async() has no gasnet team
+      // to create an atomic domain over, so `tm` may only be one of those if
+      // all its members share a node and UPCXX_CPU_ATOMICS is on. Otherwise
+      // construction aborts.
       atomic_domain(std::vector<atomic_op> const &ops, const team &tm = upcxx::world()) :
         detail::atomic_domain_untyped<sizeof(T), detail::bit_flavor<T>()>(ops, tm) {}
       
@@ -325,6 +496,99 @@ namespace upcxx {
       }
 
       ~atomic_domain() {}
+
+      // Bulk operations: apply `aop` to gptrs[i] with operand vals[i], for i
+      // in [0, n). Targets in our local_team() are all issued in one gasnet
+      // access region. The others are grouped by rank, and each such rank
+      // receives one rpc that applies its share there. For
+      // `add` and `sub` without fetching, operands for the same address are
+      // combined first. The operations are unordered with respect to each
+      // other. `vals` may be null for ops without an operand (inc, dec,
+      // load). compare_exchange is not supported. The fetching form writes
+      // results[i], which must stay valid until the future is ready.
+      // Must be called with the master persona.
+      future<> op_bulk(atomic_op aop, global_ptr<T> const *gptrs, T const *vals,
+                       std::size_t n, std::memory_order order) const {
+        UPCXX_ASSERT(!detail::atomic_op_fetches(aop),
+          "op_bulk needs a non-fetching operation, got '" << detail::atomic_op_str(aop) << "'");
+        return bulk_(aop, gptrs, vals, nullptr, n, order);
+      }
+      future<> fetch_op_bulk(atomic_op aop, global_ptr<T> const *gptrs, T const *vals,
+                             T *results, std::size_t n, std::memory_order order) const {
+        UPCXX_ASSERT(detail::atomic_op_fetches(aop),
+          "fetch_op_bulk needs a fetching operation, got '" << detail::atomic_op_str(aop) << "'");
+        return bulk_(aop, gptrs, vals, results, n, order);
+      }
+
+      future<> add_bulk(global_ptr<T> const *gptrs, T const *vals, std::size_t n,
+                        std::memory_order order) const {
+        return op_bulk(atomic_op::add, gptrs, vals, n, order);
+      }
+      future<> fetch_add_bulk(global_ptr<T> const *gptrs, T const *vals, T *results,
+                              std::size_t n, std::memory_order order) const {
+        return fetch_op_bulk(atomic_op::fetch_add, gptrs, vals, results, n, order);
+      }
+      future<> inc_bulk(global_ptr<T> const *gptrs, std::size_t n,
+                        std::memory_order order) const {
+        return op_bulk(atomic_op::inc, gptrs, nullptr, n, order);
+      }
+
+    private:
+      future<> bulk_(atomic_op aop, global_ptr<T> const *gptrs, T const *vals,
+                     T *results, std::size_t n, std::memory_order order) const {
+        UPCXX_ASSERT(this->atomic_gex_ops || this->ad_gex_handle, "Atomic domain is not constructed");
+        UPCXX_ASSERT(aop != atomic_op::compare_exchange, "compare_exchange has no bulk form");
+        UPCXX_ASSERT(static_cast<gex_OP_t>(aop) & this->atomic_gex_ops,
+              "Atomic operation '" << detail::atomic_op_str(aop) << "'"
+              " not in domain's operation set '" << 
+              detail::opset_to_string(this->atomic_gex_ops) << "'\n");
+
+        #if UPCXX_ASSERT_ENABLED
+          for(std::size_t i=0; i < n; i++) {
+            UPCXX_GPTR_CHK(gptrs[i]);
+            UPCXX_ASSERT(gptrs[i] != nullptr, "Global pointer for atomic operation is null");
+            UPCXX_ASSERT(this->parent_tm_->from_world(gptrs[i].rank_,-1) >= 0,
+                         "Global pointer must reference a member of the team used to construct atomic_domain");
+            UPCXX_ASSERT(!this->cpu_atomics || backend::rank_is_local(gptrs[i].rank_),
+                         "Global pointer for a CPU atomic_domain must reference shared memory on this node");
+          }
+        #endif
+
+        std::vector<global_ptr<proxy_type>> gps(n);
+        for(std::size_t i=0; i < n; i++)
+          gps[i] = reinterpret_pointer_cast<proxy_type>(gptrs[i]);
+
+        return bulk_convert_(aop, gps.data(), vals, results, n, order,
+                             std::is_same<T, proxy_type>());
+      }
+
+      future<> bulk_convert_(atomic_op aop, global_ptr<proxy_type> const *gps,
+                             T const *vals, T *results, std::size_t n,
+                             std::memory_order order, std::true_type/*T is proxy_type*/) const {
+        return this->bulk(aop, gps, vals, results, n, order);
+      }
+      future<> bulk_convert_(atomic_op aop, global_ptr<proxy_type> const *gps,
+                             T const *vals, T *results, std::size_t n,
+                             std::memory_order order, std::false_type/*T is proxy_type*/) const {
+        std::vector<proxy_type> pvals;
+        if(vals) {
+          pvals.resize(n);
+          for(std::size_t i=0; i < n; i++)
+            pvals[i] = static_cast<proxy_type>(vals[i]);
+        }
+
+        if(results == nullptr)
+          return this->bulk(aop, gps, vals ? pvals.data() : nullptr, nullptr, n, order);
+
+        std::shared_ptr<std::vector<proxy_type>> got = std::make_shared<std::vector<proxy_type>>(n);
+        return this->bulk(aop, gps, vals ? pvals.data() : nullptr, got->data(), n, order)
+          .then([=]() {
+            for(std::size_t i=0; i < n; i++)
+              results[i] = static_cast<T>((*got)[i]);
+          });
+      }
+
+    public:
       
       template<typename Cxs = FUTURE_CX>
       NOFETCH_RTYPE<Cxs> store(global_ptr<T> gptr, T val, std::memory_order order,
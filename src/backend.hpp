@@ -30,10 +30,12 @@ namespace upcxx {
   }
   
   inline void discharge() {
+    upcxx::rpc_aggregate_flush();
     while(upcxx::progress_required())
       upcxx::progress(progress_level::internal);
   }
   inline void discharge(persona_scope &ps) {
+    upcxx::rpc_aggregate_flush();
     while(upcxx::progress_required(ps))
       upcxx::progress(progress_level::internal);
   }
@@ -2,6 +2,7 @@
 #define _740290a8_56e6_4fa4_b251_ff87c02bede0
 
 #include <upcxx/diagnostic.hpp>
+#include <upcxx/object_cache.hpp>
 
 #include <cstdint>
 
@@ -18,6 +19,8 @@ namespace gasnet {
   };
   
   struct handle_cb {
+    UPCXX_OPNEW_CACHED
+    
     handle_cb *next_ = reinterpret_cast<handle_cb*>(0x1);
     std::uintptr_t handle = 0;
     
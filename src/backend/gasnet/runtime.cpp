@@ -6,18 +6,31 @@
 #include <upcxx/concurrency.hpp>
 #include <upcxx/cuda_internal.hpp>
 #include <upcxx/os_env.hpp>
+#include <upcxx/perf_counters.hpp>
 #include <upcxx/reduce.hpp>
 #include <upcxx/team.hpp>
+#include <upcxx/view.hpp>
 
 #include <algorithm>
 #include <atomic>
+#include <climits>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <iomanip>
+#include <initializer_list>
+#include <thread>
+#include <vector>
 
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+#endif
+
 namespace backend = upcxx::backend;
 namespace detail  = upcxx::detail;
 namespace gasnet  = upcxx::backend::gasnet;
@@ -100,6 +113,14 @@ unique_ptr<uintptr_t[/*local_team.size()*/]> backend::pshm_size;
 // from: upcxx/backend/gasnet/runtime.hpp
 
 size_t gasnet::am_size_rdzv_cutover;
+detail::par_atomic<size_t> gasnet::am_size_rdzv_cutover_local;
+detail::par_atomic<size_t> gasnet::am_size_rdzv_cutover_remote;
+bool gasnet::am_size_rdzv_cutover_per_peer = false;
+bool gasnet::cpu_atomics_enabled = true;
+bool gasnet::bulk_atomics_local = true;
+bool gasnet::hier_barrier_enabled = false;
+size_t gasnet::alltoall_bruck_max = 256;
+size_t gasnet::alltoall_eager_max = 8192;
 
 sheap_footprint_t gasnet::sheap_footprint_rdzv;
 sheap_footprint_t gasnet::sheap_footprint_misc;
@@ -128,7 +149,280 @@ namespace {
   #endif
 
   bool oversubscribed;
+
+  // Optional runtime-owned thread polling for internal progress
+  // (UPCXX_PROGRESS_THREAD), PAR only.
+  bool progress_thread_enabled = false;
+  int progress_thread_cpu; // -1 = unpinned
+  void progress_thread_start();
+  void progress_thread_stop();
+  
+  int progress_pass(progress_level level);
+  
+  // Idle policy of future::wait() (UPCXX_WAIT_POLICY): keep spinning, or after
+  // `wait_spin_n` fruitless passes start yielding, and after `wait_yield_n`
+  // more block for at most `wait_block_ns` at a time.
+  enum class wait_policy_kind { spin, yield, block };
+  wait_policy_kind wait_policy = wait_policy_kind::spin;
+  int wait_spin_n;
+  int wait_yield_n;
+  int64_t wait_block_ns;
+  
+  // Blocked waiters announce themselves here. Our own word sits in the last
+  // cache line of our segment so that local_team peers can find it (at the
+  // same offset in theirs) and wake us after sending us an AM.
+  struct alignas(64) wait_word {
+    std::atomic<uint32_t> seq; // futex word, bumped by every wake
+    std::atomic<uint32_t> sleepers;
+  };
+  constexpr size_t wait_word_reserve = sizeof(wait_word);
+  
+  wait_word wait_word_private; // until the segment exists, or if it can't host ours
+  wait_word *wait_word_me = &wait_word_private;
+  
+  bool wait_wake_peers = false; // some local peer may block, so senders must check
+  
+  // Eager rpc's between local_team peers travel through single-producer
+  // rings in shared memory instead of AM's (UPCXX_SHM_RING_SIZE). Each
+  // process hosts one ring per local peer, just below its wait_word. Peer
+  // `s` appends to ring `s` of the receiver under a process-local lock, and
+  // the receiver drains all its rings during progress.
+  struct shm_ring {
+    alignas(64) std::atomic<uint64_t> tail; // bytes ever appended, producer owned
+    alignas(64) std::atomic<uint64_t> head; // bytes ever consumed, consumer owned
+    // followed by `shm_ring_size` bytes of entries
+  };
+  
+  struct shm_ring_entry {
+    uint32_t cmd_size; // shm_ring_wrap: skip to the start of the ring
+    uint32_t cmd_align_and_level; // same encoding as am_eager_master's arg
+    uintptr_t per; // as passed to send_am_eager_persona, nullptr = master
+  };
+  static_assert(sizeof(shm_ring_entry) == 16, "Entries are padded to multiples of the header size.");
+  constexpr uint32_t shm_ring_wrap = ~uint32_t(0);
+  
+  size_t shm_ring_size = 0;    // entry bytes per ring, power of 2
+  size_t shm_ring_reserve = 0; // segment bytes hosting our rings, 0 = none
+  bool shm_ring_enabled = false;
+  
+  std::unique_ptr<shm_ring*[/*local_team.size()*/]> shm_ring_in;  // rings we drain, by sender
+  std::unique_ptr<shm_ring*[/*local_team.size()*/]> shm_ring_out; // our ring in each receiver
+  std::unique_ptr<detail::par_mutex[/*local_team.size()*/]> shm_ring_out_lock;
+  #if UPCXX_BACKEND_GASNET_PAR
+    std::atomic<bool> shm_ring_draining{false};
+  #endif
+  
+  bool shm_ring_try(const team &tm, intrank_t peer, progress_level level, persona *per,
+                    void *buf, size_t buf_size, size_t buf_align);
+  int shm_ring_drain();
+  
+  // Hierarchical world barrier (UPCXX_BARRIER=hier). Each process owns one
+  // block of flags just below its wait_word, where every local peer finds it
+  // whatever the ring reserve. Local peers announce arrival in their own
+  // block, and the group leader publishes the release in its block once
+  // every group has arrived.
+  struct hier_barrier_flags {
+    alignas(64) std::atomic<uint64_t> arrived;  // last barrier entered
+    alignas(64) std::atomic<uint64_t> released; // leader only: last barrier released
+  };
+  
+  size_t hier_barrier_reserve = 0; // segment bytes hosting our flags, 0 = none
+  
+  void hier_barrier_init(noise_log &noise);
+  int hier_barrier_advance();
+  
+  // Fan-outs of bcast_am_master trees rooted here.
+  int bcast_radix_net;   // UPCXX_BCAST_RADIX
+  int bcast_radix_local; // UPCXX_BCAST_LOCAL_RADIX
+  
+  void wait_wake_peer_slow(intrank_t wrank);
+  
+  inline void wait_wake_peer(intrank_t wrank) {
+    if_pf(wait_wake_peers)
+      wait_wake_peer_slow(wrank);
+  }
+  
+  void wait_wake_peer(const team &tm, intrank_t peer);
+  void wait_wake_token(gex_Token_t token);
+  
+  // Performance counters (see upcxx/perf_counters.hpp).
+  enum perf_counter_id {
+    #define UPCXX_PERF_COUNTER_ID(name, agg) pc_##name,
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_ID)
+    #undef UPCXX_PERF_COUNTER_ID
+    pc_n
+  };
+  
+  bool perf_dump_at_finalize = false; // UPCXX_PERF_COUNTERS_DUMP
+  
+  constexpr bool perf_counter_is_max[pc_n] = {
+    #define UPCXX_PERF_COUNTER_AGG(name, agg) perf_agg_is_max_##agg,
+    #define perf_agg_is_max_sum false
+    #define perf_agg_is_max_max true
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_AGG)
+    #undef perf_agg_is_max_sum
+    #undef perf_agg_is_max_max
+    #undef UPCXX_PERF_COUNTER_AGG
+  };
+  
+  const char *const perf_counter_names[pc_n] = {
+    #define UPCXX_PERF_COUNTER_NAME(name, agg) #name,
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_NAME)
+    #undef UPCXX_PERF_COUNTER_NAME
+  };
+  
+#if UPCXX_PERF_COUNTERS
+  // One per thread, written only by its thread, read by anyone. Blocks are
+  // never freed so counts from exited threads still show up in totals.
+  struct perf_counter_block {
+    perf_counter_block *next;
+    std::atomic<uint64_t> v[pc_n];
+  };
+  
+  std::mutex perf_blocks_lock;
+  perf_counter_block *perf_blocks_head = nullptr;
+  __thread perf_counter_block *perf_mine = nullptr;
+  
+  GASNETT_NEVER_INLINE(perf_block_new, perf_counter_block* perf_block_new());
+  perf_counter_block* perf_block_new() {
+    perf_counter_block *b = new perf_counter_block;
+    for(int i=0; i < pc_n; i++)
+      b->v[i].store(0, std::memory_order_relaxed);
+    
+    std::lock_guard<std::mutex> locked{perf_blocks_lock};
+    b->next = perf_blocks_head;
+    perf_blocks_head = b;
+    return b;
+  }
+  
+  inline perf_counter_block& perf_block() {
+    if_pf(perf_mine == nullptr)
+      perf_mine = perf_block_new();
+    return *perf_mine;
+  }
+  
+  // Everything below costs one untaken branch unless counters are on.
+  // Single writer, so a relaxed load+store suffices (no RMW).
+  inline void perf_add(int id, uint64_t x) {
+    if_pf(detail::perf_counters_on) {
+      std::atomic<uint64_t> &a = perf_block().v[id];
+      a.store(a.load(std::memory_order_relaxed) + x, std::memory_order_relaxed);
+    }
+  }
+  
+  inline void perf_max(int id, uint64_t x) {
+    if_pf(detail::perf_counters_on) {
+      std::atomic<uint64_t> &a = perf_block().v[id];
+      if(a.load(std::memory_order_relaxed) < x)
+        a.store(x, std::memory_order_relaxed);
+    }
+  }
+  
+  // Account one burst of `n` executions to the {bursts, execs, max} triple at `id`.
+  inline void perf_burst(int id, int n) {
+    if(n != 0) {
+      perf_add(id + 0, 1);
+      perf_add(id + 1, n);
+      perf_max(id + 2, n);
+    }
+  }
+  
+  // Account one message to the {n_local, n_remote, bytes_local, bytes_remote}
+  // quadruple at `id`.
+  inline void perf_msg(int id, bool local, size_t bytes) {
+    perf_add(id + (local ? 0 : 1), 1);
+    perf_add(id + (local ? 2 : 3), bytes);
+  }
+  
+  // The same for a message to or from world rank `wrank`, or team rank
+  // `peer` of `tm`, classifying the peer only if counting.
+  inline void perf_msg_peer(int id, intrank_t wrank, size_t bytes) {
+    if_pf(detail::perf_counters_on)
+      perf_msg(id, backend::all_ranks_definitely_local || backend::rank_is_local(wrank), bytes);
+  }
+  
+  void perf_msg_peer_slow(int id, const team &tm, intrank_t peer, size_t bytes);
+  
+  inline void perf_msg_peer(int id, const team &tm, intrank_t peer, size_t bytes) {
+    if_pf(detail::perf_counters_on)
+      perf_msg_peer_slow(id, tm, peer, bytes);
+  }
+  
+  void perf_msg_token_slow(int id, gex_Token_t token, size_t bytes);
+  
+  inline void perf_msg_token(int id, gex_Token_t token, size_t bytes) {
+    if_pf(detail::perf_counters_on)
+      perf_msg_token_slow(id, token, bytes);
+  }
+#else
+  inline void perf_add(int, uint64_t) {}
+  inline void perf_max(int, uint64_t) {}
+  inline void perf_burst(int, int) {}
+  inline void perf_msg(int, bool, size_t) {}
+  inline void perf_msg_peer(int, intrank_t, size_t) {}
+  inline void perf_msg_peer(int, const team&, intrank_t, size_t) {}
+  inline void perf_msg_token(int, gex_Token_t, size_t) {}
+#endif
+
+  // Per-destination aggregation of eager user-level AM's to the master
+  // persona (UPCXX_RPC_AGGREGATE). Each target rank with pending commands
+  // owns a buffer which is linked into the dirty list until shipped.
+  struct rpc_agg_buffer {
+    rpc_agg_buffer *prev, *next; // dirty list links
+    intrank_t rank; // world rank of destination
+    size_t size, capacity;
+    // batch bytes follow
+
+    char* bytes() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  bool rpc_agg_enabled = false;
+  size_t rpc_agg_size_max;
+  detail::par_mutex rpc_agg_lock;
+  unique_ptr<rpc_agg_buffer*[/*rank_n*/]> rpc_agg_table;
+  rpc_agg_buffer *rpc_agg_dirty_head = nullptr;
+
+  // Prefixes every command within a batch, commands are padded to a multiple
+  // of sizeof(rpc_agg_header) so headers stay aligned.
+  struct rpc_agg_header {
+    std::uint32_t cmd_size;
+    std::uint32_t cmd_align_and_level; // same encoding as am_eager_master's arg
+  };
+  detail::par_atomic<bool> rpc_agg_pending{false}; // cheap test for progress()
+
+  // Online tuning of the per peer-class rendezvous cutovers
+  // (UPCXX_RDZV_CUTOVER_ADAPT). Sampled sends near the current cutover
+  // accumulate their times to source completion here until there are enough
+  // to decide. An eager send completes when injected, a rendezvous when the
+  // target acknowledges having pulled the payload.
+  struct rdzv_tune_class {
+    double eager_ns_per_byte_sum;
+    double rdzv_ns_sum;
+    int eager_n, rdzv_n;
+  };
+  
+  // A sampled rendezvous awaiting its acknowledgement.
+  struct rdzv_tune_pending {
+    std::uint64_t ticks;
+    size_t cutover;
+    bool local;
+  };
+  
+  struct rdzv_tune_t {
+    bool enabled = false;
+    size_t size_max;
+    detail::par_mutex lock;
+    detail::par_atomic<unsigned> sample_clock{0};
+    rdzv_tune_class cls[2]; // [0]=remote, [1]=local
+    detail::par_atomic<int> pending_n{0}; // cheap test for deallocate_rdzv()
+    std::unordered_map<void*, rdzv_tune_pending> pending; // by source buffer
+  } rdzv_tune;
+  
+  void rdzv_tune_completed(void *buf);
   
+  void rpc_agg_append(intrank_t rank, progress_level level, void *buf, size_t buf_size, size_t buf_align);
+  void rpc_agg_flush_all();
+
   auto do_internal_progress = []() { upcxx::progress(progress_level::internal); };
   auto operation_cx_as_internal_future = upcxx::completions<upcxx::future_cx<upcxx::operation_cx_event, progress_level::internal>>{{}};
 
@@ -140,11 +434,12 @@ namespace {
 namespace {
   // we statically allocate the top of the AM handler space, 
   // to improve interoperability with UPCR that uses the bottom
-  #define UPCXX_NUM_AM_HANDLERS 8
+  #define UPCXX_NUM_AM_HANDLERS 9
   #define UPCXX_AM_INDEX_BASE   (256 - UPCXX_NUM_AM_HANDLERS)
   enum {
     id_am_eager_restricted = UPCXX_AM_INDEX_BASE,
     id_am_eager_master,
+    id_am_eager_master_batch,
     id_am_eager_persona,
     id_am_bcast_master_eager,
     id_am_long_master_packed_cmd,
@@ -158,6 +453,7 @@ namespace {
     
   void am_eager_restricted(gex_Token_t, void *buf, size_t buf_size, gex_AM_Arg_t buf_align);
   void am_eager_master(gex_Token_t, void *buf, size_t buf_size, gex_AM_Arg_t buf_align_and_level);
+  void am_eager_master_batch(gex_Token_t, void *buf, size_t buf_size);
   void am_eager_persona(gex_Token_t, void *buf, size_t buf_size, gex_AM_Arg_t buf_align_and_level,
                         gex_AM_Arg_t persona_ptr_lo, gex_AM_Arg_t persona_ptr_hi);
 
@@ -194,6 +490,7 @@ namespace {
   gex_AM_Entry_t am_table[] = {
     AM_ENTRY(am_eager_restricted, 1),
     AM_ENTRY(am_eager_master, 1),
+    AM_ENTRY(am_eager_master_batch, 0),
     AM_ENTRY(am_eager_persona, 3),
     AM_ENTRY(am_bcast_master_eager, 1),
     {id_am_long_master_packed_cmd, (void(*)())am_long_master_packed_cmd, GEX_FLAG_AM_LONG | GEX_FLAG_AM_REQUEST, 16, nullptr, "am_long_master_packed_cmd"},
@@ -267,6 +564,123 @@ namespace {
   void  *shared_heap_base = nullptr;
   size_t shared_heap_sz = 0;
 
+  // Bumped every time the heap is (re)created so thread caches filled from a
+  // destroyed heap are abandoned rather than recycled.
+  detail::par_atomic<unsigned> sheap_epoch{0};
+  
+  // Per-thread size-class caches of rendezvous buffers. Classes are the powers
+  // of two in [2^rdzv_pool_class_lb, 2^rdzv_pool_class_ub]. Blocks are carved
+  // from the heap (and thus counted in sheap_footprint_rdzv) at exactly their
+  // class size, so a block's class can be recovered from its usable size.
+  constexpr int rdzv_pool_class_lb = 8;
+  constexpr int rdzv_pool_class_ub = 20;
+  constexpr size_t rdzv_pool_align = 64;
+  
+  size_t rdzv_pool_max = 0; // high-water mark per thread (UPCXX_RDZV_POOL_SIZE), 0=disabled
+  
+  
+  // Totals across all thread caches, so quiesce_rdzv() can discount them.
+  detail::par_atomic<int64_t> rdzv_pool_cached_n{0};
+  detail::par_atomic<int64_t> rdzv_pool_cached_bytes{0};
+  
+  // This type is contained within `__thread` storage, so it must be:
+  //   1. trivially destructible.
+  //   2. constexpr constructible equivalent to zero-initialization.
+  struct rdzv_pool_cache {
+    unsigned epoch;
+    size_t bytes;
+    void *head[rdzv_pool_class_ub - rdzv_pool_class_lb + 1];
+  };
+  
+  __thread rdzv_pool_cache rdzv_pool_mine;
+  
+  // Hands an exiting thread's cached blocks back to where they came from.
+  // The per-thread caches above are `__thread` (no TLS init guard on their
+  // fast paths) and so can't have destructors of their own, instead the
+  // first block a thread caches arms a `thread_local` reaper. Once the
+  // reaper has run, blocks bypass the caches.
+  enum : unsigned char { cache_reaper_unarmed = 0, cache_reaper_armed, cache_reaper_gone };
+  __thread unsigned char cache_reaper_state;
+  
+  struct cache_reaper {
+    ~cache_reaper();
+  };
+  
+  // True if this thread may cache blocks.
+  inline bool cache_reaper_arm() {
+    if_pt(cache_reaper_state == cache_reaper_armed)
+      return true;
+    
+    if(cache_reaper_state == cache_reaper_unarmed) {
+      static thread_local cache_reaper reaper;
+      (void)reaper;
+      cache_reaper_state = cache_reaper_armed;
+    }
+    return cache_reaper_state == cache_reaper_armed;
+  }
+
+  // Per-thread freelists of runtime objects (upcxx/object_cache.hpp) in size
+  // classes [2^object_cache_class_lb, 2^object_cache_class_ub], prefix
+  // included. Blocks are plain malloc memory, so a thread may cache blocks
+  // allocated by any other.
+  constexpr int object_cache_class_lb = 5;
+  constexpr int object_cache_class_ub = 10;
+  constexpr int object_cache_class_n = object_cache_class_ub - object_cache_class_lb + 1;
+  constexpr std::uint32_t object_uncached = ~std::uint32_t(0);
+  
+  // Precedes every object block.
+  struct alignas(detail::object_align) object_prefix {
+    void *base; // what to free(), or the freelist link while cached
+    std::uint32_t klass; // object_uncached if not from a size class
+  };
+  
+  // Bytes per thread (UPCXX_OBJECT_CACHE_SIZE), 0=disabled. Objects are
+  // created before init too, so this starts at the default.
+  size_t object_cache_max = 256<<10;
+  
+  // This type is contained within `__thread` storage, so it must be:
+  //   1. trivially destructible.
+  //   2. constexpr constructible equivalent to zero-initialization.
+  struct object_cache {
+    size_t bytes;
+    void *head[object_cache_class_n];
+  };
+  
+  __thread object_cache object_cache_mine;
+  
+  #if UPCXX_BACKEND_GASNET_PAR
+    // Per-thread caches of small user allocations (upcxx::allocate) in size
+    // classes [2^user_cache_class_lb, 2^user_cache_class_ub]. Unlike rdzv
+    // pools, blocks move between a cache and the heap in batches so that
+    // segment_lock_ is taken once per batch. Cached blocks stay counted in
+    // sheap_footprint_user, the totals below let us report live objects.
+    constexpr int user_cache_class_lb = 4;
+    constexpr int user_cache_class_ub = 11;
+    constexpr int user_cache_class_n = user_cache_class_ub - user_cache_class_lb + 1;
+    // Class blocks are only guaranteed malloc alignment.
+    constexpr size_t user_cache_align = 16;
+    
+    size_t user_cache_max = 0; // bytes per thread (UPCXX_USER_ALLOC_CACHE_SIZE), 0=disabled
+    
+    detail::par_atomic<int64_t> user_cache_cached_n{0};
+    detail::par_atomic<int64_t> user_cache_cached_bytes{0};
+    
+    // This type is contained within `__thread` storage, so it must be:
+    //   1. trivially destructible.
+    //   2. constexpr constructible equivalent to zero-initialization.
+    struct user_alloc_cache {
+      unsigned epoch;
+      int n[user_cache_class_n];
+      void *head[user_cache_class_n];
+    };
+    
+    __thread user_alloc_cache user_cache_mine;
+  #else
+    constexpr size_t user_cache_max = 0;
+    detail::par_atomic<int64_t> user_cache_cached_n{0};
+    detail::par_atomic<int64_t> user_cache_cached_bytes{0};
+  #endif
+
   void heap_init_internal(size_t &size, noise_log &noise) {
     UPCXX_ASSERT_ALWAYS(!shared_heap_isinit);
 
@@ -308,8 +722,14 @@ namespace {
       }
     } else { // stand-alone UPC++
       upcxx_use_upc_alloc = false;
-      size = segment_size;
+      // the last cache line of the segment hosts our wait_word, our
+      // hier_barrier_flags sit just below it and our shm_ring's below those
+      size = segment_size - wait_word_reserve - shm_ring_reserve - hier_barrier_reserve;
       shared_heap_base = segment_base;
+      wait_word_me = reinterpret_cast<wait_word*>(
+        reinterpret_cast<char*>(segment_base) + segment_size - wait_word_reserve
+      );
+      detail::wait_sleepers = &wait_word_me->sleepers;
     }
     shared_heap_sz = size;
 
@@ -320,7 +740,12 @@ namespace {
       mspace_set_footprint_limit(segment_mspace_, shared_heap_sz);
     }
 
-    // zero shared heap footprint counters
+    // zero shared heap footprint counters, stale rdzv caches die with the old heap
+    sheap_epoch.fetch_add(1);
+    rdzv_pool_cached_n.store(0);
+    rdzv_pool_cached_bytes.store(0);
+    user_cache_cached_n.store(0);
+    user_cache_cached_bytes.store(0);
     gasnet::sheap_footprint_rdzv = {0,0};
     gasnet::sheap_footprint_misc = {0,0};
     gasnet::sheap_footprint_user = {0,0};    
@@ -346,6 +771,44 @@ namespace {
     }
   }
   void init_localheap_tables(void);
+  
+  // Settings every process reads from its own environment but the job must
+  // agree on, because peers act on each other's choice. One collective over
+  // world reduces each setting to its minimum and maximum; wherever those
+  // differ, rank 0 warns and every process takes the minimum. Returns
+  // whether all of them already agreed.
+  bool agree_settings(
+      std::initializer_list<std::pair<char const*, int64_t*>> settings,
+      noise_log &noise
+    ) {
+    size_t n = settings.size();
+    std::vector<int64_t> lo_neghi(2*n); // [min..., -max...]
+    size_t i = 0;
+    for(auto const &s: settings) {
+      lo_neghi[i] = *s.second;
+      lo_neghi[n + i] = -*s.second;
+      i++;
+    }
+    
+    gex_Event_Wait(gex_Coll_ReduceToAllNB(
+      world_tm, lo_neghi.data(), lo_neghi.data(), GEX_DT_I64, sizeof(int64_t), 2*n,
+      GEX_OP_MIN, nullptr, nullptr, 0
+    ));
+    
+    bool agreed = true;
+    i = 0;
+    for(auto const &s: settings) {
+      int64_t lo = lo_neghi[i], hi = -lo_neghi[n + i];
+      if(lo != hi) {
+        agreed = false;
+        if(backend::rank_me == 0)
+          noise.warn()<<s.first<<" differs between processes (from "<<lo<<" to "<<hi<<"), using "<<lo<<" everywhere.";
+      }
+      *s.second = lo;
+      i++;
+    }
+    return agreed;
+  }
 }
 
 // WARNING: This is not a documented or supported entry point, and may soon be removed!!
@@ -382,8 +845,9 @@ void upcxx::destroy_heap() {
   int ok = gasnet_barrier_wait(0, GASNET_BARRIERFLAG_ANONYMOUS);
   UPCXX_ASSERT_ALWAYS(ok == GASNET_OK);
   
-  if(gasnet::sheap_footprint_user.count != 0)
-    noise.warn()<<"destroy_heap() called with "<<gasnet::sheap_footprint_user.count<<" live shared objects.";
+  int64_t live_user = gasnet::sheap_footprint_user.count - user_cache_cached_n.load(std::memory_order_relaxed);
+  if(live_user != 0)
+    noise.warn()<<"destroy_heap() called with "<<live_user<<" live shared objects.";
 
   if (upcxx_use_upc_alloc) { 
     noise.warn()<<"destroy_heap() is not supported for UPCXX_USE_UPC_ALLOC=yes" << endl;
@@ -565,6 +1029,98 @@ void upcxx::init() {
                              1024;
   UPCXX_ASSERT(gasnet::am_size_rdzv_cutover_min <= gasnet::am_size_rdzv_cutover);
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Per peer-class cutovers and their online tuning.
+  {
+    auto cutover_env = [&](const char *name) -> size_t {
+      int64_t val = os_env(name, (int64_t)gasnet::am_size_rdzv_cutover, 1);
+      if(val < (int64_t)gasnet::am_size_rdzv_cutover_min || val > (int64_t)am_medium_size) {
+        int64_t clamped = std::max<int64_t>(gasnet::am_size_rdzv_cutover_min,
+                                            std::min<int64_t>(val, am_medium_size));
+        noise.warn() << name<<"="<<val<<" is outside the range ["
+                     << gasnet::am_size_rdzv_cutover_min<<", "<<am_medium_size<<"], using "<<clamped<<" instead.";
+        val = clamped;
+      }
+      return val;
+    };
+    
+    size_t local = cutover_env("UPCXX_RDZV_CUTOVER_LOCAL");
+    size_t remote = cutover_env("UPCXX_RDZV_CUTOVER_REMOTE");
+    gasnet::am_size_rdzv_cutover_local.store(local);
+    gasnet::am_size_rdzv_cutover_remote.store(remote);
+    
+    rdzv_tune.enabled = os_env<bool>("UPCXX_RDZV_CUTOVER_ADAPT", false);
+    rdzv_tune.size_max = am_medium_size;
+    
+    gasnet::am_size_rdzv_cutover_per_peer =
+      rdzv_tune.enabled ||
+      local != gasnet::am_size_rdzv_cutover ||
+      remote != gasnet::am_size_rdzv_cutover;
+    
+    if(backend::verbose_noise)
+      noise.line()<<"Rendezvous cutover: local_team peers "<<local
+                  <<" bytes, off-node peers "<<remote<<" bytes, adaptive "
+                  <<(rdzv_tune.enabled ? "yes" : "no");
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Per-thread cache of rendezvous buffers.
+  
+  rdzv_pool_max = std::max<int64_t>(0, os_env("UPCXX_RDZV_POOL_SIZE", 1<<20, 1<<10)); // default units = KB
+  
+  if(backend::verbose_noise)
+    noise.line()<<"Rendezvous buffer cache: "<<(rdzv_pool_max == 0
+      ? std::string("disabled")
+      : noise_log::size(rdzv_pool_max)+" per thread");
+
+  object_cache_max = std::max<int64_t>(0, os_env("UPCXX_OBJECT_CACHE_SIZE", 256<<10, 1<<10)); // default units = KB
+  
+  if(backend::verbose_noise)
+    noise.line()<<"Runtime object cache: "<<(object_cache_max == 0
+      ? std::string("disabled")
+      : noise_log::size(object_cache_max)+" per thread");
+
+  #if UPCXX_BACKEND_GASNET_PAR
+    user_cache_max = std::max<int64_t>(0, os_env("UPCXX_USER_ALLOC_CACHE_SIZE", 256<<10, 1<<10)); // default units = KB
+    
+    if(backend::verbose_noise)
+      noise.line()<<"Shared heap allocation cache: "<<(user_cache_max == 0
+        ? std::string("disabled")
+        : noise_log::size(user_cache_max)+" per thread");
+  #endif
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Per-destination aggregation of eager rpc's.
+
+  rpc_agg_enabled = os_env<bool>("UPCXX_RPC_AGGREGATE", false);
+  if(rpc_agg_enabled) {
+    size_t batch_max = gex_AM_MaxRequestMedium(
+      world_tm,
+      GEX_RANK_INVALID,
+      GEX_EVENT_NOW,
+      /*flags*/0,
+      0
+    );
+    int64_t szval = os_env("UPCXX_RPC_AGGREGATE_SIZE", std::min<int64_t>(batch_max, 8<<10), 1);
+    // a batch must always have room for at least one eager command
+    size_t size_min = sizeof(rpc_agg_header) + gasnet::am_size_rdzv_cutover;
+
+    if(szval < (int64_t)size_min || szval > (int64_t)batch_max) {
+      size_t clamped = std::max(size_min, std::min(batch_max, (size_t)std::max<int64_t>(szval, 0)));
+      noise.warn() << "UPCXX_RPC_AGGREGATE_SIZE="<<szval<<" is outside the range ["
+                   << size_min<<", "<<batch_max<<"], using "<<clamped<<" instead.";
+      szval = clamped;
+    }
+
+    // multiple of the entry padding so any command passing the size test in
+    // send_am_eager_master fits once padded
+    rpc_agg_size_max = szval & -sizeof(rpc_agg_header);
+    rpc_agg_table.reset(new rpc_agg_buffer*[backend::rank_n]());
+
+    if(backend::verbose_noise)
+      noise.line()<<"RPC aggregation: enabled, batch size "<<rpc_agg_size_max<<" bytes";
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   // Determine if we're oversubscribed.
   { 
@@ -605,6 +1161,54 @@ void upcxx::init() {
     );
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Shared-memory rpc rings, sized before the heap so they can be carved from
+  // the end of the segment.
+  
+  {
+    int64_t ring_size = os_env<int64_t>("UPCXX_SHM_RING_SIZE", 16<<10);
+    if(ring_size > 0) {
+      // round up to a power of 2 no smaller than a few AM-sized commands
+      shm_ring_size = 4096;
+      while((int64_t)shm_ring_size < ring_size)
+        shm_ring_size *= 2;
+    }
+    
+    size_t reserve = peer_n * (sizeof(shm_ring) + shm_ring_size);
+    
+    // Peers find our rings at an offset computed from their own reserve, so
+    // the ring size and whether the rings fit must agree job-wide.
+    int64_t agree[3] = {
+      (int64_t)shm_ring_size, -(int64_t)shm_ring_size,
+      shm_ring_size == 0 || reserve <= segment_size/8 ? 1 : 0
+    };
+    gex_Event_Wait(gex_Coll_ReduceToAllNB(
+      world_tm, agree, agree, GEX_DT_I64, sizeof(int64_t), 3,
+      GEX_OP_MIN, nullptr, nullptr, 0
+    ));
+    
+    if(agree[0] != -agree[1]) {
+      if(backend::rank_me == 0)
+        noise.warn()<<"UPCXX_SHM_RING_SIZE differs between processes (rounded, from "
+                    <<agree[0]<<" to "<<-agree[1]<<" bytes), rings disabled.";
+      shm_ring_size = 0;
+    }
+    else if(agree[2] == 0) {
+      if(backend::rank_me == 0)
+        noise.warn()<<"UPCXX_SHM_RING_SIZE="<<ring_size<<" would take more than 1/8 of the"
+                    <<" shared heap on some process, rings disabled.";
+      shm_ring_size = 0;
+    }
+    
+    if(shm_ring_size != 0 && peer_n > 1 && contiguous_nbhd && !upcxx_upc_is_linked())
+      shm_ring_reserve = reserve;
+    
+    // Barrier flags are reserved whatever UPCXX_BARRIER says so that every
+    // local peer finds them at the same offset.
+    if(contiguous_nbhd && !upcxx_upc_is_linked())
+      hier_barrier_reserve = sizeof(hier_barrier_flags);
+  }
+  
   // setup shared segment allocator
   heap_init_internal(segment_size, noise);
   
@@ -693,6 +1297,177 @@ void upcxx::init() {
   
   // Setup local peer address translation tables
   init_localheap_tables();
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Shared-memory rpc rings, usable once every local peer has cleared its own.
+  
+  {
+    int64_t rings_ok = shm_ring_reserve != 0 && peer_n > 1 ? 1 : 0;
+    
+    if(rings_ok) {
+      shm_ring_in.reset(new shm_ring*[peer_n]);
+      shm_ring_out.reset(new shm_ring*[peer_n]);
+      shm_ring_out_lock.reset(new detail::par_mutex[peer_n]);
+      
+      size_t stride = sizeof(shm_ring) + shm_ring_size;
+      
+      for(gex_Rank_t p=0; p < peer_n; p++) {
+        char *rings_of_p = reinterpret_cast<char*>(
+          backend::pshm_vbase[p] + backend::pshm_size[p]
+            - wait_word_reserve - hier_barrier_reserve - shm_ring_reserve
+        );
+        shm_ring_out[p] = reinterpret_cast<shm_ring*>(rings_of_p + peer_me*stride);
+        
+        if(p == peer_me) {
+          for(gex_Rank_t s=0; s < peer_n; s++) {
+            shm_ring *r = ::new(rings_of_p + s*stride) shm_ring;
+            r->tail.store(0, std::memory_order_relaxed);
+            r->head.store(0, std::memory_order_relaxed);
+            shm_ring_in[s] = r;
+          }
+        }
+      }
+    }
+    
+    gex_Event_Wait(gex_Coll_ReduceToAllNB(
+      local_tm, &rings_ok, &rings_ok, GEX_DT_I64, sizeof(int64_t), 1,
+      GEX_OP_MIN, nullptr, nullptr, 0
+    ));
+    shm_ring_enabled = rings_ok != 0;
+    
+    if(backend::verbose_noise)
+      noise.line()<<"Shared-memory rpc rings: "<<(shm_ring_enabled
+        ? noise_log::size(shm_ring_size)+" per local peer pair"
+        : std::string("disabled"));
+  }
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Hierarchical world barrier
+  
+  hier_barrier_init(noise);
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Progress thread configuration (started after the exit barrier)
+  
+  progress_thread_enabled = os_env<bool>("UPCXX_PROGRESS_THREAD", false);
+  progress_thread_cpu = -1;
+  
+  if(progress_thread_enabled) {
+    #if UPCXX_BACKEND_GASNET_SEQ
+      if(backend::rank_me == 0)
+        noise.warn()<<"UPCXX_PROGRESS_THREAD requires UPCXX_THREADMODE=par, ignoring.";
+      progress_thread_enabled = false;
+    #else
+      int64_t cpu = os_env("UPCXX_PROGRESS_THREAD_CPU", (int64_t)-1, 0);
+      if(cpu >= 0) {
+        #if defined(__linux__)
+          // consecutive local ranks get consecutive cpus
+          progress_thread_cpu = int((cpu + peer_me) % gasnett_cpu_count());
+        #else
+          if(backend::rank_me == 0)
+            noise.warn()<<"UPCXX_PROGRESS_THREAD_CPU is not supported on this platform, ignoring.";
+        #endif
+      }
+      
+      if(backend::verbose_noise) {
+        if(progress_thread_cpu >= 0)
+          noise.line()<<"Progress thread: enabled, pinned to cpu "<<progress_thread_cpu<<" on local rank "<<peer_me;
+        else
+          noise.line()<<"Progress thread: enabled, unpinned";
+      }
+    #endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Idle wait policy
+  
+  {
+    std::string policy = os_env<std::string>("UPCXX_WAIT_POLICY", std::string("spin"));
+    
+    if(policy == "spin")
+      wait_policy = wait_policy_kind::spin;
+    else if(policy == "yield")
+      wait_policy = wait_policy_kind::yield;
+    else if(policy == "block")
+      wait_policy = wait_policy_kind::block;
+    else {
+      noise.warn()<<"UPCXX_WAIT_POLICY="<<policy<<" is not one of spin, yield, block. Using spin.";
+      wait_policy = wait_policy_kind::spin;
+    }
+    
+    wait_spin_n = (int)std::max<int64_t>(0, os_env<int64_t>("UPCXX_WAIT_SPIN", 2000));
+    wait_yield_n = (int)std::max<int64_t>(0, os_env<int64_t>("UPCXX_WAIT_YIELD", 200));
+    wait_block_ns = 1000*std::max<int64_t>(1, os_env<int64_t>("UPCXX_WAIT_BLOCK_US", 1000));
+    
+    wait_word_me->seq.store(0, std::memory_order_relaxed);
+    wait_word_me->sleepers.store(0, std::memory_order_relaxed);
+    
+    // Senders only pay for checking peers' wait words if some process of our
+    // local_team may block. The policy may differ between processes.
+    int64_t any_block = wait_policy == wait_policy_kind::block ? 1 : 0;
+    gex_Event_Wait(gex_Coll_ReduceToAllNB(
+      local_tm, &any_block, &any_block, GEX_DT_I64, sizeof(int64_t), 1,
+      GEX_OP_MAX, nullptr, nullptr, 0
+    ));
+    wait_wake_peers = any_block != 0 && peer_n > 1 && !upcxx_upc_is_linked();
+    
+    if(backend::verbose_noise && wait_policy != wait_policy_kind::spin) {
+      noise.line()<<"Wait policy: "<<policy<<" (spin "<<wait_spin_n<<" passes, "
+        <<"yield "<<wait_yield_n<<" passes, block at most "<<wait_block_ns/1000<<" us)";
+    }
+  }
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // CPU atomics for atomic_domains confined to local_team. Members of a
+  // domain must all take the same path, so this is agreed job-wide.
+  
+  {
+    int64_t cpu_atomics = os_env<bool>("UPCXX_CPU_ATOMICS", true) ? 1 : 0;
+    agree_settings({{"UPCXX_CPU_ATOMICS", &cpu_atomics}}, noise);
+    gasnet::cpu_atomics_enabled = cpu_atomics != 0;
+  }
+  
+  // Ranks may differ here, a target copes with either kind of batch.
+  gasnet::bulk_atomics_local = os_env<bool>("UPCXX_BULK_ATOMICS_LOCAL", true);
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Alltoall algorithm cutovers. Each side of an exchange picks its
+  // algorithm and message kind from these, so they are agreed job-wide.
+  
+  {
+    int64_t bruck_max = std::max<int64_t>(0, os_env<int64_t>("UPCXX_ALLTOALL_BRUCK_MAX", 256));
+    int64_t eager_max = std::max<int64_t>(0, os_env<int64_t>("UPCXX_ALLTOALL_EAGER_MAX", 8192));
+    agree_settings({{"UPCXX_ALLTOALL_BRUCK_MAX", &bruck_max}, {"UPCXX_ALLTOALL_EAGER_MAX", &eager_max}}, noise);
+    gasnet::alltoall_bruck_max = (size_t)bruck_max;
+    gasnet::alltoall_eager_max = (size_t)eager_max;
+  }
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Broadcast tree fan-outs, clamped to what bcast_tree_shape can carry.
+  // Every member of a broadcast rebuilds the tree from these, so they are
+  // agreed job-wide.
+  
+  {
+    int64_t radix_net = std::min<int64_t>(0xffff, std::max<int64_t>(1, os_env<int64_t>("UPCXX_BCAST_RADIX", 8)));
+    int64_t radix_local = std::min<int64_t>(0xffff, std::max<int64_t>(1, os_env<int64_t>("UPCXX_BCAST_LOCAL_RADIX", 8)));
+    agree_settings({{"UPCXX_BCAST_RADIX", &radix_net}, {"UPCXX_BCAST_LOCAL_RADIX", &radix_local}}, noise);
+    bcast_radix_net = (int)radix_net;
+    bcast_radix_local = (int)radix_local;
+  }
+  
+  //////////////////////////////////////////////////////////////////////////////
+  // Performance counter report at finalize
+  
+  perf_dump_at_finalize = os_env<bool>("UPCXX_PERF_COUNTERS_DUMP", false);
+  bool perf_wanted = perf_dump_at_finalize || os_env<bool>("UPCXX_PERF_COUNTERS_ENABLED", false);
+  
+  #if UPCXX_PERF_COUNTERS
+    detail::perf_counters_on = perf_wanted;
+  #else
+    if(perf_wanted && backend::rank_me == 0)
+      noise.warn()<<"Performance counters requested but this library was built "
+                    "with UPCXX_PERF_COUNTERS=0, all counters will read zero.";
+  #endif
 
   noise.show();
 
@@ -712,6 +1487,9 @@ void upcxx::init() {
   gasnet_barrier_notify(0, GASNET_BARRIERFLAG_ANONYMOUS);
   ok = gasnet_barrier_wait(0, GASNET_BARRIERFLAG_ANONYMOUS);
   UPCXX_ASSERT_ALWAYS(ok == GASNET_OK);
+  
+  if(progress_thread_enabled)
+    progress_thread_start();
 }
 
 namespace {
@@ -796,7 +1574,8 @@ namespace {
     int64_t n;
 
     do {
-      n = gasnet::sheap_footprint_rdzv.count;
+      // buffers idling in rdzv pools don't count as outstanding communication
+      n = gasnet::sheap_footprint_rdzv.count - rdzv_pool_cached_n.load(std::memory_order_relaxed);
       if(iters == (in_finalize ? 1000 : 100000)) {
         if(in_finalize) {
           if(upcxx::rank_me()==0)
@@ -842,6 +1621,9 @@ void upcxx::finalize() {
     return;
   
   noise_log noise("upcxx::finalize()");
+  
+  if(progress_thread_enabled)
+    progress_thread_stop();
 
   { // barrier
     gasnet_barrier_notify(0, GASNET_BARRIERFLAG_ANONYMOUS);
@@ -851,6 +1633,11 @@ void upcxx::finalize() {
 
   quiesce_rdzv(/*in_finalize=*/true, noise);
   
+  if(rpc_agg_enabled) {
+    rpc_agg_flush_all();
+    rpc_agg_table.reset();
+  }
+  
   struct popn_stats_t {
     int64_t sum, min, max;
   };
@@ -883,7 +1670,8 @@ void upcxx::finalize() {
   }
   
   if(backend::verbose_noise) {
-    int64_t live_local = gasnet::sheap_footprint_user.count;
+    int64_t live_local = gasnet::sheap_footprint_user.count
+                       - user_cache_cached_n.load(std::memory_order_relaxed);
     
     #if 0 // local_team scratch is no longer credited as a user allocation
     if(gasnet::handle_of(detail::the_local_team.value()) !=
@@ -903,6 +1691,27 @@ void upcxx::finalize() {
     }
   }
   
+  if(perf_dump_at_finalize) {
+    // snapshot before the reductions below add traffic of their own
+    upcxx::perf_counters pc = upcxx::perf_counters_process();
+    uint64_t v[pc_n];
+    #define UPCXX_PERF_COUNTER_PUT(name, agg) v[pc_##name] = pc.name;
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_PUT)
+    #undef UPCXX_PERF_COUNTER_PUT
+    
+    std::stringstream ss;
+    ss<<"Performance counters (total / per rank min / per rank max):";
+    for(int i=0; i < pc_n; i++) {
+      popn_stats_t st = reduce_popn_to_rank0((int64_t)v[i]);
+      ss<<"\n  "<<std::left<<setw(28)<<perf_counter_names[i]<<std::right
+        <<setw(14)<<(perf_counter_is_max[i] ? st.max : st.sum)
+        <<setw(14)<<st.min<<setw(14)<<st.max;
+    }
+    
+    if(backend::rank_me == 0)
+      noise.line()<<ss.str();
+  }
+  
   { // Tear down local_team
     if(gasnet::handle_of(detail::the_local_team.value()) !=
        gasnet::handle_of(detail::the_world_team.value()))
@@ -913,6 +1722,7 @@ void upcxx::finalize() {
   }
   
   // can't just destroy world, it needs special attention
+  gasnet::bcast_tree_forget(detail::the_world_team.value());
   detail::registry.erase(detail::the_world_team.value().id().dig_);
   
   if(backend::initial_master_scope != nullptr)
@@ -930,39 +1740,211 @@ void upcxx::liberate_master_persona() {
   backend::initial_master_scope = nullptr;
 }
 
-void* upcxx::allocate(size_t size, size_t alignment) {
-  return gasnet::allocate(size, alignment, &gasnet::sheap_footprint_user);
-}
-
-void  upcxx::deallocate(void *p) {
-  gasnet::deallocate(p, &gasnet::sheap_footprint_user);
-}
-
-std::string upcxx::detail::shared_heap_stats() {
-  std::stringstream ss;
-  ss
-    <<"Local shared heap statistics:\n"
-    <<"  Shared heap size on process "<<rank_me()<<":             "
-    <<                       noise_log::size(shared_heap_sz) << '\n'
-    <<"  User allocations:      "<<setw(10)<<gasnet::sheap_footprint_user.count<<" objects, "
-    <<                       noise_log::size(gasnet::sheap_footprint_user.bytes)<<'\n'
-    <<"  Internal rdzv buffers: "<<setw(10)<<gasnet::sheap_footprint_rdzv.count<<" objects, "
-    <<                       noise_log::size(gasnet::sheap_footprint_rdzv.bytes)<<'\n'
-    <<"  Internal misc buffers: "<<setw(10)<<gasnet::sheap_footprint_misc.count<<" objects, "
-    <<                       noise_log::size(gasnet::sheap_footprint_misc.bytes)<<'\n';
-  return ss.str();
-}
+#if UPCXX_BACKEND_GASNET_PAR
+namespace {
+  inline user_alloc_cache& user_cache_of_mine() {
+    user_alloc_cache &c = user_cache_mine;
+    unsigned epoch = sheap_epoch.load(std::memory_order_relaxed);
+    
+    if_pf(c.epoch != epoch) {
+      c = user_alloc_cache{};
+      c.epoch = epoch;
+    }
+    return c;
+  }
   
-void* gasnet::allocate(size_t size, size_t alignment, sheap_footprint_t *foot) {
-  UPCXX_ASSERT(shared_heap_isinit);
-  #if UPCXX_BACKEND_GASNET_SEQ
-    UPCXX_ASSERT(backend::master.active_with_caller());
-  #endif
-
-  std::lock_guard<detail::par_mutex> locked{segment_lock_};
+  // Most blocks a class may hold idle, half of that moves per batch.
+  inline int user_cache_class_limit(int k) {
+    return std::max<int>(2, (user_cache_max/user_cache_class_n)>>k);
+  }
   
-  void *p;
-  if (upcxx_use_upc_alloc) {
+  // Return all but `keep` blocks of class `k` to the heap. Caller holds segment_lock_.
+  void user_cache_drain_locked(user_alloc_cache &c, int k, int keep) {
+    int ki = k - user_cache_class_lb;
+    int64_t freed_bytes = 0;
+    int freed_n = 0;
+    
+    while(c.n[ki] > keep) {
+      void *p = c.head[ki];
+      c.head[ki] = *reinterpret_cast<void**>(p);
+      c.n[ki] -= 1;
+      
+      size_t usable = mspace_usable_size(p);
+      gasnet::sheap_footprint_user.bytes -= usable;
+      gasnet::sheap_footprint_user.count -= 1;
+      mspace_free(segment_mspace_, p);
+      
+      freed_bytes += usable;
+      freed_n += 1;
+    }
+    
+    user_cache_cached_n.fetch_add(-freed_n, std::memory_order_relaxed);
+    user_cache_cached_bytes.fetch_add(-freed_bytes, std::memory_order_relaxed);
+  }
+  
+  void* user_cache_allocate(int k) {
+    int ki = k - user_cache_class_lb;
+    user_alloc_cache &c = user_cache_of_mine();
+    
+    if(c.head[ki] == nullptr) {
+      // refill: carve a batch of blocks under a single lock acquisition
+      int batch = std::max(1, user_cache_class_limit(k)/2);
+      int64_t got_bytes = 0;
+      int got_n = 0;
+      {
+        std::lock_guard<detail::par_mutex> locked{segment_lock_};
+        
+        for(; got_n < batch; got_n++) {
+          void *p = mspace_memalign(segment_mspace_, user_cache_align, size_t(1)<<k);
+          if(p == nullptr)
+            break;
+          
+          size_t usable = mspace_usable_size(p);
+          gasnet::sheap_footprint_user.bytes += usable;
+          gasnet::sheap_footprint_user.count += 1;
+          got_bytes += usable;
+          
+          *reinterpret_cast<void**>(p) = c.head[ki];
+          c.head[ki] = p;
+          c.n[ki] += 1;
+        }
+        
+        if(got_n == 0) {
+          // Heap exhausted: give back everything this thread is hoarding in
+          // other classes and retry once before reporting failure.
+          for(int k1 = user_cache_class_lb; k1 <= user_cache_class_ub; k1++)
+            user_cache_drain_locked(c, k1, 0);
+          
+          void *p = mspace_memalign(segment_mspace_, user_cache_align, size_t(1)<<k);
+          if_pt(p) {
+            gasnet::sheap_footprint_user.bytes += mspace_usable_size(p);
+            gasnet::sheap_footprint_user.count += 1;
+          }
+          return p;
+        }
+      }
+      
+      user_cache_cached_n.fetch_add(got_n, std::memory_order_relaxed);
+      user_cache_cached_bytes.fetch_add(got_bytes, std::memory_order_relaxed);
+    }
+    
+    void *p = c.head[ki];
+    c.head[ki] = *reinterpret_cast<void**>(p);
+    c.n[ki] -= 1;
+    
+    user_cache_cached_n.fetch_add(-1, std::memory_order_relaxed);
+    user_cache_cached_bytes.fetch_add(-int64_t(mspace_usable_size(p)), std::memory_order_relaxed);
+    return p;
+  }
+  
+  void user_cache_deallocate(void *p, size_t usable) {
+    int k = user_cache_class_lb;
+    while((size_t(2)<<k) <= usable)
+      k += 1;
+    int ki = k - user_cache_class_lb;
+    
+    user_alloc_cache &c = user_cache_of_mine();
+    
+    *reinterpret_cast<void**>(p) = c.head[ki];
+    c.head[ki] = p;
+    c.n[ki] += 1;
+    
+    user_cache_cached_n.fetch_add(1, std::memory_order_relaxed);
+    user_cache_cached_bytes.fetch_add(usable, std::memory_order_relaxed);
+    
+    int limit = user_cache_class_limit(k);
+    if(c.n[ki] > limit) {
+      std::lock_guard<detail::par_mutex> locked{segment_lock_};
+      user_cache_drain_locked(c, k, limit/2);
+    }
+  }
+  
+  void user_cache_drain_mine() {
+    user_alloc_cache &c = user_cache_mine;
+    
+    // blocks from a heap that no longer exists are abandoned
+    if(c.epoch == sheap_epoch.load(std::memory_order_relaxed) && shared_heap_isinit) {
+      std::lock_guard<detail::par_mutex> locked{segment_lock_};
+      for(int k = user_cache_class_lb; k <= user_cache_class_ub; k++)
+        user_cache_drain_locked(c, k, 0);
+    }
+    
+    c = user_alloc_cache{};
+  }
+}
+#endif
+
+void* upcxx::allocate(size_t size, size_t alignment) {
+  #if UPCXX_BACKEND_GASNET_PAR
+    if(user_cache_max != 0 && !upcxx_use_upc_alloc &&
+       alignment <= user_cache_align &&
+       size <= (size_t(1)<<user_cache_class_ub) &&
+       cache_reaper_arm()) {
+      UPCXX_ASSERT(shared_heap_isinit);
+      
+      int k = user_cache_class_lb;
+      while((size_t(1)<<k) < size)
+        k += 1;
+      
+      void *p = user_cache_allocate(k);
+      UPCXX_ASSERT(reinterpret_cast<uintptr_t>(p) % alignment == 0);
+      return p;
+    }
+  #endif
+  
+  return gasnet::allocate(size, alignment, &gasnet::sheap_footprint_user);
+}
+
+void  upcxx::deallocate(void *p) {
+  #if UPCXX_BACKEND_GASNET_PAR
+    if(user_cache_max != 0 && !upcxx_use_upc_alloc && p != nullptr &&
+       cache_reaper_arm()) {
+      UPCXX_ASSERT(shared_heap_isinit);
+      
+      // Only reads the chunk header of `p`, which we own, so no lock needed.
+      // Any block in the class range can be recycled regardless of which
+      // path allocated it since all chunks have at least malloc alignment.
+      size_t usable = mspace_usable_size(p);
+      if(usable >= (size_t(1)<<user_cache_class_lb) &&
+         usable < (size_t(2)<<user_cache_class_ub)) {
+        user_cache_deallocate(p, usable);
+        return;
+      }
+    }
+  #endif
+  
+  gasnet::deallocate(p, &gasnet::sheap_footprint_user);
+}
+
+std::string upcxx::detail::shared_heap_stats() {
+  std::stringstream ss;
+  ss
+    <<"Local shared heap statistics:\n"
+    <<"  Shared heap size on process "<<rank_me()<<":             "
+    <<                       noise_log::size(shared_heap_sz) << '\n'
+    <<"  User allocations:      "<<setw(10)<<gasnet::sheap_footprint_user.count<<" objects, "
+    <<                       noise_log::size(gasnet::sheap_footprint_user.bytes)<<'\n'
+    <<"    cached in threads:   "<<setw(10)<<user_cache_cached_n.load(std::memory_order_relaxed)<<" objects, "
+    <<                       noise_log::size(user_cache_cached_bytes.load(std::memory_order_relaxed))<<'\n'
+    <<"  Internal rdzv buffers: "<<setw(10)<<gasnet::sheap_footprint_rdzv.count<<" objects, "
+    <<                       noise_log::size(gasnet::sheap_footprint_rdzv.bytes)<<'\n'
+    <<"    cached in rdzv pools:"<<setw(10)<<rdzv_pool_cached_n.load(std::memory_order_relaxed)<<" objects, "
+    <<                       noise_log::size(rdzv_pool_cached_bytes.load(std::memory_order_relaxed))<<'\n'
+    <<"  Internal misc buffers: "<<setw(10)<<gasnet::sheap_footprint_misc.count<<" objects, "
+    <<                       noise_log::size(gasnet::sheap_footprint_misc.bytes)<<'\n';
+  return ss.str();
+}
+  
+void* gasnet::allocate(size_t size, size_t alignment, sheap_footprint_t *foot) {
+  UPCXX_ASSERT(shared_heap_isinit);
+  #if UPCXX_BACKEND_GASNET_SEQ
+    UPCXX_ASSERT(backend::master.active_with_caller());
+  #endif
+
+  std::lock_guard<detail::par_mutex> locked{segment_lock_};
+  
+  void *p;
+  if (upcxx_use_upc_alloc) {
     // must overallocate and pad to ensure alignment
     UPCXX_ASSERT(alignment < 1U<<31);
     alignment = std::max(alignment, (size_t)16);
@@ -1026,6 +2008,223 @@ void gasnet::deallocate(void *p, sheap_footprint_t *foot) {
   }
 }
 
+namespace {
+  inline int rdzv_pool_class_of(size_t size) {
+    int k = rdzv_pool_class_lb;
+    while((size_t(1)<<k) < size)
+      k += 1;
+    return k;
+  }
+  
+  inline rdzv_pool_cache& rdzv_pool_cache_mine() {
+    rdzv_pool_cache &c = rdzv_pool_mine;
+    unsigned epoch = sheap_epoch.load(std::memory_order_relaxed);
+    
+    if_pf(c.epoch != epoch) {
+      // first use by this thread, or the heap was recreated since
+      c = rdzv_pool_cache{};
+      c.epoch = epoch;
+    }
+    return c;
+  }
+}
+
+void* gasnet::allocate_rdzv(size_t size, size_t align) {
+  if(rdzv_pool_max == 0 || upcxx_use_upc_alloc)
+    return gasnet::allocate(size, align, &gasnet::sheap_footprint_rdzv);
+  
+  // Every rdzv block is over-aligned so any block returning to a cache is
+  // suitable for any request it could be handed to.
+  if(align > rdzv_pool_align || size > (size_t(1)<<rdzv_pool_class_ub))
+    return gasnet::allocate(size, std::max(align, rdzv_pool_align), &gasnet::sheap_footprint_rdzv);
+  
+  #if UPCXX_BACKEND_GASNET_SEQ
+    UPCXX_ASSERT(backend::master.active_with_caller());
+  #endif
+  
+  int k = rdzv_pool_class_of(size);
+  rdzv_pool_cache &c = rdzv_pool_cache_mine();
+  void *p = c.head[k - rdzv_pool_class_lb];
+  
+  if(p != nullptr) {
+    c.head[k - rdzv_pool_class_lb] = *reinterpret_cast<void**>(p);
+    c.bytes -= size_t(1)<<k;
+    rdzv_pool_cached_n.fetch_add(-1, std::memory_order_relaxed);
+    rdzv_pool_cached_bytes.fetch_add(-(int64_t(1)<<k), std::memory_order_relaxed);
+    return p;
+  }
+  
+  return gasnet::allocate(size_t(1)<<k, rdzv_pool_align, &gasnet::sheap_footprint_rdzv);
+}
+
+void gasnet::deallocate_rdzv(void *p) {
+  if_pf(rdzv_tune.pending_n.load(std::memory_order_relaxed) != 0)
+    rdzv_tune_completed(p);
+  
+  if(rdzv_pool_max == 0 || upcxx_use_upc_alloc || p == nullptr) {
+    gasnet::deallocate(p, &gasnet::sheap_footprint_rdzv);
+    return;
+  }
+  
+  #if UPCXX_BACKEND_GASNET_SEQ
+    UPCXX_ASSERT(backend::master.active_with_caller());
+  #endif
+  
+  // Only reads the chunk header of `p`, which we own, so no lock needed.
+  size_t usable = mspace_usable_size(p);
+  
+  if(usable < (size_t(1)<<rdzv_pool_class_lb) ||
+     usable >= (size_t(2)<<rdzv_pool_class_ub)) {
+    gasnet::deallocate(p, &gasnet::sheap_footprint_rdzv);
+    return;
+  }
+  
+  int k = rdzv_pool_class_lb;
+  while((size_t(2)<<k) <= usable)
+    k += 1;
+  
+  rdzv_pool_cache &c = rdzv_pool_cache_mine();
+  
+  if(c.bytes + (size_t(1)<<k) > rdzv_pool_max || !cache_reaper_arm()) {
+    gasnet::deallocate(p, &gasnet::sheap_footprint_rdzv);
+    return;
+  }
+  
+  *reinterpret_cast<void**>(p) = c.head[k - rdzv_pool_class_lb];
+  c.head[k - rdzv_pool_class_lb] = p;
+  c.bytes += size_t(1)<<k;
+  rdzv_pool_cached_n.fetch_add(1, std::memory_order_relaxed);
+  rdzv_pool_cached_bytes.fetch_add(int64_t(1)<<k, std::memory_order_relaxed);
+}
+
+namespace {
+  void rdzv_pool_drain_mine() {
+    rdzv_pool_cache &c = rdzv_pool_mine;
+    
+    // blocks from a heap that no longer exists are abandoned
+    if(c.epoch == sheap_epoch.load(std::memory_order_relaxed) && shared_heap_isinit) {
+      int64_t freed_n = 0, freed_bytes = 0;
+      std::lock_guard<detail::par_mutex> locked{segment_lock_};
+      
+      for(int k = rdzv_pool_class_lb; k <= rdzv_pool_class_ub; k++) {
+        void *p = c.head[k - rdzv_pool_class_lb];
+        while(p != nullptr) {
+          void *next = *reinterpret_cast<void**>(p);
+          gasnet::sheap_footprint_rdzv.bytes -= mspace_usable_size(p);
+          gasnet::sheap_footprint_rdzv.count -= 1;
+          mspace_free(segment_mspace_, p);
+          freed_n += 1;
+          freed_bytes += int64_t(1)<<k;
+          p = next;
+        }
+      }
+      
+      rdzv_pool_cached_n.fetch_add(-freed_n, std::memory_order_relaxed);
+      rdzv_pool_cached_bytes.fetch_add(-freed_bytes, std::memory_order_relaxed);
+    }
+    
+    c = rdzv_pool_cache{};
+  }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// from: upcxx/object_cache.hpp
+
+void* detail::object_alloc(size_t size) {
+  size_t need = sizeof(object_prefix) + size;
+  object_prefix *b;
+  
+  if_pt(need <= size_t(1)<<object_cache_class_ub) {
+    int k = object_cache_class_lb;
+    while((size_t(1)<<k) < need)
+      k += 1;
+    
+    object_cache &c = object_cache_mine;
+    b = static_cast<object_prefix*>(c.head[k - object_cache_class_lb]);
+    
+    if(b != nullptr) {
+      c.head[k - object_cache_class_lb] = b->base;
+      c.bytes -= size_t(1)<<k;
+      b->base = b;
+      perf_add(pc_object_cache_hits, 1);
+      return b + 1;
+    }
+    
+    b = static_cast<object_prefix*>(std::malloc(size_t(1)<<k));
+    UPCXX_ASSERT_ALWAYS(b != nullptr, "upcxx::detail::object_alloc: out of memory");
+    b->klass = k;
+  }
+  else {
+    b = static_cast<object_prefix*>(std::malloc(need));
+    UPCXX_ASSERT_ALWAYS(b != nullptr, "upcxx::detail::object_alloc: out of memory");
+    b->klass = object_uncached;
+  }
+  
+  UPCXX_ASSERT(detail::is_aligned(b, detail::object_align));
+  b->base = b;
+  return b + 1;
+}
+
+void* detail::object_alloc_aligned(size_t size, size_t align) {
+  if(align <= detail::object_align)
+    return detail::object_alloc(size);
+  
+  // the prefix goes in the padding below the aligned object
+  void *base = detail::alloc_aligned(align + size, align);
+  object_prefix *b = reinterpret_cast<object_prefix*>((char*)base + align) - 1;
+  b->base = base;
+  b->klass = object_uncached;
+  return b + 1;
+}
+
+void detail::object_free(void *p) {
+  if(p == nullptr)
+    return;
+  
+  object_prefix *b = static_cast<object_prefix*>(p) - 1;
+  
+  if_pt(b->klass != object_uncached) {
+    object_cache &c = object_cache_mine;
+    int k = b->klass;
+    
+    if(c.bytes + (size_t(1)<<k) <= object_cache_max && cache_reaper_arm()) {
+      b->base = c.head[k - object_cache_class_lb];
+      c.head[k - object_cache_class_lb] = b;
+      c.bytes += size_t(1)<<k;
+      return;
+    }
+  }
+  
+  std::free(b->base);
+}
+
+namespace {
+  void object_cache_drain_mine() {
+    object_cache &c = object_cache_mine;
+    
+    for(int k = object_cache_class_lb; k <= object_cache_class_ub; k++) {
+      void *b = c.head[k - object_cache_class_lb];
+      while(b != nullptr) {
+        void *next = static_cast<object_prefix*>(b)->base;
+        std::free(b);
+        b = next;
+      }
+    }
+    
+    c = object_cache{};
+  }
+}
+
+cache_reaper::~cache_reaper() {
+  cache_reaper_state = cache_reaper_gone;
+  rdzv_pool_drain_mine();
+  #if UPCXX_BACKEND_GASNET_PAR
+    user_cache_drain_mine();
+  #endif
+  object_cache_drain_mine();
+}
+
 //////////////////////////////////////////////////////////////////////
 // from: upcxx/backend.hpp
 
@@ -1035,18 +2234,32 @@ void backend::quiesce(const team &tm, upcxx::entry_barrier eb) {
     break;
   case entry_barrier::internal:
   case entry_barrier::user: {
+      progress_level level = eb == entry_barrier::internal
+        ? progress_level::internal
+        : progress_level::user;
+
+      if(tm.base(detail::internal_only()).via_world) {
+        struct done_cb final: gasnet::handle_cb {
+          bool done = false;
+          void execute_and_delete(gasnet::handle_cb_successor) {
+            done = true;
+          }
+        } cb;
+
+        gasnet::am_coll(tm, 0, true, true, nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, &cb);
+
+        while(!cb.done)
+          upcxx::progress(level);
+        break;
+      }
+
       // memory fencing is handled inside gex_Coll_BarrierNB + gex_Event_Test
       //std::atomic_thread_fence(std::memory_order_release);
-      
+
       gex_Event_t e = gex_Coll_BarrierNB( gasnet::handle_of(tm), 0);
-      
-      while(0 != gex_Event_Test(e)) {
-        upcxx::progress(
-          eb == entry_barrier::internal
-            ? progress_level::internal
-            : progress_level::user
-        );
-      }
+
+      while(0 != gex_Event_Test(e))
+        upcxx::progress(level);
       
       //std::atomic_thread_fence(std::memory_order_acquire);
     } break;
@@ -1113,18 +2326,15 @@ tuple<intrank_t/*rank*/, uintptr_t/*raw*/>  backend::globalize_memory(
 }
 
 intrank_t backend::team_rank_from_world(const team &tm, intrank_t rank) {
-  gex_Rank_t got = gex_TM_TranslateJobrankToRank(gasnet::handle_of(tm), rank);
-  UPCXX_ASSERT(got != GEX_RANK_INVALID);
-  return got;
+  return tm.from_world(rank);
 }
 
 intrank_t backend::team_rank_from_world(const team &tm, intrank_t rank, intrank_t otherwise) {
-  gex_Rank_t got = gex_TM_TranslateJobrankToRank(gasnet::handle_of(tm), rank);
-  return got == GEX_RANK_INVALID ? otherwise : (intrank_t)got;
+  return tm.from_world(rank, otherwise);
 }
 
 intrank_t backend::team_rank_to_world(const team &tm, intrank_t peer) {
-  return gex_TM_TranslateRankToJobrank(gasnet::handle_of(tm), peer);
+  return tm[peer];
 }
 
 void backend::validate_global_ptr(bool allow_null, intrank_t rank, void *raw_ptr, std::int32_t device,
@@ -1225,184 +2435,1250 @@ void backend::validate_global_ptr(bool allow_null, intrank_t rank, void *raw_ptr
 }
 
 ////////////////////////////////////////////////////////////////////////
-// from: upcxx/backend/gasnet/runtime.hpp
+// from: upcxx/perf_counters.hpp
 
-void gasnet::send_am_eager_restricted(
-    const team &tm,
-    intrank_t recipient,
-    void *buf,
-    std::size_t buf_size,
-    std::size_t buf_align
-  ) {
-  
-  gex_AM_RequestMedium1(
-    handle_of(tm), recipient,
-    id_am_eager_restricted, buf, buf_size,
-    GEX_EVENT_NOW, /*flags*/0,
-    buf_align
-  );
-  
-  after_gasnet();
+bool detail::perf_counters_on = false;
+
+void detail::perf_note_lpc_depth(std::int64_t depth) {
+  perf_max(pc_lpc_inbox_depth_max, depth);
 }
 
-void gasnet::send_am_eager_master(
-    progress_level level,
-    const team &tm,
-    intrank_t recipient,
-    void *buf,
-    std::size_t buf_size,
-    std::size_t buf_align
-  ) {
-  
-  gex_AM_RequestMedium1(
-    handle_of(tm), recipient,
-    id_am_eager_master, buf, buf_size,
-    GEX_EVENT_NOW, /*flags*/0,
-    buf_align<<1 | (level == progress_level::user ? 1 : 0)
-  );
+#if UPCXX_PERF_COUNTERS
+namespace {
+  void perf_msg_peer_slow(int id, const team &tm, intrank_t peer, size_t bytes) {
+    perf_msg(id,
+      backend::all_ranks_definitely_local ||
+      backend::rank_is_local(backend::team_rank_to_world(tm, peer)),
+      bytes
+    );
+  }
   
-  after_gasnet();
+  void perf_msg_token_slow(int id, gex_Token_t token, size_t bytes) {
+    bool local = true;
+    if(!backend::all_ranks_definitely_local) {
+      gex_Token_Info_t info;
+      gex_Token_Info(token, &info, GEX_TI_SRCRANK);
+      local = backend::rank_is_local(info.gex_srcrank);
+    }
+    perf_msg(id, local, bytes);
+  }
 }
+#endif
 
-void gasnet::send_am_eager_persona(
-    progress_level level,
-    const team &tm,
-    intrank_t recipient_rank,
-    persona *recipient_persona,
-    void *buf,
-    std::size_t buf_size,
-    std::size_t buf_align
-  ) {
+namespace {
+  upcxx::perf_counters perf_counters_of(uint64_t const *v) {
+    upcxx::perf_counters pc;
+    #define UPCXX_PERF_COUNTER_GET(name, agg) pc.name = v[pc_##name];
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_GET)
+    #undef UPCXX_PERF_COUNTER_GET
+    return pc;
+  }
+}
 
-  gex_AM_RequestMedium3(
-    handle_of(tm), recipient_rank,
-    id_am_eager_persona, buf, buf_size,
-    GEX_EVENT_NOW, /*flags*/0,
-    buf_align<<1 | (level == progress_level::user ? 1 : 0),
-    am_arg_encode_ptr_lo(recipient_persona), am_arg_encode_ptr_hi(recipient_persona)
-  );
-  
-  after_gasnet();
+upcxx::perf_counters upcxx::perf_counters_thread() {
+  uint64_t v[pc_n] = {};
+  #if UPCXX_PERF_COUNTERS
+    if(perf_mine != nullptr) {
+      for(int i=0; i < pc_n; i++)
+        v[i] = perf_mine->v[i].load(std::memory_order_relaxed);
+    }
+  #endif
+  return perf_counters_of(v);
 }
 
-namespace {
-  template<typename Fn>
-  void rma_get(
-      void *buf_d,
-      intrank_t rank_s,
-      void const *buf_s,
-      size_t buf_size,
-      Fn fn
-    ) {
+upcxx::perf_counters upcxx::perf_counters_process() {
+  uint64_t v[pc_n] = {};
+  #if UPCXX_PERF_COUNTERS
+    std::lock_guard<std::mutex> locked{perf_blocks_lock};
     
-    UPCXX_ASSERT(!UPCXX_BACKEND_GASNET_SEQ || backend::master.active_with_caller());
+    for(perf_counter_block *b = perf_blocks_head; b != nullptr; b = b->next) {
+      for(int i=0; i < pc_n; i++) {
+        uint64_t x = b->v[i].load(std::memory_order_relaxed);
+        v[i] = perf_counter_is_max[i] ? std::max(v[i], x) : v[i] + x;
+      }
+    }
+  #endif
+  return perf_counters_of(v);
+}
 
-    auto *cb = gasnet::make_handle_cb(std::move(fn));
-    
-    gex_Event_t h = gex_RMA_GetNB(
-      gasnet::handle_of(upcxx::world()),
-      buf_d, rank_s, const_cast<void*>(buf_s), buf_size,
-      /*flags*/0
+std::ostream& upcxx::operator<<(std::ostream &o, const upcxx::perf_counters &pc) {
+  #define UPCXX_PERF_COUNTER_PRINT(name, agg) o<<"  "<<std::left<<setw(28)<<#name<<std::right<<pc.name<<'\n';
+  UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_PRINT)
+  #undef UPCXX_PERF_COUNTER_PRINT
+  return o;
+}
+
+////////////////////////////////////////////////////////////////////////
+// rendezvous cutover selection and tuning
+
+void gasnet::rdzv_cutover_probe::begin_slow(const team &tm, intrank_t recipient) {
+  local = backend::all_ranks_definitely_local ||
+          backend::rank_is_local(backend::team_rank_to_world(tm, recipient));
+  
+  cutover = (local ? am_size_rdzv_cutover_local : am_size_rdzv_cutover_remote)
+            .load(std::memory_order_relaxed);
+  
+  // Time one in every 16 sends, enough to track changes in load without
+  // putting a clock read on every rpc.
+  if(rdzv_tune.enabled && 0 == (rdzv_tune.sample_clock.fetch_add(1, std::memory_order_relaxed) & 15))
+    ticks = gasnett_ticks_now() | 1;
+  else
+    ticks = 0;
+}
+
+namespace {
+  // Accounts one sampled send taking `ns` to complete. Caller holds rdzv_tune.lock.
+  void rdzv_tune_sample(bool local, size_t cutover, bool is_eager, size_t cmd_size, double ns) {
+    constexpr int window = 32;
+    
+    detail::par_atomic<size_t> &cutover_cls = local ? gasnet::am_size_rdzv_cutover_local : gasnet::am_size_rdzv_cutover_remote;
+    rdzv_tune_class &c = rdzv_tune.cls[local ? 1 : 0];
+    
+    if(cutover != cutover_cls.load(std::memory_order_relaxed))
+      return; // cutover moved while we were sending, sample is stale
+    
+    if(is_eager) {
+      c.eager_ns_per_byte_sum += ns/std::max<size_t>(cmd_size, 1);
+      c.eager_n += 1;
+    }
+    else {
+      c.rdzv_ns_sum += ns;
+      c.rdzv_n += 1;
+    }
+    
+    if(c.eager_n < window || c.rdzv_n < window)
+      return;
+    
+    // Compare the completion time of an eager send of exactly `cutover`
+    // bytes (extrapolated from its per-byte cost) against the mean for a
+    // rendezvous just above it, and move the cutover by a factor of two
+    // towards whichever is cheaper. The 25% dead band avoids oscillation.
+    double eager_at_cutover = cutover*c.eager_ns_per_byte_sum/c.eager_n;
+    double rdzv_at_cutover = c.rdzv_ns_sum/c.rdzv_n;
+    size_t next = cutover;
+    
+    if(eager_at_cutover*1.25 < rdzv_at_cutover)
+      next = std::min(2*cutover, rdzv_tune.size_max);
+    else if(eager_at_cutover > 1.25*rdzv_at_cutover)
+      next = std::max(cutover/2, gasnet::am_size_rdzv_cutover_min);
+    
+    cutover_cls.store(next, std::memory_order_relaxed);
+    c = rdzv_tune_class{};
+  }
+  
+  void rdzv_tune_completed(void *buf) {
+    std::uint64_t now = gasnett_ticks_now();
+    
+    std::lock_guard<detail::par_mutex> locked{rdzv_tune.lock};
+    auto it = rdzv_tune.pending.find(buf);
+    if(it == rdzv_tune.pending.end())
+      return;
+    
+    rdzv_tune_pending sample = it->second;
+    rdzv_tune.pending.erase(it);
+    rdzv_tune.pending_n.fetch_add(-1, std::memory_order_relaxed);
+    
+    rdzv_tune_sample(sample.local, sample.cutover, /*is_eager=*/false, /*cmd_size=*/0,
+                     gasnett_ticks_to_ns(now - sample.ticks));
+  }
+}
+
+void gasnet::rdzv_cutover_probe::sending_rdzv_slow(size_t cmd_size, void *buffer) {
+  // Only sends within a factor of two of the cutover say anything useful
+  // about where it should be.
+  if(cmd_size > 2*cutover)
+    return;
+  
+  std::lock_guard<detail::par_mutex> locked{rdzv_tune.lock};
+  if(rdzv_tune.pending.emplace(buffer, rdzv_tune_pending{ticks, cutover, local}).second)
+    rdzv_tune.pending_n.fetch_add(1, std::memory_order_relaxed);
+}
+
+void gasnet::rdzv_cutover_probe::finish_eager_slow(size_t cmd_size) {
+  double ns = gasnett_ticks_to_ns(gasnett_ticks_now() - ticks);
+  
+  if(2*cmd_size <= cutover)
+    return;
+  
+  std::lock_guard<detail::par_mutex> locked{rdzv_tune.lock};
+  rdzv_tune_sample(local, cutover, /*is_eager=*/true, cmd_size, ns);
+}
+
+size_t upcxx::detail::rdzv_cutover(bool local_peers) {
+  UPCXX_ASSERT(backend::init_count > 0);
+  
+  if(!gasnet::am_size_rdzv_cutover_per_peer)
+    return gasnet::am_size_rdzv_cutover;
+  
+  return (local_peers ? gasnet::am_size_rdzv_cutover_local : gasnet::am_size_rdzv_cutover_remote)
+         .load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////
+// rpc aggregation
+
+namespace {
+  void rpc_agg_unlink(rpc_agg_buffer *b) {
+    if(b->prev) b->prev->next = b->next;
+    else rpc_agg_dirty_head = b->next;
+    if(b->next) b->next->prev = b->prev;
+    
+    rpc_agg_table[b->rank] = nullptr;
+    rpc_agg_pending.store(rpc_agg_dirty_head != nullptr, std::memory_order_relaxed);
+  }
+  
+  void rpc_agg_ship(rpc_agg_buffer *b) {
+    gex_AM_RequestMedium0(
+      world_tm, b->rank,
+      id_am_eager_master_batch, b->bytes(), b->size,
+      GEX_EVENT_NOW, /*flags*/0
+    );
+    wait_wake_peer(b->rank);
+    std::free(b);
+  }
+  
+  void rpc_agg_append(
+      intrank_t rank, progress_level level,
+      void *buf, size_t buf_size, size_t buf_align
+    ) {
+    
+    UPCXX_ASSERT(buf_size <= 0xffffffffu && buf_align <= 0x7fffffffu);
+    
+    size_t entry_size = sizeof(rpc_agg_header) + buf_size;
+    entry_size = (entry_size + sizeof(rpc_agg_header)-1) & -sizeof(rpc_agg_header);
+    UPCXX_ASSERT(entry_size <= rpc_agg_size_max);
+    
+    rpc_agg_buffer *full = nullptr;
+    {
+      std::lock_guard<detail::par_mutex> locked{rpc_agg_lock};
+      
+      rpc_agg_buffer *b = rpc_agg_table[rank];
+      
+      if(b != nullptr && b->size + entry_size > rpc_agg_size_max) {
+        // no room: detach this batch and ship it once we drop the lock
+        rpc_agg_unlink(b);
+        full = b;
+        b = nullptr;
+      }
+      
+      if(b == nullptr) {
+        // Batches start small and grow geometrically up to the maximum so
+        // that sparse communication patterns don't reserve `rpc_agg_size_max`
+        // bytes per destination.
+        size_t cap = std::min<size_t>(rpc_agg_size_max, std::max<size_t>(entry_size, 512));
+        b = (rpc_agg_buffer*)std::malloc(sizeof(rpc_agg_buffer) + cap);
+        UPCXX_ASSERT_ALWAYS(b != nullptr);
+        b->rank = rank;
+        b->size = 0;
+        b->capacity = cap;
+        b->prev = nullptr;
+        b->next = rpc_agg_dirty_head;
+        if(b->next) b->next->prev = b;
+        rpc_agg_dirty_head = b;
+        rpc_agg_table[rank] = b;
+        rpc_agg_pending.store(true, std::memory_order_relaxed);
+      }
+      else if(b->size + entry_size > b->capacity) {
+        size_t cap = std::min<size_t>(rpc_agg_size_max, std::max<size_t>(2*b->capacity, b->size + entry_size));
+        rpc_agg_buffer *b1 = (rpc_agg_buffer*)std::realloc(b, sizeof(rpc_agg_buffer) + cap);
+        UPCXX_ASSERT_ALWAYS(b1 != nullptr);
+        b1->capacity = cap;
+        if(b1 != b) {
+          if(b1->prev) b1->prev->next = b1;
+          else rpc_agg_dirty_head = b1;
+          if(b1->next) b1->next->prev = b1;
+          rpc_agg_table[rank] = b1;
+          b = b1;
+        }
+      }
+      
+      rpc_agg_header *hdr = reinterpret_cast<rpc_agg_header*>(b->bytes() + b->size);
+      hdr->cmd_size = buf_size;
+      hdr->cmd_align_and_level = buf_align<<1 | (level == progress_level::user ? 1 : 0);
+      std::memcpy((void**)(hdr + 1), (void**)buf, buf_size);
+      b->size += entry_size;
+    }
+    
+    if(full != nullptr)
+      rpc_agg_ship(full);
+  }
+  
+  void rpc_agg_flush_all() {
+    rpc_agg_buffer *b;
+    {
+      std::lock_guard<detail::par_mutex> locked{rpc_agg_lock};
+      b = rpc_agg_dirty_head;
+      rpc_agg_dirty_head = nullptr;
+      rpc_agg_pending.store(false, std::memory_order_relaxed);
+      
+      for(rpc_agg_buffer *b1 = b; b1 != nullptr; b1 = b1->next)
+        rpc_agg_table[b1->rank] = nullptr;
+    }
+    
+    while(b != nullptr) {
+      rpc_agg_buffer *next = b->next;
+      rpc_agg_ship(b);
+      b = next;
+    }
+  }
+}
+
+void upcxx::rpc_aggregate_flush() {
+  UPCXX_ASSERT(backend::init_count > 0);
+  
+  if(!rpc_agg_pending.load(std::memory_order_relaxed))
+    return;
+  
+  if(!UPCXX_BACKEND_GASNET_SEQ || gasnet_seq_thread_id == detail::thread_id()) {
+    rpc_agg_flush_all();
+    gasnet::after_gasnet();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// shared-memory rpc rings
+
+namespace {
+  // Returns false if the command did not fit, in which case the caller
+  // sends it as an AM instead.
+  bool shm_ring_send(
+      intrank_t wrank, progress_level level, persona *per,
+      void *buf, size_t buf_size, size_t buf_align
+    ) {
+    
+    UPCXX_ASSERT(buf_size < shm_ring_wrap && buf_align <= 0x7fffffffu);
+    
+    size_t entry_size = sizeof(shm_ring_entry) + buf_size;
+    entry_size = (entry_size + sizeof(shm_ring_entry)-1) & -sizeof(shm_ring_entry);
+    
+    // leave room for other senders' traffic to keep flowing
+    if(entry_size > shm_ring_size/4)
+      return false;
+    
+    intrank_t p = wrank - backend::pshm_peer_lb;
+    shm_ring *r = shm_ring_out[p];
+    char *data = reinterpret_cast<char*>(r + 1);
+    
+    {
+      std::lock_guard<detail::par_mutex> locked{shm_ring_out_lock[p]};
+      
+      uint64_t tail = r->tail.load(std::memory_order_relaxed);
+      uint64_t head = r->head.load(std::memory_order_acquire);
+      
+      // entries never straddle the end of the ring
+      size_t off = tail & (shm_ring_size-1);
+      size_t pad = shm_ring_size - off < entry_size ? shm_ring_size - off : 0;
+      
+      if(tail + pad + entry_size - head > shm_ring_size) {
+        perf_add(pc_shm_ring_full, 1);
+        return false;
+      }
+      
+      if(pad != 0) {
+        reinterpret_cast<shm_ring_entry*>(data + off)->cmd_size = shm_ring_wrap;
+        tail += pad;
+        off = 0;
+      }
+      
+      shm_ring_entry *e = reinterpret_cast<shm_ring_entry*>(data + off);
+      e->cmd_size = buf_size;
+      e->cmd_align_and_level = buf_align<<1 | (level == progress_level::user ? 1 : 0);
+      e->per = reinterpret_cast<uintptr_t>(per);
+      std::memcpy((void**)(e + 1), (void**)buf, buf_size);
+      
+      r->tail.store(tail + entry_size, std::memory_order_release);
+    }
+    
+    perf_add(pc_shm_ring_sends, 1);
+    wait_wake_peer(wrank);
+    return true;
+  }
+  
+  // shm_ring_send() if `peer` of `tm` is another process of our local_team.
+  bool shm_ring_try(
+      const team &tm, intrank_t peer, progress_level level, persona *per,
+      void *buf, size_t buf_size, size_t buf_align
+    ) {
+    intrank_t wrank = backend::team_rank_to_world(tm, peer);
+    
+    return backend::rank_is_local(wrank) && wrank != backend::rank_me &&
+           shm_ring_send(wrank, level, per, buf, buf_size, buf_align);
+  }
+  
+  // Moves every command waiting in our rings onto its persona's queue.
+  // Returns the number of commands moved.
+  int shm_ring_drain() {
+    #if UPCXX_BACKEND_GASNET_PAR
+      // one drainer at a time, others have nothing to gain by waiting
+      if(shm_ring_draining.load(std::memory_order_relaxed) ||
+         shm_ring_draining.exchange(true, std::memory_order_acquire))
+        return 0;
+    #endif
+    
+    detail::persona_tls &tls = detail::the_persona_tls;
+    intrank_t me = backend::rank_me - backend::pshm_peer_lb;
+    int cmd_n = 0;
+    
+    for(intrank_t s=0; s < backend::pshm_peer_n; s++) {
+      if(s == me) continue;
+      
+      shm_ring *r = shm_ring_in[s];
+      uint64_t head = r->head.load(std::memory_order_relaxed);
+      uint64_t tail = r->tail.load(std::memory_order_acquire);
+      
+      if(head == tail) continue;
+      
+      char *data = reinterpret_cast<char*>(r + 1);
+      
+      while(head != tail) {
+        size_t off = head & (shm_ring_size-1);
+        shm_ring_entry *e = reinterpret_cast<shm_ring_entry*>(data + off);
+        
+        if(e->cmd_size == shm_ring_wrap) {
+          head += shm_ring_size - off;
+          continue;
+        }
+        
+        perf_msg(pc_am_eager_recvs_local, true, e->cmd_size);
+        
+        size_t buf_align = e->cmd_align_and_level>>1;
+        bool level_user = e->cmd_align_and_level & 1;
+        
+        persona *per = reinterpret_cast<persona*>(e->per);
+        if(e->per & 0x1) // low bit used to discriminate persona** vs persona*
+          per = *reinterpret_cast<persona**>(e->per ^ 0x1);
+        per = per == nullptr ? &backend::master : per;
+        
+        rpc_as_lpc *m = rpc_as_lpc::build_eager(e + 1, e->cmd_size, buf_align);
+        
+        tls.enqueue(
+          *per,
+          level_user ? progress_level::user : progress_level::internal,
+          m,
+          /*known_active=*/std::integral_constant<bool, !UPCXX_BACKEND_GASNET_PAR>()
+        );
+        
+        size_t entry_size = sizeof(shm_ring_entry) + e->cmd_size;
+        entry_size = (entry_size + sizeof(shm_ring_entry)-1) & -sizeof(shm_ring_entry);
+        head += entry_size;
+        cmd_n += 1;
+      }
+      
+      r->head.store(head, std::memory_order_release);
+    }
+    
+    #if UPCXX_BACKEND_GASNET_PAR
+      shm_ring_draining.store(false, std::memory_order_release);
+    #endif
+    
+    return cmd_n;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// from: upcxx/backend/gasnet/runtime.hpp
+
+void gasnet::send_am_eager_restricted(
+    const team &tm,
+    intrank_t recipient,
+    void *buf,
+    std::size_t buf_size,
+    std::size_t buf_align
+  ) {
+  
+  perf_msg_peer(pc_am_eager_sends_local, tm, recipient, buf_size);
+  
+  gex_AM_RequestMedium1(
+    handle_of(tm), gex_rank_of(tm, recipient),
+    id_am_eager_restricted, buf, buf_size,
+    GEX_EVENT_NOW, /*flags*/0,
+    buf_align
+  );
+  wait_wake_peer(tm, recipient);
+  
+  after_gasnet();
+}
+
+bool gasnet::send_am_eager_master(
+    progress_level level,
+    const team &tm,
+    intrank_t recipient,
+    void *buf,
+    std::size_t buf_size,
+    std::size_t buf_align
+  ) {
+  
+  perf_msg_peer(pc_am_eager_sends_local, tm, recipient, buf_size);
+  
+  if(shm_ring_enabled && shm_ring_try(tm, recipient, level, /*master*/nullptr, buf, buf_size, buf_align)) {
+    after_gasnet();
+    return false;
+  }
+  
+  bool batched = rpc_agg_enabled && level == progress_level::user &&
+                 sizeof(rpc_agg_header) + buf_size <= rpc_agg_size_max;
+  
+  if(batched) {
+    rpc_agg_append(
+      backend::team_rank_to_world(tm, recipient), level,
+      buf, buf_size, buf_align
+    );
+  }
+  else {
+    gex_AM_RequestMedium1(
+      handle_of(tm), gex_rank_of(tm, recipient),
+      id_am_eager_master, buf, buf_size,
+      GEX_EVENT_NOW, /*flags*/0,
+      buf_align<<1 | (level == progress_level::user ? 1 : 0)
+    );
+    wait_wake_peer(tm, recipient);
+  }
+  
+  after_gasnet();
+  return batched;
+}
+
+void gasnet::send_am_eager_persona(
+    progress_level level,
+    const team &tm,
+    intrank_t recipient_rank,
+    persona *recipient_persona,
+    void *buf,
+    std::size_t buf_size,
+    std::size_t buf_align
+  ) {
+
+  perf_msg_peer(pc_am_eager_sends_local, tm, recipient_rank, buf_size);
+  
+  if(shm_ring_enabled && shm_ring_try(tm, recipient_rank, level, recipient_persona, buf, buf_size, buf_align)) {
+    after_gasnet();
+    return;
+  }
+  
+  gex_AM_RequestMedium3(
+    handle_of(tm), gex_rank_of(tm, recipient_rank),
+    id_am_eager_persona, buf, buf_size,
+    GEX_EVENT_NOW, /*flags*/0,
+    buf_align<<1 | (level == progress_level::user ? 1 : 0),
+    am_arg_encode_ptr_lo(recipient_persona), am_arg_encode_ptr_hi(recipient_persona)
+  );
+  wait_wake_peer(tm, recipient_rank);
+  
+  after_gasnet();
+}
+
+namespace {
+  template<typename Fn>
+  void rma_get(
+      void *buf_d,
+      intrank_t rank_s,
+      void const *buf_s,
+      size_t buf_size,
+      Fn fn
+    ) {
+    
+    UPCXX_ASSERT(!UPCXX_BACKEND_GASNET_SEQ || backend::master.active_with_caller());
+
+    auto *cb = gasnet::make_handle_cb(std::move(fn));
+    
+    gex_Event_t h = gex_RMA_GetNB(
+      gasnet::handle_of(upcxx::world()),
+      buf_d, rank_s, const_cast<void*>(buf_s), buf_size,
+      /*flags*/0
     );
     cb->handle = reinterpret_cast<uintptr_t>(h);
     
-    gasnet::register_cb(cb);
-    gasnet::after_gasnet();
+    gasnet::register_cb(cb);
+    gasnet::after_gasnet();
+  }
+}
+
+void gasnet::send_am_rdzv(
+    progress_level level,
+    const team &tm,
+    intrank_t rank_d,
+    persona *persona_d,
+    void *buf_s,
+    size_t cmd_size,
+    size_t cmd_align
+  ) {
+  
+  intrank_t rank_s = backend::rank_me;
+  
+  perf_msg_peer(pc_am_rdzv_sends_local, tm, rank_d, cmd_size);
+  
+  backend::send_am_persona<progress_level::internal>(
+    tm, rank_d, persona_d,
+    [=]() {
+      perf_msg_peer(pc_am_rdzv_recvs_local, rank_s, cmd_size);
+      
+      if(backend::rank_is_local(rank_s)) {
+        void *payload = backend::localize_memory_nonnull(rank_s, reinterpret_cast<std::uintptr_t>(buf_s));
+        
+        rpc_as_lpc *m = new rpc_as_lpc;
+        m->payload = payload;
+        m->the_vtbl.execute_and_delete = command<detail::lpc_base*>::get_executor(rpc_as_lpc::reader_of(m));
+        m->vtbl = &m->the_vtbl;
+        m->is_rdzv = true;
+        m->rdzv_rank_s = rank_s;
+        m->rdzv_rank_s_local = true;
+        
+        auto &tls = detail::the_persona_tls;
+        tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+      }
+      else {
+        rpc_as_lpc *m = rpc_as_lpc::build_rdzv_lz(/*use_sheap=*/false, cmd_size, cmd_align);
+        m->rdzv_rank_s = rank_s;
+        m->rdzv_rank_s_local = false;
+        
+        rma_get(
+          m->payload, rank_s, buf_s, cmd_size,
+          [=]() {
+            auto &tls = detail::the_persona_tls;
+            int rank_s = m->rdzv_rank_s;
+            
+            m->the_vtbl.execute_and_delete = command<detail::lpc_base*>::get_executor(rpc_as_lpc::reader_of(m));
+            tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+            
+            // Notify source rank it can free buffer.
+            gasnet::send_am_restricted(
+              upcxx::world(), rank_s,
+              [=]() { gasnet::deallocate_rdzv(buf_s); }
+            );
+          }
+        );
+      }
+    }
+  );
+}
+
+////////////////////////////////////////////////////////////////////////
+// bcast_am_master fan-out tree
+//
+// Team ranks are grouped by shared-memory node. Node leaders (the root on
+// its own node, the lowest team rank elsewhere) form a `radix_net`-ary tree
+// rooted at the root's node, so each payload crosses the network once per
+// node. Each leader then fans out to its node's members through a
+// `radix_local`-ary tree.
+
+namespace {
+  // Built on first bcast over a team, dropped by team::destroy().
+  struct bcast_topo {
+    int node_n;
+    std::unique_ptr<int[]> node_of; // team rank -> node index
+    std::unique_ptr<int[]> pos_of;  // team rank -> position among its node's members
+    std::unique_ptr<int[]> node_lb; // node -> offset into members, node_lb[node_n] = rank_n
+    std::unique_ptr<int[]> members; // team ranks grouped by node, ascending within each
+  };
+  
+  std::unordered_map<upcxx::digest, std::unique_ptr<bcast_topo>> bcast_topos;
+  std::unique_ptr<gex_Rank_t[]> world_supernode; // world rank -> supernode id
+  
+  bcast_topo const& bcast_topo_of(const team &tm) {
+    std::unique_ptr<bcast_topo> &topo = bcast_topos[tm.id().dig_];
+    if_pt(topo != nullptr)
+      return *topo;
+    
+    if(!world_supernode) {
+      std::unique_ptr<gasnet_nodeinfo_t[]> info{new gasnet_nodeinfo_t[backend::rank_n]};
+      int ok = gasnet_getNodeInfo(info.get(), backend::rank_n);
+      UPCXX_ASSERT_ALWAYS(ok == GASNET_OK);
+      
+      world_supernode.reset(new gex_Rank_t[backend::rank_n]);
+      for(intrank_t r=0; r < backend::rank_n; r++)
+        world_supernode[r] = info[r].supernode;
+    }
+    
+    intrank_t rank_n = tm.rank_n();
+    
+    topo.reset(new bcast_topo);
+    topo->node_of.reset(new int[rank_n]);
+    topo->pos_of.reset(new int[rank_n]);
+    topo->members.reset(new int[rank_n]);
+    
+    // nodes are numbered in order of their lowest team rank
+    std::unordered_map<gex_Rank_t, int> node_ix;
+    std::vector<int> node_size;
+    
+    for(intrank_t r=0; r < rank_n; r++) {
+      intrank_t wr = backend::team_rank_to_world(tm, r);
+      auto got = node_ix.insert({world_supernode[wr], (int)node_ix.size()});
+      if(got.second)
+        node_size.push_back(0);
+      
+      topo->node_of[r] = got.first->second;
+      topo->pos_of[r] = node_size[got.first->second]++;
+    }
+    
+    topo->node_n = (int)node_size.size();
+    topo->node_lb.reset(new int[topo->node_n + 1]);
+    topo->node_lb[0] = 0;
+    for(int nd=0; nd < topo->node_n; nd++)
+      topo->node_lb[nd+1] = topo->node_lb[nd] + node_size[nd];
+    
+    for(intrank_t r=0; r < rank_n; r++)
+      topo->members[topo->node_lb[topo->node_of[r]] + topo->pos_of[r]] = r;
+    
+    return *topo;
+  }
+  
+  // Fills in the radices of a shape fresh from bcast_am_master().
+  inline void bcast_tree_resolve(gasnet::bcast_tree_shape &shape) {
+    if(shape.radix_net == 0) {
+      shape.radix_net = bcast_radix_net;
+      shape.radix_local = bcast_radix_local;
+    }
+  }
+  
+  // Calls `fn(child_team_rank)` for each of my children, network children
+  // first since they head the longest remaining paths.
+  template<typename Fn>
+  void bcast_tree_foreach_child(const team &tm, gasnet::bcast_tree_shape shape, Fn &&fn) {
+    bcast_topo const &topo = bcast_topo_of(tm);
+    intrank_t me = tm.rank_me();
+    
+    int root_node = topo.node_of[shape.root];
+    int my_node = topo.node_of[me];
+    int my_lb = topo.node_lb[my_node];
+    int my_n = topo.node_lb[my_node + 1] - my_lb;
+    
+    // Positions within a node are rotated to put the leader at 0.
+    int lead_pos = my_node == root_node ? topo.pos_of[shape.root] : 0;
+    int64_t li = (topo.pos_of[me] - lead_pos + my_n) % my_n;
+    
+    if(li == 0) {
+      int node_n = topo.node_n;
+      int64_t vi = (my_node - root_node + node_n) % node_n;
+      
+      for(int64_t c = vi*shape.radix_net + 1; c <= vi*shape.radix_net + shape.radix_net && c < node_n; c++)
+        fn((intrank_t)topo.members[topo.node_lb[(c + root_node) % node_n]]);
+    }
+    
+    for(int64_t c = li*shape.radix_local + 1; c <= li*shape.radix_local + shape.radix_local && c < my_n; c++)
+      fn((intrank_t)topo.members[my_lb + (c + lead_pos) % my_n]);
+  }
+}
+
+void gasnet::bcast_tree_forget(const team &tm) {
+  bcast_topos.erase(tm.id().dig_);
+}
+
+gasnet::reduce_tree_links gasnet::reduce_tree_links_of(const team &tm, intrank_t root) {
+  bcast_tree_shape shape = {root, 0, 0};
+  bcast_tree_resolve(shape);
+  
+  bcast_topo const &topo = bcast_topo_of(tm);
+  intrank_t me = tm.rank_me();
+  
+  int root_node = topo.node_of[root];
+  int my_node = topo.node_of[me];
+  int my_lb = topo.node_lb[my_node];
+  int my_n = topo.node_lb[my_node + 1] - my_lb;
+  
+  // Inverts the child enumeration of bcast_tree_foreach_child().
+  int lead_pos = my_node == root_node ? topo.pos_of[root] : 0;
+  int64_t li = (topo.pos_of[me] - lead_pos + my_n) % my_n;
+  
+  reduce_tree_links links;
+  
+  if(li != 0)
+    links.parent = topo.members[my_lb + ((li-1)/shape.radix_local + lead_pos) % my_n];
+  else {
+    int node_n = topo.node_n;
+    int64_t vi = (my_node - root_node + node_n) % node_n;
+    
+    if(vi == 0)
+      links.parent = -1;
+    else {
+      int64_t pv = (vi-1)/shape.radix_net;
+      links.parent = pv == 0 ? root : topo.members[topo.node_lb[(pv + root_node) % node_n]];
+    }
+  }
+  
+  links.child_n = 0;
+  bcast_tree_foreach_child(tm, shape, [&](intrank_t) { links.child_n += 1; });
+  
+  return links;
+}
+
+////////////////////////////////////////////////////////////////////////
+// AM collectives over teams without a gex team
+//
+// A collective's AMs carry nothing but its id, so they can arrive before
+// this rank has joined it, or even built the team. What they bring waits in
+// the collective's registered state until we join.
+
+namespace {
+  struct am_coll_state {
+    bool joined = false;
+    std::vector<std::unique_ptr<char[]>> early_up; // from children before we joined
+    std::unique_ptr<char[]> early_down; // from our parent before we joined
+    
+    // Filled in when we join.
+    team_id tm_id;
+    intrank_t root, parent;
+    int awaiting; // children yet to be combined
+    bool down;
+    void *dst;
+    char *accum; // `dst`, or `accum_own` when only the root's `dst` may be written
+    std::unique_ptr<char[]> accum_own;
+    std::size_t elt_sz, elt_n;
+    std::uintptr_t ty_id, op_id;
+    void(*op_vecfn)(const void*, void*, std::size_t, const void*);
+    const void *op_data;
+    gasnet::handle_cb *cb;
+  };
+  
+  template<typename T>
+  T am_coll_bitwise(std::uintptr_t op_id, T a, T b, std::true_type/*integral*/) {
+    return op_id == GEX_OP_AND ? T(a & b) :
+           op_id == GEX_OP_OR  ? T(a | b) :
+                                 T(a ^ b);
+  }
+  template<typename T>
+  T am_coll_bitwise(std::uintptr_t, T, T b, std::false_type/*integral*/) {
+    UPCXX_ASSERT_ALWAYS(false, "bitwise reduction of a floating-point type");
+    return b;
+  }
+  
+  template<typename T>
+  void am_coll_combine_as(std::uintptr_t op_id, const void *in, void *in_out, std::size_t n) {
+    T const *a = static_cast<T const*>(in);
+    T *b = static_cast<T*>(in_out);
+    
+    for(std::size_t i=0; i < n; i++) {
+      switch(op_id) {
+      case GEX_OP_ADD:  b[i] = a[i] + b[i]; break;
+      case GEX_OP_MULT: b[i] = a[i] * b[i]; break;
+      case GEX_OP_MIN:  b[i] = a[i] < b[i] ? a[i] : b[i]; break;
+      case GEX_OP_MAX:  b[i] = a[i] < b[i] ? b[i] : a[i]; break;
+      default:
+        b[i] = am_coll_bitwise<T>(op_id, a[i], b[i], std::is_integral<T>());
+      }
+    }
+  }
+  
+  // Combines a child's partial result into our accumulator.
+  void am_coll_combine(am_coll_state *st, const char *in) {
+    std::size_t n = st->elt_n;
+    if(n == 0)
+      return;
+    
+    if(st->op_id == GEX_OP_USER) {
+      st->op_vecfn(in, st->accum, n, st->op_data);
+      return;
+    }
+    
+    switch(st->ty_id) {
+    case GEX_DT_I32: am_coll_combine_as<std::int32_t>(st->op_id, in, st->accum, n); break;
+    case GEX_DT_U32: am_coll_combine_as<std::uint32_t>(st->op_id, in, st->accum, n); break;
+    case GEX_DT_I64: am_coll_combine_as<std::int64_t>(st->op_id, in, st->accum, n); break;
+    case GEX_DT_U64: am_coll_combine_as<std::uint64_t>(st->op_id, in, st->accum, n); break;
+    case GEX_DT_FLT: am_coll_combine_as<float>(st->op_id, in, st->accum, n); break;
+    case GEX_DT_DBL: am_coll_combine_as<double>(st->op_id, in, st->accum, n); break;
+    default:
+      UPCXX_ASSERT_ALWAYS(false, "unknown reduction type " << st->ty_id);
+    }
+  }
+  
+  std::unique_ptr<char[]> am_coll_copy(upcxx::view<char> bytes) {
+    std::unique_ptr<char[]> buf{new char[bytes.size()]};
+    std::copy(bytes.begin(), bytes.end(), buf.get());
+    return buf;
+  }
+  
+  void am_coll_finish(upcxx::digest id, am_coll_state *st) {
+    detail::registry.erase(id);
+    
+    gasnet::handle_cb *cb = st->cb;
+    delete st;
+    
+    // Completions target the master persona, which is active (the caller
+    // asserted so, or we are in its progress).
+    cb->handle = reinterpret_cast<std::uintptr_t>(GEX_EVENT_INVALID);
+    detail::persona_scope_redundant master_on_top(backend::master, detail::the_persona_tls);
+    gasnet::register_cb(cb);
+  }
+  
+  void am_coll_arrive_down(upcxx::digest id, am_coll_state *st, const char *bytes);
+  
+  // Sends our `dst` to our children in the tree.
+  void am_coll_send_down(upcxx::digest id, am_coll_state *st) {
+    const team &tm = st->tm_id.here();
+    gasnet::bcast_tree_shape shape = {st->root, 0, 0};
+    bcast_tree_resolve(shape);
+    
+    char *dst = static_cast<char*>(st->dst);
+    std::size_t size = st->elt_sz*st->elt_n;
+    
+    bcast_tree_foreach_child(tm, shape, [&](intrank_t child) {
+      backend::send_am_master<progress_level::internal>(
+        tm, child,
+        upcxx::bind(
+          [=](upcxx::view<char> bytes) {
+            am_coll_state *st = detail::registered_state<am_coll_state>(id);
+            
+            if(st->joined)
+              am_coll_arrive_down(id, st, bytes.begin());
+            else
+              st->early_down = am_coll_copy(bytes);
+          },
+          upcxx::make_view(dst, dst + size)
+        )
+      );
+    });
+  }
+  
+  void am_coll_arrive_down(upcxx::digest id, am_coll_state *st, const char *bytes) {
+    std::size_t size = st->elt_sz*st->elt_n;
+    if(size != 0)
+      std::memcpy(st->dst, bytes, size);
+    
+    am_coll_send_down(id, st);
+    am_coll_finish(id, st);
+  }
+  
+  // All of our children have been combined into the accumulator.
+  void am_coll_up_done(upcxx::digest id, am_coll_state *st) {
+    if(st->parent < 0) {
+      if(st->down)
+        am_coll_send_down(id, st);
+      am_coll_finish(id, st);
+      return;
+    }
+    
+    char *accum = st->accum;
+    std::size_t size = st->elt_sz*st->elt_n;
+    
+    backend::send_am_master<progress_level::internal>(
+      st->tm_id.here(), st->parent,
+      upcxx::bind(
+        [=](upcxx::view<char> bytes) {
+          am_coll_state *st = detail::registered_state<am_coll_state>(id);
+          
+          if(!st->joined)
+            st->early_up.push_back(am_coll_copy(bytes));
+          else {
+            am_coll_combine(st, am_coll_copy(bytes).get());
+            if(0 == --st->awaiting)
+              am_coll_up_done(id, st);
+          }
+        },
+        upcxx::make_view(accum, accum + size)
+      )
+    );
+    
+    // Otherwise the root's result comes back down.
+    if(!st->down)
+      am_coll_finish(id, st);
+  }
+}
+
+void gasnet::am_coll(
+    const team &tm, intrank_t root, bool up, bool down,
+    const void *src, void *dst,
+    std::size_t elt_sz, std::size_t elt_n,
+    std::uintptr_t ty_id, std::uintptr_t op_id,
+    void(*op_vecfn)(const void*, void*, std::size_t, const void*),
+    const void *op_data,
+    handle_cb *cb
+  ) {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+  UPCXX_ASSERT(tm.base(detail::internal_only()).via_world);
+  
+  upcxx::digest id = const_cast<team&>(tm).next_collective_id(detail::internal_only());
+  am_coll_state *st = detail::registered_state<am_coll_state>(id);
+  
+  reduce_tree_links links = reduce_tree_links_of(tm, root);
+  std::size_t size = elt_sz*elt_n;
+  
+  st->joined = true;
+  st->tm_id = tm.id();
+  st->root = root;
+  st->parent = links.parent;
+  st->down = down;
+  st->dst = dst;
+  st->elt_sz = elt_sz;
+  st->elt_n = elt_n;
+  st->ty_id = ty_id;
+  st->op_id = op_id;
+  st->op_vecfn = op_vecfn;
+  st->op_data = op_data;
+  st->cb = cb;
+  
+  if(up) {
+    // A non-root's `dst` is left alone by reduce-to-one.
+    if(links.parent >= 0 && !down) {
+      st->accum_own.reset(new char[size]);
+      st->accum = st->accum_own.get();
+    }
+    else
+      st->accum = static_cast<char*>(dst);
+    
+    if(size != 0 && st->accum != src)
+      std::memmove(st->accum, src, size);
+    
+    st->awaiting = links.child_n;
+    for(std::unique_ptr<char[]> const &in: st->early_up) {
+      am_coll_combine(st, in.get());
+      st->awaiting -= 1;
+    }
+    st->early_up.clear();
+    
+    if(st->awaiting == 0)
+      am_coll_up_done(id, st);
+  }
+  else if(links.parent < 0) {
+    if(size != 0 && dst != src)
+      std::memmove(dst, src, size);
+    
+    am_coll_send_down(id, st);
+    am_coll_finish(id, st);
+  }
+  else if(st->early_down) {
+    std::unique_ptr<char[]> bytes = std::move(st->early_down);
+    am_coll_arrive_down(id, st, bytes.get());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Hierarchical world barrier
+//
+// Barriers are numbered in the order this process enters them. Entering
+// barrier `e` stores `e` to our `arrived` word. Each node's local_team is
+// cut into groups of UPCXX_BARRIER_GROUP_SIZE consecutive ranks (the whole
+// node by default). The group leader (its lowest world rank) waits until
+// every peer's word in its group reaches `e`, then runs a dissemination
+// barrier with the other leaders: in round k it signals the leader 2^k
+// groups ahead and waits for the signal from the one 2^k behind. Finally
+// it stores `e` to its `released` word, which the group's peers poll. Words
+// only grow, so a peer already in `e+1` has also arrived at `e`, and
+// counting signals per round lets a fast leader run ahead into the next
+// barrier.
+
+namespace {
+  hier_barrier_flags *hier_barrier_me;     // in our segment
+  hier_barrier_flags *hier_barrier_leader; // in our leader's segment
+  std::unique_ptr<hier_barrier_flags*[/*local_team.size()*/]> hier_barrier_peers; // leader only
+  
+  // Our group as local_team ranks [lb, ub), lb is its leader.
+  intrank_t hier_barrier_group_lb = 0, hier_barrier_group_ub = 0;
+  bool hier_barrier_is_leader = false;
+  
+  int hier_barrier_rounds = 0; // dissemination rounds among leaders
+  std::unique_ptr<intrank_t[/*rounds*/]> hier_barrier_to;   // world rank signalled in round k
+  std::unique_ptr<uint64_t[/*rounds*/]> hier_barrier_heard; // signals received in round k
+  
+  uint64_t hier_barrier_entered = 0;
+  uint64_t hier_barrier_passed = 0;
+  
+  // Barriers entered but not passed, oldest first, linked through next_.
+  gasnet::handle_cb *hier_barrier_head = nullptr;
+  gasnet::handle_cb **hier_barrier_tail = &hier_barrier_head;
+  
+  // Leader's position within barrier `hier_barrier_passed + 1`.
+  intrank_t hier_barrier_scan = 0; // next local peer to wait for
+  int hier_barrier_round = 0;
+  bool hier_barrier_signalled = false; // sent our signal of hier_barrier_round
+  
+  void hier_barrier_init(noise_log &noise) {
+    std::string kind = upcxx::os_env<std::string>("UPCXX_BARRIER", std::string("gasnet"));
+    
+    if(kind != "gasnet" && kind != "hier") {
+      noise.warn()<<"UPCXX_BARRIER="<<kind<<" is not one of gasnet, hier. Using gasnet.";
+      kind = "gasnet";
+    }
+    
+    // Groups have to line up across each node, 0 means the whole node.
+    int64_t group_size = upcxx::os_env<int64_t>("UPCXX_BARRIER_GROUP_SIZE", 0);
+    if(group_size < 0) group_size = 0;
+    agree_settings({{"UPCXX_BARRIER_GROUP_SIZE", &group_size}}, noise);
+    
+    intrank_t peer_n = backend::pshm_peer_n;
+    intrank_t peer_me = backend::rank_me - backend::pshm_peer_lb;
+    
+    // Both reserves above the flags are the same on every process.
+    auto flags_of = [&](intrank_t p) {
+      return reinterpret_cast<hier_barrier_flags*>(
+        backend::pshm_vbase[p] + backend::pshm_size[p]
+          - wait_word_reserve - hier_barrier_reserve
+      );
+    };
+    
+    int64_t ok = kind == "hier" && hier_barrier_reserve != 0 ? 1 : 0;
+    
+    if(ok) {
+      // Leaders are taken from the bcast tree's node grouping, which has to
+      // agree with local_team.
+      bcast_topo const &topo = bcast_topo_of(upcxx::world());
+      int nd = topo.node_of[backend::rank_me];
+      ok = topo.members[topo.node_lb[nd]] == backend::pshm_peer_lb &&
+           topo.node_lb[nd+1] - topo.node_lb[nd] == peer_n ? 1 : 0;
+    }
+    
+    if(ok) {
+      hier_barrier_me = ::new(flags_of(peer_me)) hier_barrier_flags;
+      hier_barrier_me->arrived.store(0, std::memory_order_relaxed);
+      hier_barrier_me->released.store(0, std::memory_order_relaxed);
+    }
+    
+    // Every process has to agree, this also orders the flag initialization
+    // before any peer's first look.
+    gex_Event_Wait(gex_Coll_ReduceToAllNB(
+      world_tm, &ok, &ok, GEX_DT_I64, sizeof(int64_t), 1,
+      GEX_OP_MIN, nullptr, nullptr, 0
+    ));
+    gasnet::hier_barrier_enabled = ok != 0;
+    
+    int leader_n = 0;
+    
+    if(gasnet::hier_barrier_enabled) {
+      bcast_topo const &topo = bcast_topo_of(upcxx::world());
+      auto group_n_of = [&](int nd) {
+        int64_t size = topo.node_lb[nd+1] - topo.node_lb[nd];
+        return group_size == 0 ? 1 : int((size + group_size-1)/group_size);
+      };
+      
+      intrank_t g = group_size == 0 ? peer_n : intrank_t(group_size);
+      hier_barrier_group_lb = peer_me/g*g;
+      hier_barrier_group_ub = std::min(hier_barrier_group_lb + g, peer_n);
+      hier_barrier_is_leader = peer_me == hier_barrier_group_lb;
+      hier_barrier_leader = flags_of(hier_barrier_group_lb);
+      
+      for(int nd=0; nd < topo.node_n; nd++)
+        leader_n += group_n_of(nd);
+      
+      if(hier_barrier_is_leader) {
+        hier_barrier_peers.reset(new hier_barrier_flags*[peer_n]);
+        for(intrank_t p=hier_barrier_group_lb; p < hier_barrier_group_ub; p++)
+          hier_barrier_peers[p] = flags_of(p);
+        hier_barrier_scan = hier_barrier_group_lb + 1;
+        
+        // leaders in order of node, then group within it
+        std::vector<intrank_t> leaders;
+        int ix_me = -1;
+        for(int nd=0; nd < topo.node_n; nd++) {
+          for(int j=0; j < group_n_of(nd); j++) {
+            intrank_t wr = topo.members[topo.node_lb[nd] + j*g];
+            if(wr == backend::rank_me)
+              ix_me = (int)leaders.size();
+            leaders.push_back(wr);
+          }
+        }
+        UPCXX_ASSERT(ix_me >= 0);
+        
+        while((int64_t(1)<<hier_barrier_rounds) < leader_n)
+          hier_barrier_rounds += 1;
+        
+        hier_barrier_to.reset(new intrank_t[hier_barrier_rounds]);
+        hier_barrier_heard.reset(new uint64_t[hier_barrier_rounds]());
+        for(int k=0; k < hier_barrier_rounds; k++)
+          hier_barrier_to[k] = leaders[(ix_me + (int64_t(1)<<k)) % leader_n];
+      }
+    }
+    
+    if(backend::verbose_noise)
+      noise.line()<<"World barrier: "<<(gasnet::hier_barrier_enabled
+        ? "hierarchical, "+std::to_string(leader_n)+" group leaders"
+        : std::string("gasnet"));
   }
-}
-
-void gasnet::send_am_rdzv(
-    progress_level level,
-    const team &tm,
-    intrank_t rank_d,
-    persona *persona_d,
-    void *buf_s,
-    size_t cmd_size,
-    size_t cmd_align
-  ) {
-  
-  intrank_t rank_s = backend::rank_me;
   
-  backend::send_am_persona<progress_level::internal>(
-    tm, rank_d, persona_d,
-    [=]() {
-      if(backend::rank_is_local(rank_s)) {
-        void *payload = backend::localize_memory_nonnull(rank_s, reinterpret_cast<std::uintptr_t>(buf_s));
-        
-        rpc_as_lpc *m = new rpc_as_lpc;
-        m->payload = payload;
-        m->the_vtbl.execute_and_delete = command<detail::lpc_base*>::get_executor(rpc_as_lpc::reader_of(m));
-        m->vtbl = &m->the_vtbl;
-        m->is_rdzv = true;
-        m->rdzv_rank_s = rank_s;
-        m->rdzv_rank_s_local = true;
-        
-        auto &tls = detail::the_persona_tls;
-        tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+  // Passes every entered barrier whose release has been observed, and moves
+  // the leader's side of the oldest one along. Returns the number of
+  // callbacks executed.
+  int hier_barrier_advance() {
+    int exec_n = 0;
+    
+    while(hier_barrier_head != nullptr) {
+      uint64_t epoch = hier_barrier_passed + 1;
+      
+      if(!hier_barrier_is_leader) {
+        if(hier_barrier_leader->released.load(std::memory_order_acquire) < epoch)
+          break;
       }
       else {
-        rpc_as_lpc *m = rpc_as_lpc::build_rdzv_lz(/*use_sheap=*/false, cmd_size, cmd_align);
-        m->rdzv_rank_s = rank_s;
-        m->rdzv_rank_s_local = false;
+        for(; hier_barrier_scan < hier_barrier_group_ub; hier_barrier_scan++) {
+          if(hier_barrier_peers[hier_barrier_scan]->arrived.load(std::memory_order_acquire) < epoch)
+            return exec_n;
+        }
         
-        rma_get(
-          m->payload, rank_s, buf_s, cmd_size,
-          [=]() {
-            auto &tls = detail::the_persona_tls;
-            int rank_s = m->rdzv_rank_s;
-            
-            m->the_vtbl.execute_and_delete = command<detail::lpc_base*>::get_executor(rpc_as_lpc::reader_of(m));
-            tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
-            
-            // Notify source rank it can free buffer.
-            gasnet::send_am_restricted(
-              upcxx::world(), rank_s,
-              [=]() { gasnet::deallocate(buf_s, &gasnet::sheap_footprint_rdzv); }
+        for(; hier_barrier_round < hier_barrier_rounds; hier_barrier_round++) {
+          int k = hier_barrier_round;
+          
+          if(!hier_barrier_signalled) {
+            hier_barrier_signalled = true;
+            backend::send_am_master<progress_level::internal>(
+              upcxx::world(), hier_barrier_to[k],
+              [=]() { hier_barrier_heard[k] += 1; }
             );
           }
-        );
+          
+          if(hier_barrier_heard[k] < epoch)
+            return exec_n;
+          hier_barrier_signalled = false;
+        }
+        
+        hier_barrier_scan = hier_barrier_group_lb + 1;
+        hier_barrier_round = 0;
+        
+        hier_barrier_me->released.store(epoch, std::memory_order_release);
+        for(intrank_t p=hier_barrier_group_lb + 1; p < hier_barrier_group_ub; p++)
+          wait_wake_peer(backend::pshm_peer_lb + p);
       }
+      
+      hier_barrier_passed = epoch;
+      
+      gasnet::handle_cb *cb = hier_barrier_head;
+      hier_barrier_head = cb->next_;
+      if(hier_barrier_head == nullptr)
+        hier_barrier_tail = &hier_barrier_head;
+      
+      cb->execute_and_delete(gasnet::handle_cb_successor{nullptr, nullptr});
+      exec_n += 1;
     }
-  );
+    
+    return exec_n;
+  }
+}
+
+void gasnet::hier_barrier_inject(handle_cb *cb) {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+  
+  uint64_t epoch = ++hier_barrier_entered;
+  
+  cb->next_ = nullptr;
+  *hier_barrier_tail = cb;
+  hier_barrier_tail = &cb->next_;
+  
+  if(!hier_barrier_is_leader) {
+    hier_barrier_me->arrived.store(epoch, std::memory_order_release);
+    wait_wake_peer(backend::pshm_peer_lb + hier_barrier_group_lb);
+  }
 }
 
 void gasnet::bcast_am_master_eager(
     progress_level level,
     const upcxx::team &tm,
-    intrank_t rank_d_ub, // in range [0, 2*rank_n-1)
+    bcast_tree_shape shape,
     bcast_payload_header *payload,
     size_t cmd_size, size_t cmd_align
   ) {
   
-  intrank_t rank_me = tm.rank_me();
-  intrank_t rank_n = tm.rank_n();
-  
   gex_TM_t tm_gex = handle_of(tm);
   
-  // loop over targets
-  while(true) {
-    intrank_t rank_d_mid = rank_me + 15*int64_t(rank_d_ub - rank_me)/16;
-    
-    // Send-to-self is stop condition.
-    if(rank_d_mid == rank_me)
-      break;
-    
-    intrank_t translate = rank_n <= rank_d_mid ? rank_n : 0;
-    
-    // Sub-interval bounds. Lower must be in [0,rank_n).
-    intrank_t sub_lb = rank_d_mid - translate;
-    intrank_t sub_ub = rank_d_ub - translate;
-    
-    payload->eager_subrank_ub = sub_ub;
+  bcast_tree_resolve(shape);
+  payload->eager_shape = shape;
+  
+  bcast_tree_foreach_child(tm, shape, [&](intrank_t child) {
+    perf_msg_peer(pc_am_eager_sends_local, tm, child, cmd_size);
     gex_AM_RequestMedium1(
-      tm_gex, sub_lb,
+      tm_gex, gex_rank_of(tm, child),
       id_am_bcast_master_eager, payload, cmd_size,
       GEX_EVENT_NOW, /*flags*/0,
       cmd_align<<1 | (level == progress_level::user ? 1 : 0)
     );
-    
-    rank_d_ub = rank_d_mid;
-  }
+    wait_wake_peer(tm, child);
+  });
   
   gasnet::after_gasnet();
 }
@@ -1410,7 +3686,7 @@ void gasnet::bcast_am_master_eager(
 void gasnet::bcast_am_master_rdzv(
     progress_level level,
     const upcxx::team &tm,
-    intrank_t rank_d_ub, // in range [0, 2*rank_n-1)
+    bcast_tree_shape shape,
     intrank_t wrank_owner, // self or a local peer (in world)
     bcast_payload_header *payload_owner, // in owner address space
     bcast_payload_header *payload_sender, // in my address space
@@ -1418,22 +3694,13 @@ void gasnet::bcast_am_master_rdzv(
     size_t cmd_align
   ) {
   
-  intrank_t rank_n = tm.rank_n();
-  intrank_t rank_me = tm.rank_me();
   intrank_t wrank_sender = backend::rank_me;
-
+  
+  bcast_tree_resolve(shape);
+  
   { // precompute number of references to add as num messages to be sent
     int messages = 0;
-    intrank_t hi = rank_d_ub;
-    
-    while(true) {
-      intrank_t mid = rank_me + (hi - rank_me)/2;
-      // Send-to-self is stop condition.
-      if(mid == rank_me)
-        break;
-      messages += 1;
-      hi = mid;
-    }
+    bcast_tree_foreach_child(tm, shape, [&](intrank_t) { messages += 1; });
 
     if(payload_owner == payload_sender) {
       // If we are the owner of the refcount, then nobody else could be concurrently
@@ -1448,7 +3715,7 @@ void gasnet::bcast_am_master_rdzv(
           // materializing the am payload was pointless since it is sent to
           // nobody. Seeing this as an unlikely kind of bcast, we will forfeit
           // optimizing out this wasted effort.
-          gasnet::deallocate((void*)payload_sender, &gasnet::sheap_footprint_rdzv);
+          gasnet::deallocate_rdzv((void*)payload_sender);
         }
         return;
       }
@@ -1460,23 +3727,14 @@ void gasnet::bcast_am_master_rdzv(
     }
   }
   
-  // loop over targets
-  while(true) {
-    intrank_t rank_d_mid = rank_me + (rank_d_ub - rank_me)/2;
-    
-    // Send-to-self is stop condition.
-    if(rank_d_mid == rank_me)
-      break;
-    
-    intrank_t translate = rank_n <= rank_d_mid ? rank_n : 0;
-    
-    // Sub-interval bounds. Lower must be in [0,rank_n).
-    intrank_t sub_lb = rank_d_mid - translate;
-    intrank_t sub_ub = rank_d_ub - translate;
+  bcast_tree_foreach_child(tm, shape, [&](intrank_t child) {
+    perf_msg_peer(pc_am_rdzv_sends_local, tm, child, cmd_size);
     
     backend::send_am_master<progress_level::internal>(
-      tm, sub_lb,
+      tm, child,
       [=]() {
+        perf_msg_peer(pc_am_rdzv_recvs_local, wrank_sender, cmd_size);
+        
         if(backend::rank_is_local(wrank_sender)) {
           bcast_payload_header *payload_target =
             (bcast_payload_header*)backend::localize_memory_nonnull(
@@ -1493,15 +3751,20 @@ void gasnet::bcast_am_master_rdzv(
           m->is_rdzv = true;
           m->rdzv_rank_s = wrank_owner;
           m->rdzv_rank_s_local = true;
-
-          bcast_am_master_rdzv(
-              level, payload_target->tm_id.here(), sub_ub,
-              wrank_owner, payload_owner, payload_target,
-              cmd_size, cmd_align
-            );
           
-          auto &tls = detail::the_persona_tls;
-          tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+          // Our children take their references before the rpc can drop
+          // the owner's last one.
+          team_id tm_id = payload_target->tm_id;
+          detail::team_when_here(tm_id, [=]() {
+            bcast_am_master_rdzv(
+                level, tm_id.here(), shape,
+                wrank_owner, payload_owner, payload_target,
+                cmd_size, cmd_align
+              );
+            
+            auto &tls = detail::the_persona_tls;
+            tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+          });
         }
         else {
           bcast_as_lpc *m = rpc_as_lpc::build_rdzv_lz<bcast_as_lpc>(/*use_sheap=*/true, cmd_size, cmd_align);
@@ -1522,21 +3785,24 @@ void gasnet::bcast_am_master_rdzv(
                 m->the_vtbl.execute_and_delete = command<detail::lpc_base*>::get_executor(r);
               }
               
-              bcast_am_master_rdzv(
-                  level, payload_here->tm_id.here(), sub_ub,
-                  backend::rank_me, payload_here, payload_here,
-                  cmd_size, cmd_align
-                );
-              
-              auto &tls = detail::the_persona_tls;
-              tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+              team_id tm_id = payload_here->tm_id;
+              detail::team_when_here(tm_id, [=]() {
+                bcast_am_master_rdzv(
+                    level, tm_id.here(), shape,
+                    backend::rank_me, payload_here, payload_here,
+                    cmd_size, cmd_align
+                  );
+                
+                auto &tls = detail::the_persona_tls;
+                tls.enqueue(*tls.get_top_persona(), level, m, /*known_active=*/std::true_type());
+              });
               
               // Notify source rank it can free buffer.
               send_am_restricted(
                 upcxx::world(), wrank_owner,
                 [=]() {
                   if(0 == -1 + payload_owner->rdzv_refs.fetch_add(-1, std::memory_order_acq_rel))
-                    gasnet::deallocate(payload_owner, &gasnet::sheap_footprint_rdzv);
+                    gasnet::deallocate_rdzv(payload_owner);
                 }
               );
             }
@@ -1544,9 +3810,7 @@ void gasnet::bcast_am_master_rdzv(
         }
       }
     );
-    
-    rank_d_ub = rank_d_mid;
-  }
+  });
 }
 
 namespace upcxx {
@@ -1558,7 +3822,7 @@ namespace gasnet {
       rpc_as_lpc *me = static_cast<rpc_as_lpc*>(me1);
       
       if(!me->is_rdzv) {
-        if(!restricted) std::free(me->payload);
+        if(!restricted) detail::object_free(me->payload);
       }
       else {
         if(me->rdzv_rank_s_local) {
@@ -1569,7 +3833,7 @@ namespace gasnet {
            
           send_am_restricted(
             upcxx::world(), me->rdzv_rank_s,
-            [=]() { gasnet::deallocate(buf_s, &gasnet::sheap_footprint_rdzv); }
+            [=]() { gasnet::deallocate_rdzv(buf_s); }
           );
           
           delete me;
@@ -1602,7 +3866,7 @@ namespace gasnet {
     
     if(!me->is_rdzv) {
       if(0 == --me->eager_refs)
-        std::free(me->payload);
+        detail::object_free(me->payload);
     }
     else {
       bcast_payload_header *hdr = (bcast_payload_header*)me->payload;
@@ -1617,7 +3881,7 @@ namespace gasnet {
           
           send_am_restricted(
             upcxx::world(), me->rdzv_rank_s,
-            [=]() { gasnet::deallocate(buf_s, &gasnet::sheap_footprint_rdzv); }
+            [=]() { gasnet::deallocate_rdzv(buf_s); }
           );
         }
         
@@ -1630,7 +3894,7 @@ namespace gasnet {
             shared_heap_base <= me->payload &&
             (char*)me->payload < (char*)shared_heap_base + shared_heap_sz
           );
-          gasnet::deallocate(me->payload, &gasnet::sheap_footprint_rdzv);
+          gasnet::deallocate_rdzv(me->payload);
         }
       }
     }
@@ -1650,7 +3914,7 @@ RpcAsLpc* rpc_as_lpc::build_eager(
   std::size_t msg_offset = msg_size;
   msg_size += sizeof(RpcAsLpc);
   
-  void *msg_buf = detail::alloc_aligned(msg_size, cmd_alignment);
+  void *msg_buf = detail::object_alloc_aligned(msg_size, cmd_alignment);
   
   if(cmd_buf != nullptr) {
     // The (void**) casts *might* inform memcpy that it can assume word
@@ -1681,7 +3945,7 @@ RpcAsLpc* rpc_as_lpc::build_rdzv_lz(
   
   void *buf;
   if(use_sheap)
-    buf = gasnet::allocate(buf_size, buf_align, &gasnet::sheap_footprint_rdzv);
+    buf = gasnet::allocate_rdzv(buf_size, buf_align);
   else
     buf = detail::alloc_aligned(buf_size, buf_align);
   UPCXX_ASSERT_ALWAYS(buf != nullptr);
@@ -1727,14 +3991,18 @@ void gasnet::after_gasnet() {
     tls.foreach_active_as_top([&](persona &p) {
       burst_cuda(&p);
       
+      int hcb_n = 0;
       #if UPCXX_BACKEND_GASNET_SEQ
         if(&p == &backend::master)
-          exec_n += gasnet::master_hcbs.burst(/*spinning=*/false);
+          hcb_n = gasnet::master_hcbs.burst(/*spinning=*/false);
       #elif UPCXX_BACKEND_GASNET_PAR
-        exec_n += p.backend_state_.hcbs.burst(/*spinning=*/false);
+        hcb_n = p.backend_state_.hcbs.burst(/*spinning=*/false);
       #endif
+      perf_burst(pc_hcb_bursts, hcb_n);
+      
+      int lpc_n = tls.burst_internal(p);
       
-      exec_n += tls.burst_internal(p);
+      exec_n += hcb_n + lpc_n;
     });
     
     total_exec_n += exec_n;
@@ -1742,9 +4010,66 @@ void gasnet::after_gasnet() {
   while(total_exec_n < 100 && exec_n != 0);
   //while(0);
   
+  if(exec_n != 0)
+    perf_add(pc_after_gasnet_limit_hits, 1);
+  
   tls.set_progressing(-1);
 }
 
+////////////////////////////////////////////////////////////////////////
+// progress thread
+
+namespace {
+#if UPCXX_BACKEND_GASNET_PAR
+  std::thread *progress_thread = nullptr;
+  std::atomic<bool> progress_thread_stopping{false};
+  
+  void progress_thread_start() {
+    UPCXX_ASSERT(progress_thread == nullptr);
+    progress_thread_stopping.store(false);
+    
+    progress_thread = new std::thread([]() {
+      // This thread's default persona is the only one it ever holds, so
+      // lpc's and hcbs of other personas, the master's included, are never
+      // run here. That includes the lpc's pulling rendezvous payloads. What
+      // it does provide is AM polling (draining the network, running
+      // handlers, driving GASNet collectives) and internal-level progress
+      // of its own persona.
+      while(!progress_thread_stopping.load(std::memory_order_relaxed)) {
+        upcxx::progress(progress_level::internal);
+        
+        if(oversubscribed)
+          gasnett_sched_yield();
+      }
+    });
+    
+    #if defined(__linux__)
+      if(progress_thread_cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(progress_thread_cpu, &cpus);
+        int err = pthread_setaffinity_np(progress_thread->native_handle(), sizeof(cpu_set_t), &cpus);
+        if(err != 0 && backend::verbose_noise) {
+          noise_log noise("upcxx::init()");
+          noise.warn()<<"Failed to pin progress thread to cpu "<<progress_thread_cpu<<" (error "<<err<<").";
+        }
+      }
+    #endif
+  }
+  
+  void progress_thread_stop() {
+    UPCXX_ASSERT(progress_thread != nullptr);
+    progress_thread_stopping.store(true);
+    progress_thread->join();
+    delete progress_thread;
+    progress_thread = nullptr;
+  }
+#else
+  void progress_thread_start() {}
+  void progress_thread_stop() {}
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////
 // from: upcxx/backend.hpp
 
@@ -1753,20 +4078,37 @@ int upcxx::detail::progressing() {
 }
 
 void upcxx::progress(progress_level level) {
+  progress_pass(level);
+}
+
+namespace {
+// Returns number of callbacks executed.
+int progress_pass(progress_level level) {
   detail::persona_tls &tls = detail::the_persona_tls;
   
   if(tls.get_progressing() >= 0)
-    return;
+    return 0;
   tls.set_progressing((int)level);
   
   if(level == progress_level::user)
     tls.flip_burstable(progress_level::user);
   
+  #if UPCXX_PERF_COUNTERS
+    gasnett_tick_t perf_t0 = detail::perf_counters_on ? gasnett_ticks_now() : 0;
+  #endif
+  
   int total_exec_n = 0;
   int exec_n;
   
-  if(!UPCXX_BACKEND_GASNET_SEQ || gasnet_seq_thread_id == detail::thread_id())
+  if(!UPCXX_BACKEND_GASNET_SEQ || gasnet_seq_thread_id == detail::thread_id()) {
+    if(rpc_agg_pending.load(std::memory_order_relaxed))
+      rpc_agg_flush_all();
+    
     gasnet_AMPoll();
+    
+    if(shm_ring_enabled)
+      shm_ring_drain();
+  }
   
   do {
     exec_n = 0;
@@ -1774,20 +4116,26 @@ void upcxx::progress(progress_level level) {
     tls.foreach_active_as_top([&](persona &p) {
       burst_cuda(&p);
       
+      int hcb_n = 0;
       #if UPCXX_BACKEND_GASNET_SEQ
         if(&p == &backend::master)
-          exec_n += gasnet::master_hcbs.burst(/*spinning=*/true);
+          hcb_n = gasnet::master_hcbs.burst(/*spinning=*/true);
       #elif UPCXX_BACKEND_GASNET_PAR
-        exec_n += p.backend_state_.hcbs.burst(/*spinning=*/true);
+        hcb_n = p.backend_state_.hcbs.burst(/*spinning=*/true);
       #endif
+      if(&p == &backend::master && hier_barrier_head != nullptr)
+        hcb_n += hier_barrier_advance();
+      perf_burst(pc_hcb_bursts, hcb_n);
       
-      exec_n += tls.burst_internal(p);
+      int lpc_n = tls.burst_internal(p);
       
       if(level == progress_level::user) {
         tls.flip_burstable(progress_level::user);
-        exec_n += tls.burst_user(p);
+        lpc_n += tls.burst_user(p);
         tls.flip_burstable(progress_level::user);
       }
+      
+      exec_n += hcb_n + lpc_n;
     });
     
     total_exec_n += exec_n;
@@ -1796,6 +4144,15 @@ void upcxx::progress(progress_level level) {
   while(total_exec_n < 1000 && exec_n != 0);
   //while(0);
   
+  #if UPCXX_PERF_COUNTERS
+    if_pf(detail::perf_counters_on) {
+      perf_add(pc_progress_calls, 1);
+      perf_add(pc_progress_ns, gasnett_ticks_to_ns(gasnett_ticks_now() - perf_t0));
+      if(exec_n != 0)
+        perf_add(pc_progress_limit_hits, 1);
+    }
+  #endif
+  
   if(oversubscribed) {
     /* In SMP tests we typically oversubscribe ranks to cpus. This is
      * an attempt at heuristically determining if this rank is just
@@ -1819,6 +4176,137 @@ void upcxx::progress(progress_level level) {
   
   tls.flip_burstable(progress_level::user);
   tls.set_progressing(-1);
+  return total_exec_n;
+}
+}
+
+////////////////////////////////////////////////////////////////////////
+// idle waiting
+
+namespace {
+  void wait_wake(wait_word *w) {
+    w->seq.fetch_add(1, std::memory_order_seq_cst);
+    #if defined(__linux__)
+      syscall(SYS_futex, &w->seq, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    #endif
+  }
+  
+  void wait_wake_peer_slow(intrank_t wrank) {
+    if(!backend::rank_is_local(wrank) || wrank == backend::rank_me)
+      return;
+    
+    intrank_t p = wrank - backend::pshm_peer_lb;
+    wait_word *w = reinterpret_cast<wait_word*>(
+      backend::pshm_vbase[p] + backend::pshm_size[p] - wait_word_reserve
+    );
+    
+    // Order our preceding AM enqueue before reading the sleeper count. The
+    // sleeper orders its announcement before its final poll.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    if(w->sleepers.load(std::memory_order_relaxed) != 0)
+      wait_wake(w);
+  }
+  
+  void wait_wake_peer(const team &tm, intrank_t peer) {
+    if_pf(wait_wake_peers) {
+      wait_wake_peer_slow(backend::team_rank_to_world(tm, peer));
+    }
+  }
+  
+  void wait_wake_token(gex_Token_t token) {
+    if_pf(wait_wake_peers) {
+      gex_Token_Info_t info;
+      gex_Token_Info(token, &info, GEX_TI_SRCRANK);
+      wait_wake_peer_slow(info.gex_srcrank);
+    }
+  }
+  
+  // Blocking is only safe while everything we wait on arrives through an
+  // AM or a persona inbox, both of which wake us. Pending network handles
+  // (and cuda events) are completed by polling alone.
+  bool wait_may_block(detail::persona_tls &tls) {
+    bool ok = true;
+    
+    tls.foreach_active_as_top([&](persona &p) {
+      #if UPCXX_BACKEND_GASNET_SEQ
+        if(&p == &backend::master)
+          ok &= gasnet::master_hcbs.head_ == nullptr;
+      #elif UPCXX_BACKEND_GASNET_PAR
+        ok &= p.backend_state_.hcbs.head_ == nullptr;
+      #endif
+      
+      #if UPCXX_CUDA_ENABLED
+        ok &= p.cuda_state_.event_cbs.peek() == nullptr;
+      #endif
+    });
+    
+    return ok;
+  }
+  
+  // Returns number of callbacks executed by the final pass.
+  int wait_block() {
+    wait_word *w = wait_word_me;
+    uint32_t seq = w->seq.load(std::memory_order_acquire);
+    
+    w->sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the wakers' fence
+    
+    // Anything enqueued for us before the announcement became visible is
+    // picked up by this pass; anything after it bumps `seq` and wakes us.
+    int exec_n = progress_pass(progress_level::user);
+    
+    if(exec_n == 0) {
+      perf_add(pc_wait_blocks, 1);
+      
+      #if defined(__linux__)
+        struct timespec ts;
+        ts.tv_sec = wait_block_ns/1000000000;
+        ts.tv_nsec = wait_block_ns%1000000000;
+        syscall(SYS_futex, &w->seq, FUTEX_WAIT, seq, &ts, nullptr, 0);
+      #else
+        gasnett_nsleep(wait_block_ns);
+      #endif
+    }
+    
+    w->sleepers.fetch_sub(1, std::memory_order_relaxed);
+    return exec_n;
+  }
+}
+
+std::atomic<std::uint32_t> *detail::wait_sleepers = &wait_word_private.sleepers;
+
+void detail::wait_wake_slow() {
+  wait_wake(wait_word_me);
+}
+
+void detail::progress_wait(int &idle) {
+  if(progress_pass(progress_level::user) != 0) {
+    idle = 0;
+    return;
+  }
+  
+  if(wait_policy == wait_policy_kind::spin)
+    return; // progress() already yields when oversubscribed
+  
+  if(idle <= wait_spin_n + wait_yield_n)
+    idle += 1;
+  
+  if(idle <= wait_spin_n)
+    return;
+  
+  detail::persona_tls &tls = detail::the_persona_tls;
+  
+  if(wait_policy == wait_policy_kind::yield ||
+     idle <= wait_spin_n + wait_yield_n ||
+     !wait_may_block(tls)) {
+    perf_add(pc_wait_yields, 1);
+    gasnett_sched_yield();
+    return;
+  }
+  
+  if(wait_block() != 0)
+    idle = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -1826,10 +4314,12 @@ void upcxx::progress(progress_level level) {
 
 namespace {
   void am_eager_restricted(
-      gex_Token_t,
+      gex_Token_t token,
       void *buf, size_t buf_size,
       gex_AM_Arg_t buf_align
     ) {
+    
+    perf_msg_token(pc_am_eager_recvs_local, token, buf_size);
 
     void *tmp;
     if(0 == (reinterpret_cast<uintptr_t>(buf) & (buf_align-1)))
@@ -1849,12 +4339,13 @@ namespace {
   }
   
   void am_eager_master(
-      gex_Token_t,
+      gex_Token_t token,
       void *buf, size_t buf_size,
       gex_AM_Arg_t buf_align_and_level
     ) {
     
     UPCXX_ASSERT(backend::rank_n != -1);
+    perf_msg_token(pc_am_eager_recvs_local, token, buf_size);
     
     size_t buf_align = buf_align_and_level>>1;
     bool level_user = buf_align_and_level & 1;
@@ -1871,8 +4362,44 @@ namespace {
     );
   }
   
+  void am_eager_master_batch(
+      gex_Token_t token,
+      void *buf, size_t buf_size
+    ) {
+    
+    UPCXX_ASSERT(backend::rank_n != -1);
+    // counted as one message, it was sent as one
+    perf_msg_token(pc_am_eager_recvs_local, token, buf_size);
+    
+    detail::persona_tls &tls = detail::the_persona_tls;
+    char *p = static_cast<char*>(buf);
+    char *end = p + buf_size;
+    
+    while(p != end) {
+      UPCXX_ASSERT(p < end);
+      rpc_agg_header hdr;
+      std::memcpy(&hdr, p, sizeof(rpc_agg_header));
+      
+      size_t buf_align = hdr.cmd_align_and_level>>1;
+      bool level_user = hdr.cmd_align_and_level & 1;
+      
+      rpc_as_lpc *m = rpc_as_lpc::build_eager(p + sizeof(rpc_agg_header), hdr.cmd_size, buf_align);
+      
+      tls.enqueue(
+        backend::master,
+        level_user ? progress_level::user : progress_level::internal,
+        m,
+        /*known_active=*/std::integral_constant<bool, !UPCXX_BACKEND_GASNET_PAR>()
+      );
+      
+      size_t entry_size = sizeof(rpc_agg_header) + hdr.cmd_size;
+      entry_size = (entry_size + sizeof(rpc_agg_header)-1) & -sizeof(rpc_agg_header);
+      p += entry_size;
+    }
+  }
+  
   void am_eager_persona(
-      gex_Token_t,
+      gex_Token_t token,
       void *buf, size_t buf_size,
       gex_AM_Arg_t buf_align_and_level,
       gex_AM_Arg_t per_lo,
@@ -1880,6 +4407,7 @@ namespace {
     ) {
     
     UPCXX_ASSERT(backend::rank_n != -1);
+    perf_msg_token(pc_am_eager_recvs_local, token, buf_size);
     
     size_t buf_align = buf_align_and_level>>1;
     bool level_user = buf_align_and_level & 1;
@@ -1905,12 +4433,14 @@ namespace {
   }
   
   void am_bcast_master_eager(
-      gex_Token_t,
+      gex_Token_t token,
       void *buf, size_t buf_size,
       gex_AM_Arg_t buf_align_and_level
     ) {
     using gasnet::bcast_as_lpc;
     
+    perf_msg_token(pc_am_eager_recvs_local, token, buf_size);
+    
     size_t buf_align = buf_align_and_level>>1;
     bool level_user = buf_align_and_level & 1;
     progress_level level = level_user ? progress_level::user : progress_level::internal;
@@ -1927,11 +4457,14 @@ namespace {
       progress_level::internal,
       [=]() {
         bcast_payload_header *payload = (bcast_payload_header*)m->payload;
+        team_id tm_id = payload->tm_id;
         
-        gasnet::bcast_am_master_eager(level, payload->tm_id.here(), payload->eager_subrank_ub, payload, buf_size, buf_align);
-        
-        if(0 == --m->eager_refs)
-          std::free(m->payload);
+        detail::team_when_here(tm_id, [=]() {
+          gasnet::bcast_am_master_eager(level, tm_id.here(), payload->eager_shape, payload, buf_size, buf_align);
+          
+          if(0 == --m->eager_refs)
+            detail::object_free(m->payload);
+        });
       },
       known_active
     );
@@ -1957,6 +4490,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
   ) {
 
   gex_TM_t tm_h = gasnet::handle_of(tm);
+  gex_Rank_t rank_h = gasnet::gex_rank_of(tm, rank_d);
   gex_Event_t src_h = GEX_EVENT_INVALID, *src_ph;
 
   switch(sync_lb) {
@@ -1969,11 +4503,11 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
     break;
   }
   
-  size_t am_long_max = gex_AM_MaxRequestLong(tm_h, rank_d, src_ph, /*flags*/0, 16);
+  size_t am_long_max = gex_AM_MaxRequestLong(tm_h, rank_h, src_ph, /*flags*/0, 16);
   
   if(am_long_max < buf_size) {
     (void)gex_RMA_PutBlocking(
-      tm_h, rank_d,
+      tm_h, rank_h,
       buf_d, const_cast<void*>(buf_s), buf_size - am_long_max,
       /*flags*/0
     );
@@ -1990,7 +4524,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
     std::memcpy((void*)cmd_arg, am_cmd, am_size);
     
     gex_AM_RequestLong16(
-      tm_h, rank_d,
+      tm_h, rank_h,
       id_am_long_master_packed_cmd,
       const_cast<void*>(buf_s), buf_size, buf_d,
       src_ph,
@@ -2013,7 +4547,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
     std::memcpy(&nonce, &nonce_u, sizeof(gex_AM_Arg_t));
     
     (void)gex_AM_RequestLong5(
-      tm_h, rank_d,
+      tm_h, rank_h,
       id_am_long_master_payload_part,
       const_cast<void*>(buf_s), buf_size, buf_d,
       src_ph,
@@ -2023,7 +4557,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
     );
 
     size_t part_size_max = gex_AM_MaxRequestMedium(
-      tm_h, rank_d, GEX_EVENT_NOW, /*flags*/0, /*num_args*/6
+      tm_h, rank_h, GEX_EVENT_NOW, /*flags*/0, /*num_args*/6
     );
     size_t part_offset = 0;
     
@@ -2031,7 +4565,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
       size_t part_size = std::min(part_size_max, am_size - part_offset);
       
       (void)gex_AM_RequestMedium4(
-        tm_h, rank_d,
+        tm_h, rank_h,
         id_am_long_master_cmd_part,
         (char*)am_cmd + part_offset, part_size,
         GEX_EVENT_NOW,
@@ -2043,6 +4577,7 @@ gasnet::rma_put_then_am_sync gasnet::rma_put_then_am_master_protocol(
       part_offset += part_size;
     }
   }
+  wait_wake_peer(tm, rank_d);
 
   // look for chance to escalate actual synchronization achieved
   if(sync_lb == rma_put_then_am_sync::src_cb) {
@@ -2100,8 +4635,10 @@ namespace {
       /*known_active=*/std::integral_constant<bool, !UPCXX_BACKEND_GASNET_PAR>()
     );
 
-    if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0))
+    if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0)) {
       gex_AM_ReplyShort2(token, id_am_reply_cb, 0, reply_cb_lo, reply_cb_hi);
+      wait_wake_token(token);
+    }
   }
 
   struct am_long_reassembly_state: rpc_as_lpc {
@@ -2165,8 +4702,10 @@ namespace {
         /*known_active=*/std::integral_constant<bool, !UPCXX_BACKEND_GASNET_PAR>()
       );
       
-      if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0))
+      if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0)) {
         gex_AM_ReplyShort2(token, id_am_reply_cb, 0, reply_cb_lo, reply_cb_hi);
+        wait_wake_token(token);
+      }
     }
   }
 
@@ -2234,8 +4773,10 @@ namespace {
         /*known_active=*/std::integral_constant<bool, !UPCXX_BACKEND_GASNET_PAR>()
       );
       
-      if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0))
+      if(!(reply_cb_lo == 0x0 && reply_cb_hi == 0x0)) {
         gex_AM_ReplyShort2(token, id_am_reply_cb, 0, reply_cb_lo, reply_cb_hi);
+        wait_wake_token(token);
+      }
     }
   }
     
@@ -2267,7 +4808,18 @@ inline int handle_cb_queue::burst(bool maybe_spinning) {
   // aborted_burst_n_ counter. Upon beginning a burst() scan, we set our N value
   // to linearly increase with the abort counter so that a recent history of
   // repeated failure motivates us to look harder for ready handles.
-
+  //
+  // Handles are tested a window at a time with one gex_Event_TestSome() call,
+  // which marks the completed ones GEX_EVENT_INVALID. The window is then
+  // walked in queue order so callbacks still run FIFO. A window covers the
+  // misses we are still willing to take, or twice the hits of the window
+  // before it, so a scan costs O(completions + N) tests rather than
+  // O(outstanding). Successors a callback inserts ahead of the rest of its
+  // window are stepped over, and the next window starts back at the first of
+  // them, so they are tested in this same burst.
+
+  constexpr int window_max = 64;
+  
   int exec_n = 0;
   handle_cb **pp = &this->head_;
 
@@ -2286,40 +4838,90 @@ inline int handle_cb_queue::burst(bool maybe_spinning) {
   // to see beyond the nefarious N-cluster which may have percolated to the front.
   int miss_n = -4*aborted_burst_n_and_spinning;
   
+  handle_cb *win[window_max];
+  gex_Event_t ev[window_max];
+  int win_hits = 0;
+  
   while(*pp != nullptr) {
-    handle_cb *p = *pp;
-    gex_Event_t ev = reinterpret_cast<gex_Event_t>(p->handle);
+    // Gather the next window: enough handles to reach the abort condition if
+    // none is ready, or twice the previous window's hits while they flow.
+    int win_n = std::min<int>(window_max, std::max<int>(miss_limit - miss_n, 2*win_hits));
+    win_hits = 0;
+    int k = 0;
+    for(handle_cb *p = *pp; p != nullptr && k != win_n; p = p->next_) {
+      win[k] = p;
+      ev[k] = reinterpret_cast<gex_Event_t>(p->handle);
+      k += 1;
+    }
     
-    if(0 == gex_Event_Test(ev)) {
-      // remove from queue
-      *pp = p->next_;
-      if(*pp == nullptr)
-        this->set_tailp(pp);
-      
-      // do it!
-      p->execute_and_delete(handle_cb_successor{this, pp});
-      
-      exec_n += 1;
-      
-      // Break the miss streak. Intentionally clobber negative values since now
-      // that the app has learned of completed communication, it may have more
-      // productive work to do outside of progress(), so we should feel pressure
-      // to abort.
-      miss_n = 0;
+    (void)gex_Event_TestSome(ev, k, /*flags*/0);
+    
+    bool abort = false;
+    handle_cb **rewind = nullptr; // link to the first successor stepped over
+    
+    for(int i=0; i != k; i++) {
+      handle_cb *p = win[i];
+      UPCXX_ASSERT(*pp == p);
       
-      aborted_burst_n = 0; // Reset abort history.
-    }
-    else {
-      miss_n += 1;
-      if(miss_n == miss_limit) { // Miss streak triggered abort.
-        // Only increase abort history if we are spinning and this burst() was
-        // entirely fruitless.
-        if(maybe_spinning && exec_n == 0)
-          aborted_burst_n = std::min<int>(aborted_burst_n + 1, 1024);
-        break;
+      if(ev[i] == GEX_EVENT_INVALID) {
+        // remove from queue
+        *pp = p->next_;
+        if(*pp == nullptr)
+          this->set_tailp(pp);
+        
+        // do it!
+        p->execute_and_delete(handle_cb_successor{this, pp});
+        
+        exec_n += 1;
+        win_hits += 1;
+        
+        // Break the miss streak. Intentionally clobber negative values since now
+        // that the app has learned of completed communication, it may have more
+        // productive work to do outside of progress(), so we should feel pressure
+        // to abort.
+        miss_n = 0;
+        
+        aborted_burst_n = 0; // Reset abort history.
+        
+        // Step over successors the callback inserted, they weren't tested.
+        if(i+1 != k && *pp != win[i+1]) {
+          if(rewind == nullptr)
+            rewind = pp;
+          while(*pp != win[i+1])
+            pp = &(*pp)->next_;
+        }
       }
-      
-      pp = &p->next_;
+      else {
+        miss_n += 1;
+        pp = &p->next_;
+        
+        if(miss_n == miss_limit) { // Miss streak triggered abort.
+          // Only increase abort history if we are spinning and this burst() was
+          // entirely fruitless.
+          if(maybe_spinning && exec_n == 0)
+            aborted_burst_n = std::min<int>(aborted_burst_n + 1, 1024);
+          
+          // GASNet already retired the rest of the window's completed
+          // events, their callbacks run on the next burst.
+          for(int j=i+1; j != k; j++) {
+            if(ev[j] == GEX_EVENT_INVALID)
+              win[j]->handle = reinterpret_cast<std::uintptr_t>(GEX_EVENT_INVALID);
+          }
+          
+          abort = true;
+          break;
+        }
+      }
+    }
+    
+    if(abort)
+      break;
+    
+    if(rewind != nullptr) {
+      // The window's handles past the successors get tested again, so their
+      // misses must not count twice.
+      pp = rewind;
+      miss_n = 0;
     }
   }
 
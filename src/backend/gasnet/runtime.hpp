@@ -8,6 +8,7 @@
 #include <upcxx/backend_fwd.hpp>
 #include <upcxx/bind.hpp>
 #include <upcxx/command.hpp>
+#include <upcxx/concurrency.hpp>
 #include <upcxx/persona.hpp>
 #include <upcxx/team_fwd.hpp>
 
@@ -23,6 +24,71 @@ namespace gasnet {
   extern std::size_t am_size_rdzv_cutover;
   extern std::size_t am_long_size_max;
 
+  // Eager/rendezvous cutovers for rpc's to local_team peers and to off-node
+  // peers respectively. Both start at `am_size_rdzv_cutover` unless overridden
+  // from the environment, and are retuned online when adaptation is enabled.
+  extern detail::par_atomic<std::size_t> am_size_rdzv_cutover_local;
+  extern detail::par_atomic<std::size_t> am_size_rdzv_cutover_remote;
+  // True if the cutover can differ by peer, otherwise `am_size_rdzv_cutover`
+  // applies to everyone and `rdzv_cutover_probe` takes its trivial path.
+  extern bool am_size_rdzv_cutover_per_peer;
+
+  // UPCXX_CPU_ATOMICS: atomic_domains over teams within one node may bypass
+  // gasnet and use CPU atomics.
+  extern bool cpu_atomics_enabled;
+  // UPCXX_BULK_ATOMICS_LOCAL: bulk atomic targets in local_team are issued
+  // directly rather than shipped to their rank like remote ones.
+  extern bool bulk_atomics_local;
+
+  // UPCXX_BARRIER=hier: barriers over upcxx::world() go through
+  // hier_barrier_inject() instead of gex_Coll_BarrierNB.
+  extern bool hier_barrier_enabled;
+
+  // UPCXX_ALLTOALL_BRUCK_MAX: largest alltoall block, in bytes, exchanged
+  // with Bruck's log2(n)-round algorithm rather than pairwise.
+  extern std::size_t alltoall_bruck_max;
+  // UPCXX_ALLTOALL_EAGER_MAX: largest pairwise alltoall(v) block, in bytes,
+  // carried inside an AM. Larger ones are rput into the receiver.
+  extern std::size_t alltoall_eager_max;
+
+  // Selects the cutover for an rpc to `recipient` and (when adaptation is
+  // enabled) occasionally times the send to feed back into the tuner.
+  struct rdzv_cutover_probe {
+    std::size_t cutover;
+    std::uint64_t ticks; // nonzero iff this send is being sampled
+    bool local;
+
+    rdzv_cutover_probe(const team &tm, intrank_t recipient) {
+      if(!am_size_rdzv_cutover_per_peer) {
+        cutover = am_size_rdzv_cutover;
+        ticks = 0;
+      }
+      else
+        begin_slow(tm, recipient);
+    }
+
+    // Called just before the send. A sampled rendezvous is timed until the
+    // target acknowledges `buffer` (see deallocate_rdzv), which may happen
+    // before the send even returns.
+    void sending(bool is_eager, std::size_t cmd_size, void *buffer) {
+      if(ticks != 0 && !is_eager)
+        sending_rdzv_slow(cmd_size, buffer);
+    }
+
+    // Called just after the send. An eager send is complete once injected,
+    // but one that was only appended to an rpc aggregation batch (`batched`)
+    // has not been sent yet and goes unsampled.
+    void finish(bool is_eager, std::size_t cmd_size, bool batched = false) {
+      if(ticks != 0 && is_eager && !batched)
+        finish_eager_slow(cmd_size);
+    }
+
+  private:
+    void begin_slow(const team &tm, intrank_t recipient);
+    void sending_rdzv_slow(std::size_t cmd_size, void *buffer);
+    void finish_eager_slow(std::size_t cmd_size);
+  };
+
   struct sheap_footprint_t {
     std::size_t count, bytes;
   };
@@ -43,12 +109,23 @@ namespace gasnet {
 
   // Deallocate shared heap buffer, foot must match that given to allocate.
   void  deallocate(void *p, sheap_footprint_t *foot);
+
+  // Allocate/deallocate rendezvous payload buffers. Small buffers are recycled
+  // through a per-thread size-class cache before falling back to
+  // allocate/deallocate with `sheap_footprint_rdzv`. Buffers may be freed by
+  // a different thread than allocated them.
+  void* allocate_rdzv(std::size_t size, std::size_t align);
+  void  deallocate_rdzv(void *p);
   
   void after_gasnet();
 
   // Register a handle callback for the current persona
   void register_cb(handle_cb *cb);
   
+  // Enter the next hierarchical world barrier. `cb` is executed by the
+  // master persona's progress once every rank has entered it.
+  void hier_barrier_inject(handle_cb *cb);
+  
   // Send AM (packed command), receiver executes in handler.
   void send_am_eager_restricted(
     const team &tm,
@@ -62,8 +139,9 @@ namespace gasnet {
   template<typename Fn>
   void send_am_restricted(const team &tm, intrank_t recipient, Fn &&fn);
   
-  // Send AM (packed command), receiver executes in `level` progress.
-  void send_am_eager_master(
+  // Send AM (packed command), receiver executes in `level` progress. Returns
+  // true if it was only appended to an aggregation batch (UPCXX_RPC_AGGREGATE).
+  bool send_am_eager_master(
     progress_level level,
     const team &tm,
     intrank_t recipient,
@@ -93,10 +171,18 @@ namespace gasnet {
 
   struct bcast_payload_header;
   
+  // Identifies a bcast_am_master fan-out tree. Travels with the payload so
+  // every rank derives the same tree regardless of its own settings.
+  struct bcast_tree_shape {
+    intrank_t root; // team coordinates
+    std::uint16_t radix_net;   // fan-out among node leaders, 0 = UPCXX_BCAST_RADIX
+    std::uint16_t radix_local; // fan-out within a node, 0 = UPCXX_BCAST_LOCAL_RADIX
+  };
+  
   void bcast_am_master_eager(
     progress_level level,
     const team &tm,
-    intrank_t rank_d_ub, // in range [0, 2*rank_n-1)
+    bcast_tree_shape shape,
     bcast_payload_header *payload,
     size_t cmd_size,
     size_t cmd_align
@@ -104,13 +190,42 @@ namespace gasnet {
   void bcast_am_master_rdzv(
     progress_level level,
     const team &tm,
-    intrank_t rank_d_ub, // in range [0, 2*rank_n-1)
+    bcast_tree_shape shape,
     intrank_t wrank_owner, // world team coordinates
     bcast_payload_header *payload_owner, // owner address of payload
     bcast_payload_header *payload_sender, // sender (my) address of payload
     size_t cmd_size,
     size_t cmd_align
   );
+  
+  // Drops the bcast tree topology cached for a team being destroyed.
+  void bcast_tree_forget(const team &tm);
+  
+  // My links in the default-radix bcast tree rooted at `root`, which
+  // reductions traverse leaf to root: partial results go to `parent` (-1 at
+  // the root) after arriving from `child_n` children.
+  struct reduce_tree_links {
+    intrank_t parent;
+    int child_n;
+  };
+  reduce_tree_links reduce_tree_links_of(const team &tm, intrank_t root);
+
+  // Collective over a team with no gex team of its own (team_base::via_world)
+  // carried by AMs along the default bcast tree rooted at `root`. With `up`,
+  // every rank's `elt_n` elements at `src` are combined leaf to root with
+  // the GEX_DT/GEX_OP pair `ty_id`/`op_id` (`op_vecfn` for GEX_OP_USER) into
+  // the root's `dst`. With `down`, the root's `dst` is then copied to every
+  // other rank's `dst`. `cb` is made ready once this rank is done. Barrier is
+  // up and down with no elements, broadcast is down alone.
+  void am_coll(
+    const team &tm, intrank_t root, bool up, bool down,
+    const void *src, void *dst,
+    std::size_t elt_sz, std::size_t elt_n,
+    std::uintptr_t ty_id, std::uintptr_t op_id,
+    void(*op_vecfn)(const void*, void*, std::size_t, const void*),
+    const void *op_data,
+    handle_cb *cb
+  );
 
   enum class rma_put_then_am_sync: int {
     // These numeric assignments intentionally match like-named members of
@@ -172,7 +287,7 @@ namespace gasnet {
   struct bcast_payload_header {
     team_id tm_id;
     union {
-      int eager_subrank_ub;
+      bcast_tree_shape eager_shape;
       std::atomic<std::int64_t> rdzv_refs;
     };
 
@@ -196,6 +311,29 @@ namespace gasnet {
     static void cleanup(detail::lpc_base *me);
   };
   
+  // Serializes a command, preceded by space for a `Header` if non-void, onto
+  // any writer. Lets an am_send_buffer serialize the command a second time
+  // once it knows the exact size.
+  template<detail::serialization_reader(*reader)(detail::lpc_base*),
+           void(*cleanup)(detail::lpc_base*),
+           typename Fn, typename Header=void>
+  struct am_command_serializer {
+    Fn const &fn;
+    
+    template<typename Writer>
+    void place_header(Writer &w, std::true_type header_is_void) const {}
+    template<typename Writer>
+    void place_header(Writer &w, std::false_type header_is_void) const {
+      w.place(storage_size_of<Header>());
+    }
+    
+    template<typename Writer>
+    void operator()(Writer &w, std::size_t size_ub) const {
+      this->place_header(w, std::is_void<Header>());
+      detail::command<detail::lpc_base*>::template serialize<reader, cleanup>(w, size_ub, fn);
+    }
+  };
+  
   template<typename Ub,
            bool is_static_and_eager = (Ub::static_size <= gasnet::am_size_rdzv_cutover_min)>
   struct am_send_buffer;
@@ -212,11 +350,15 @@ namespace gasnet {
     static constexpr std::size_t tiny_size = 512 < serialization_align_max ? 512 : serialization_align_max;
     detail::xaligned_storage<tiny_size, serialization_align_max> tiny_;
     
-    detail::serialization_writer</*bounded=*/false> prepare_writer(invalid_storage_size_t, std::size_t rdzv_cutover_size) {
-      return detail::serialization_writer<false>(tiny_.storage(), tiny_size);
+    // No upper bound is known, so the first pass only stores into `tiny_`
+    // and measures beyond that. Commands that outgrow it are serialized a
+    // second time directly into their eager or rendezvous buffer.
+    detail::serialization_measuring_writer prepare_writer(invalid_storage_size_t, std::size_t rdzv_cutover_size) {
+      return detail::serialization_measuring_writer(tiny_.storage(), tiny_size);
     }
     
-    void finalize_buffer(detail::serialization_writer<false> &&w, std::size_t rdzv_cutover_size) {
+    template<typename Serializer>
+    void finalize_buffer(detail::serialization_measuring_writer &&w, std::size_t rdzv_cutover_size, Serializer const &ser) {
       is_eager = w.size() <= gasnet::am_size_rdzv_cutover_min ||
                  w.size() <= rdzv_cutover_size;
       cmd_size = w.size();
@@ -228,9 +370,15 @@ namespace gasnet {
         if(is_eager)
           buffer = detail::alloc_aligned(w.size(), w.align());
         else
-          buffer = gasnet::allocate(w.size(), w.align(), &gasnet::sheap_footprint_rdzv);
+          buffer = gasnet::allocate_rdzv(w.size(), w.align());
         
-        w.compact_and_invalidate(buffer);
+        if(w.contained_in_initial())
+          w.compact_and_invalidate(buffer);
+        else {
+          detail::serialization_writer</*bounded=*/true> w1(buffer);
+          ser(w1, cmd_size);
+          UPCXX_ASSERT(w1.size() == cmd_size, "Serialization size changed between passes: "<<cmd_size<<" then "<<w1.size());
+        }
       }
     }
 
@@ -277,12 +425,13 @@ namespace gasnet {
           buffer = detail::alloc_aligned(ub.size, ub.align);
       }
       else
-        buffer = gasnet::allocate(ub.size, ub.align, &gasnet::sheap_footprint_rdzv);
+        buffer = gasnet::allocate_rdzv(ub.size, ub.align);
       
       return detail::serialization_writer<true>(buffer);
     }
 
-    void finalize_buffer(detail::serialization_writer<true> &&w, std::size_t rdzv_cutover_size) {
+    template<typename Serializer>
+    void finalize_buffer(detail::serialization_writer<true> &&w, std::size_t rdzv_cutover_size, Serializer const&) {
       cmd_size = w.size();
       cmd_align = w.align();
     }
@@ -319,7 +468,8 @@ namespace gasnet {
       return detail::serialization_writer<true>(buf_.storage());
     }
     
-    void finalize_buffer(detail::serialization_writer<true> &&w, std::size_t rdzv_cutover_size) {
+    template<typename Serializer>
+    void finalize_buffer(detail::serialization_writer<true> &&w, std::size_t rdzv_cutover_size, Serializer const&) {
       cmd_size = w.size();
       cmd_align = w.align();
     }
@@ -402,27 +552,33 @@ namespace backend {
     
     constexpr bool definitely_not_rdzv = ub.static_size <= gasnet::am_size_rdzv_cutover_min;
 
+    gasnet::am_command_serializer<
+        &rpc_as_lpc::reader_of,
+        &rpc_as_lpc::template cleanup<definitely_not_rdzv, restricted>,
+        typename std::decay<Fn>::type
+      > ser{fn};
+    
     am_send_buffer<decltype(ub)> am_buf;
     auto w = am_buf.prepare_writer(ub, rdzv_cutover_size);
     
-    detail::command<detail::lpc_base*>::template serialize<
-        &rpc_as_lpc::reader_of,
-        &rpc_as_lpc::template cleanup<definitely_not_rdzv, restricted>
-      >(w, ub.size, fn);
+    ser(w, ub.size);
 
-    am_buf.finalize_buffer(std::move(w), rdzv_cutover_size);
+    am_buf.finalize_buffer(std::move(w), rdzv_cutover_size, ser);
     
     return am_buf;
   }
 
+  // Returns true if the message was only batched, see send_am_eager_master.
   template<typename AmBuf>
-  void send_prepared_am_master(progress_level level, const team &tm, intrank_t recipient, AmBuf &&am) {
+  bool send_prepared_am_master(progress_level level, const team &tm, intrank_t recipient, AmBuf &&am) {
     UPCXX_ASSERT(!UPCXX_BACKEND_GASNET_SEQ || backend::master.active_with_caller());
 
     if(am.is_eager)
-      gasnet::send_am_eager_master(level, tm, recipient, am.buffer, am.cmd_size, am.cmd_align);
-    else
+      return gasnet::send_am_eager_master(level, tm, recipient, am.buffer, am.cmd_size, am.cmd_align);
+    else {
       gasnet::send_am_rdzv(level, tm, recipient, /*master*/nullptr, am.buffer, am.cmd_size, am.cmd_align);
+      return false;
+    }
   }
   
   template<upcxx::progress_level level, typename Fn>
@@ -454,9 +610,14 @@ namespace backend {
       else
         gasnet::send_am_rdzv(level, tm, recipient, /*master*/nullptr, am_buf.buffer, am_buf.cmd_size, am_buf.cmd_align);
     #else
-      backend::send_prepared_am_master(
-        level, tm, recipient, prepare_am(std::forward<Fn>(fn))
-      );
+      gasnet::rdzv_cutover_probe probe(tm, recipient);
+      auto am(prepare_am(std::forward<Fn>(fn), probe.cutover));
+      bool is_eager = am.is_eager;
+      std::size_t cmd_size = am.cmd_size;
+      probe.sending(is_eager, cmd_size, am.buffer);
+      
+      bool batched = backend::send_prepared_am_master(level, tm, recipient, std::move(am));
+      probe.finish(is_eager, cmd_size, batched);
     #endif
   }
 
@@ -506,10 +667,16 @@ namespace backend {
       else
         gasnet::send_am_rdzv(level, tm, recipient_rank, recipient_persona, am_buf.buffer, am_buf.cmd_size, am_buf.cmd_align);
     #else
+      gasnet::rdzv_cutover_probe probe(tm, recipient_rank);
+      auto am(prepare_am(std::forward<Fn>(fn), probe.cutover));
+      bool is_eager = am.is_eager;
+      std::size_t cmd_size = am.cmd_size;
+      probe.sending(is_eager, cmd_size, am.buffer);
+      
       backend::send_prepared_am_persona(
-        level, tm, recipient_rank, recipient_persona,
-        prepare_am(std::forward<Fn>(fn))
+        level, tm, recipient_rank, recipient_persona, std::move(am)
       );
+      probe.finish(is_eager, cmd_size);
     #endif
   }
 
@@ -552,24 +719,29 @@ namespace backend {
     constexpr bool definitely_not_rdzv = ub.static_size <= gasnet::am_size_rdzv_cutover_min;
     std::size_t rdzv_cutover_size = gasnet::am_size_rdzv_cutover;
     
+    gasnet::am_command_serializer<
+        bcast_as_lpc::reader_of,
+        bcast_as_lpc::template cleanup</*definitely_not_rdzv=*/definitely_not_rdzv>,
+        typename std::decay<Fn1>::type,
+        bcast_payload_header
+      > ser{fn};
+    
     am_send_buffer<decltype(ub)> am_buf;
 
     auto w = am_buf.prepare_writer(ub, rdzv_cutover_size);
-    w.place(storage_size_of<bcast_payload_header>());
     
-    detail::command<detail::lpc_base*>::template serialize<
-        bcast_as_lpc::reader_of,
-        bcast_as_lpc::template cleanup</*definitely_not_rdzv=*/definitely_not_rdzv>
-      >(w, ub.size, fn);
+    ser(w, ub.size);
     
-    am_buf.finalize_buffer(std::move(w), rdzv_cutover_size);
+    am_buf.finalize_buffer(std::move(w), rdzv_cutover_size, ser);
 
     bcast_payload_header *payload = new(am_buf.buffer) bcast_payload_header;
     payload->tm_id = tm.id();
     
+    gasnet::bcast_tree_shape shape = {tm.rank_me(), 0, 0};
+    
     if(am_buf.is_eager) {
       gasnet::bcast_am_master_eager(
-          level, tm, tm.rank_me() + tm.rank_n(),
+          level, tm, shape,
           payload, am_buf.cmd_size, am_buf.cmd_align
         );
     }
@@ -577,8 +749,7 @@ namespace backend {
       new(&payload->rdzv_refs) std::atomic<std::int64_t>(0);
       
       gasnet::bcast_am_master_rdzv(
-          level, tm,
-          /*rank_d_ub*/tm.rank_me() + tm.rank_n(),
+          level, tm, shape,
           /*rank_owner*/backend::rank_me,
           /*payload_owner/sender*/payload, payload,
           am_buf.cmd_size, am_buf.cmd_align
@@ -631,7 +802,7 @@ namespace gasnet {
   template<>
   inline void rpc_as_lpc::cleanup</*definitely_not_rdzv=*/true, /*restricted=*/false>(detail::lpc_base *me1) {
     rpc_as_lpc *me = static_cast<rpc_as_lpc*>(me1);
-    std::free(me->payload);
+    detail::object_free(me->payload);
   }
   
   template<>
@@ -643,7 +814,7 @@ namespace gasnet {
   inline void bcast_as_lpc::cleanup</*definitely_not_rdzv=*/true>(detail::lpc_base *me1) {
     bcast_as_lpc *me = static_cast<bcast_as_lpc*>(me1);
     if(0 == --me->eager_refs)
-      std::free(me->payload);
+      detail::object_free(me->payload);
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -669,7 +840,11 @@ namespace gasnet {
     
     constexpr std::size_t arg_size = sizeof(std::int32_t);
 
-    auto am(backend::prepare_am(am_fn, rank_d_is_local ? am_size_rdzv_cutover : /*rdzv disabled=*/std::size_t(-1)));
+    auto am(backend::prepare_am(am_fn,
+      !rank_d_is_local ? /*rdzv disabled=*/std::size_t(-1) :
+      am_size_rdzv_cutover_per_peer ? am_size_rdzv_cutover_local.load(std::memory_order_relaxed) :
+                                      am_size_rdzv_cutover
+    ));
 
     if(rank_d_is_local) {
       void *buf_d_local = backend::localize_memory_nonnull(rank_d, reinterpret_cast<std::uintptr_t>(buf_d));
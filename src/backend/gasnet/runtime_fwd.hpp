@@ -8,6 +8,7 @@
 #include <upcxx/backend_fwd.hpp>
 
 #include <cstdint>
+#include <memory>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -21,6 +22,46 @@ namespace upcxx {
 namespace backend {
   struct team_base {
     std::uintptr_t handle;
+    
+    // Rank translation, filled in by the team's constructor. Team rank `r`
+    // is world rank `world_lb + r*world_stride` unless the team's ranks are
+    // not evenly spaced, in which case `to_world` lists them and
+    // `from_world` is an open addressing table of team ranks keyed by world
+    // rank (-1 = empty).
+    intrank_t world_lb = 0, world_stride = 1;
+    std::unique_ptr<intrank_t[]> to_world;
+    std::unique_ptr<intrank_t[]> from_world;
+    std::uint32_t from_world_mask = 0;
+
+    // Teams from team::create() and team::split_async() have no gex team of
+    // their own. Their `handle` is the world gex team, so peers are named to
+    // gasnet by world rank, and their collectives run over AMs. The rank
+    // translation above is then filled in by whoever built the team.
+    bool via_world = false;
+
+    team_base(std::uintptr_t handle): handle(handle) {}
+    
+    static std::uint32_t from_world_hash(intrank_t rank) {
+      return std::uint32_t(rank)*0x9e3779b1u;
+    }
+    
+    intrank_t rank_to_world(intrank_t peer) const {
+      return to_world ? to_world[peer] : world_lb + peer*world_stride;
+    }
+    
+    intrank_t rank_from_world(intrank_t rank, intrank_t rank_n, intrank_t otherwise) const {
+      if(to_world) {
+        for(std::uint32_t i = from_world_hash(rank); true; i++) {
+          intrank_t peer = from_world[i & from_world_mask];
+          if(peer < 0 || to_world[peer] == rank)
+            return peer < 0 ? otherwise : peer;
+        }
+      }
+      
+      intrank_t d = rank - world_lb;
+      intrank_t peer = d/world_stride;
+      return peer*world_stride == d && 0 <= peer && peer < rank_n ? peer : otherwise;
+    }
   };
 }}
 
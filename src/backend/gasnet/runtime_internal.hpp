@@ -34,7 +34,12 @@ namespace gasnet {
   inline gex_TM_t handle_of(const upcxx::team &tm) {
     return reinterpret_cast<gex_TM_t>(tm.base(detail::internal_only()).handle);
   }
-  
+
+  // The rank to pass gasnet alongside handle_of(tm) to address team rank `peer`.
+  inline gex_Rank_t gex_rank_of(const upcxx::team &tm, intrank_t peer) {
+    return tm.base(detail::internal_only()).via_world ? tm[peer] : peer;
+  }
+
   // Register a handle as a future with the current persona
   inline future<> register_handle_as_future(gex_Event_t h) {
     struct callback: handle_cb {
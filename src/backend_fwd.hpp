@@ -20,6 +20,7 @@
 
 #include <upcxx/future/fwd.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -74,10 +75,17 @@ namespace upcxx {
   void deallocate(void *p);
   namespace detail {
     std::string shared_heap_stats();
+    // Current eager/rendezvous cutover (in bytes) applied to rpc's bound for
+    // local_team peers (`local_peers=true`) or for off-node peers.
+    std::size_t rdzv_cutover(bool local_peers);
   }
   
   void progress(progress_level level = progress_level::user);
   
+  // Ships all rpc's held back by per-destination aggregation (see
+  // UPCXX_RPC_AGGREGATE in docs/runtime-tuning.md). No-op when disabled.
+  void rpc_aggregate_flush();
+  
   persona& master_persona();
   void liberate_master_persona();
   
@@ -96,6 +104,25 @@ namespace upcxx {
   
   namespace detail {
     int progressing();
+    
+    // One pass of user-level progress on behalf of a blocked wait. `idle`
+    // carries the caller's count of consecutive fruitless passes, by which
+    // the process's wait policy (UPCXX_WAIT_POLICY) decides whether to spin,
+    // yield, or block.
+    void progress_wait(int &idle);
+    
+    // Wakes threads of this process blocked in progress_wait(). Must follow
+    // every enqueue onto a persona owned by some other thread.
+    extern std::atomic<std::uint32_t> *wait_sleepers;
+    void wait_wake_slow();
+    
+    inline void wait_wake() {
+      // Order the caller's enqueue before reading the sleeper count. The
+      // sleeper orders its announcement before its final poll.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(wait_sleepers->load(std::memory_order_relaxed) != 0)
+        wait_wake_slow();
+    }
   }
 }
 
@@ -87,9 +87,11 @@ namespace {
         backend::send_am_master<progress_level::internal>(
           tm, parent,
           [=]() {
-            team &tm = tm_id.here();
-            barrier_state *me = barrier_state::lookup(tm, id);
-            me->receive(tm, id);
+            detail::team_when_here(tm_id, [=]() {
+              team &tm = tm_id.here();
+              barrier_state *me = barrier_state::lookup(tm, id);
+              me->receive(tm, id);
+            });
           }
         );
       }
@@ -125,6 +127,22 @@ namespace {
 
 void upcxx::barrier(const team &tm) {
   UPCXX_ASSERT(backend::master.active_with_caller());
+  
+  if((backend::gasnet::hier_barrier_enabled && &tm == &upcxx::world()) ||
+     tm.base(detail::internal_only()).via_world) {
+    struct done_cb final: backend::gasnet::handle_cb {
+      bool done = false;
+      void execute_and_delete(backend::gasnet::handle_cb_successor) {
+        done = true;
+      }
+    } cb;
+    
+    detail::barrier_async_inject(tm, &cb);
+    
+    while(!cb.done)
+      upcxx::progress();
+    return;
+  }
  
   // memory fencing is handled inside gex_Coll_BarrierNB + gex_Event_Test
   //std::atomic_thread_fence(std::memory_order_release);
@@ -144,6 +162,16 @@ void upcxx::detail::barrier_async_inject(
   UPCXX_ASSERT(backend::master.active_with_caller());
 
   #if 1
+    if(backend::gasnet::hier_barrier_enabled && &tm == &upcxx::world()) {
+      backend::gasnet::hier_barrier_inject(cb);
+      return;
+    }
+    
+    if(tm.base(detail::internal_only()).via_world) {
+      backend::gasnet::am_coll(tm, 0, true, true, nullptr, nullptr, 0, 0, 0, 0, nullptr, nullptr, cb);
+      return;
+    }
+    
     gex_Event_t e = gex_Coll_BarrierNB(backend::gasnet::handle_of(tm), 0);
     cb->handle = reinterpret_cast<std::uintptr_t>(e);
     backend::gasnet::register_cb(cb);
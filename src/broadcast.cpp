@@ -14,6 +14,11 @@ void detail::broadcast_trivial(
   ) {
   UPCXX_ASSERT(backend::master.active_with_caller());
   
+  if(tm.base(detail::internal_only()).via_world) {
+    gasnet::am_coll(tm, root, false, true, buf, buf, 1, size, 0, 0, nullptr, nullptr, cb);
+    return;
+  }
+  
   gex_Event_t e = gex_Coll_BroadcastNB(
     gasnet::handle_of(tm),
     root,
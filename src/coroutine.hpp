@@ -0,0 +1,225 @@
+#ifndef _407f7b4a_4e19_483f_8b6f_1d689cf1bbbb
+#define _407f7b4a_4e19_483f_8b6f_1d689cf1bbbb
+
+/* C++20 coroutine support.
+ *
+ * When the translation unit is compiled with C++20 coroutines available,
+ * UPCXX_COROUTINES is defined to 1 and:
+ *
+ *  - Any future is awaitable. `co_await fut` evaluates to what `fut.wait()`
+ *    would: nothing, `T`, or `std::tuple<T...>`. If `fut` is not ready the
+ *    coroutine suspends, and is later resumed as an lpc on the persona that
+ *    was current when it suspended. So it runs when that persona's owning
+ *    thread makes user-level progress, just like a `then` callback.
+ *
+ *  - `future<T...>` can be the return type of a coroutine. Such a coroutine
+ *    starts running immediately, and its future becomes ready with the value
+ *    of its `co_return`. Frames are allocated from the runtime's object cache
+ *    (upcxx/object_cache.hpp).
+ *
+ * Unlike a chain of `then`s, suspending on a future allocates nothing: the
+ * awaiter lives in the coroutine frame and contains the future header and
+ * lpc that the runtime needs to wake it. Exceptions escaping a coroutine
+ * terminate the program, and a coroutine must not be destroyed while it is
+ * suspended on a future.
+ */
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+  #define UPCXX_COROUTINES 1
+#else
+  #define UPCXX_COROUTINES 0
+#endif
+
+#if UPCXX_COROUTINES
+
+#include <upcxx/future.hpp>
+#include <upcxx/object_cache.hpp>
+#include <upcxx/persona.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+
+namespace upcxx {
+  namespace detail {
+    ////////////////////////////////////////////////////////////////////
+    // future_await_result: what `co_await` on a future<T...> evaluates to,
+    // taken from a ready result header. Values are moved out when the
+    // caller owns the only reference to them, and copied otherwise.
+
+    template<typename ...T>
+    struct future_await_result {
+      using type = std::tuple<T...>;
+
+      static type take(future_header *hdr, bool only_ref) {
+        std::tuple<T...> &results = future_header_result<T...>::results_of(hdr);
+        if(only_ref)
+          return type(std::move(results));
+        else
+          return type(results);
+      }
+    };
+
+    template<>
+    struct future_await_result<> {
+      using type = void;
+
+      static void take(future_header*, bool) {}
+    };
+
+    template<typename T>
+    struct future_await_result<T> {
+      using type = T;
+
+      static T take(future_header *hdr, bool only_ref) {
+        T &result = std::get<0>(future_header_result<T>::results_of(hdr));
+        if(only_ref)
+          return static_cast<typename std::conditional<std::is_reference<T>::value, T, T&&>::type>(result);
+        else
+          return result;
+      }
+    };
+
+    ////////////////////////////////////////////////////////////////////
+    // future_awaiter: Awaiter for future<T...>. While suspended it is the
+    // body of its own (never heap allocated) dependent header linked as a
+    // successor of the awaited future. When that future readies, the engine
+    // calls our `leave_active`, which queues `resume_` as a user-level lpc
+    // on the suspending persona.
+
+    template<typename ...T>
+    struct future_awaiter final: future_body {
+      using dep_type = future_dependency<future<T...>>;
+
+      struct resume_lpc: lpc_base {
+        std::coroutine_handle<> coro;
+
+        static void execute_and_delete(lpc_base *me) {
+          // the lpc lives in the coroutine frame, resuming reclaims it
+          static_cast<resume_lpc*>(me)->coro.resume();
+        }
+      };
+
+      static constexpr lpc_vtable resume_vtbl{&resume_lpc::execute_and_delete};
+
+      future<T...> fut_;
+      future_header_dependent hdr_;
+      typename std::aligned_storage<sizeof(dep_type), alignof(dep_type)>::type dep_raw_;
+      future_header *result_ = nullptr; // set once ready if we suspended
+      persona *per_;
+      resume_lpc resume_;
+
+      future_awaiter(future<T...> fut):
+        future_body(/*storage=*/nullptr),
+        fut_(std::move(fut)) {
+      }
+
+      future_awaiter(future_awaiter const&) = delete;
+
+      dep_type* dep_() {
+        return reinterpret_cast<dep_type*>(&dep_raw_);
+      }
+
+      bool await_ready() const {
+        return fut_.ready();
+      }
+
+      void await_suspend(std::coroutine_handle<> coro) {
+        per_ = &upcxx::current_persona();
+        resume_.vtbl = &resume_vtbl;
+        resume_.coro = coro;
+
+        hdr_.body_ = this;
+        ::new(&dep_raw_) dep_type(&hdr_, std::move(fut_));
+
+        if(hdr_.status_ == future_header::status_active)
+          hdr_.entered_active();
+      }
+
+      void leave_active(future_header_dependent *hdr) {
+        hdr->decref(1); // left active queue, our own reference remains
+
+        result_ = dep_()->cleanup_ready_get_header();
+        dep_()->~dep_type();
+
+        detail::the_persona_tls.enqueue(*per_, progress_level::user, &resume_);
+      }
+
+      typename future_await_result<T...>::type await_resume() {
+        if(result_ == nullptr) // never suspended
+          return future_await_result<T...>::take(fut_.impl_.hdr_->result_, /*only_ref=*/false);
+
+        struct drop_result {
+          future_header *hdr;
+          ~drop_result() {
+            future_header_ops_result_ready::template dropref<T...>(hdr, /*maybe_nil=*/std::false_type());
+          }
+        } dropper{result_};
+
+        return future_await_result<T...>::take(result_, result_->ref_n_ == 1);
+      }
+    };
+
+    template<typename ...T>
+    constexpr lpc_vtable future_awaiter<T...>::resume_vtbl;
+
+    ////////////////////////////////////////////////////////////////////
+    // future_coro_promise: promise_type of coroutines returning future<T...>
+
+    template<typename ...T>
+    struct future_coro_promise_base {
+      upcxx::promise<T...> pro_;
+
+      static void* operator new(std::size_t size) {
+        return detail::object_alloc(size);
+      }
+      static void operator delete(void *p) {
+        detail::object_free(p);
+      }
+
+      future<T...> get_return_object() {
+        return pro_.get_future();
+      }
+
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+
+      void unhandled_exception() { std::terminate(); }
+    };
+
+    template<typename ...T>
+    struct future_coro_promise: future_coro_promise_base<T...> {
+      void return_value(std::tuple<T...> values) {
+        this->pro_.fulfill_result(std::move(values));
+      }
+    };
+
+    template<>
+    struct future_coro_promise<>: future_coro_promise_base<> {
+      void return_void() {
+        this->pro_.fulfill_anonymous(1);
+      }
+    };
+
+    template<typename T>
+    struct future_coro_promise<T>: future_coro_promise_base<T> {
+      void return_value(T value) {
+        this->pro_.fulfill_result(std::forward<T>(value));
+      }
+    };
+  }
+
+  template<typename Kind, typename ...T>
+  detail::future_awaiter<T...> operator co_await(future1<Kind,T...> fut) {
+    return detail::future_awaiter<T...>(std::move(fut));
+  }
+}
+
+template<typename ...T, typename ...Arg>
+struct std::coroutine_traits<upcxx::future<T...>, Arg...> {
+  using promise_type = upcxx::detail::future_coro_promise<T...>;
+};
+
+#endif // UPCXX_COROUTINES
+#endif
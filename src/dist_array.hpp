@@ -0,0 +1,450 @@
+#ifndef _e3a1d9c4_72b8_4f5a_9d06_b41c8e7f2a53
+#define _e3a1d9c4_72b8_4f5a_9d06_b41c8e7f2a53
+
+#include <upcxx/allocate.hpp>
+#include <upcxx/barrier.hpp>
+#include <upcxx/dist_object.hpp>
+#include <upcxx/future.hpp>
+#include <upcxx/global_ptr.hpp>
+#include <upcxx/team.hpp>
+#include <upcxx/vis.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/* upcxx::dist_array<T, Dim>: A Dim-dimensional array of T distributed over a
+ * team arranged as a Dim-dimensional process grid, in a block or
+ * block-cyclic layout, with optional ghost cells.
+ *
+ * The global index space [0, extent) is cut into tiles of `block` elements
+ * per dimension (the last ones possibly partial). Tile t goes to the rank at
+ * grid coordinates t % procs. With block = ceil(extent/procs) every rank has
+ * one tile, which is the plain block layout. Ranks are numbered over the
+ * process grid in row-major order, and elements within a tile likewise
+ * (the last dimension is contiguous).
+ *
+ * A rank keeps all of its tiles in one shared-segment allocation. Each tile
+ * is padded by `ghost` cells on every face, and `local_tile(i)` views it by
+ * global indices, ghosts included. `exchange()` fills the ghost faces from
+ * the neighbouring tiles (wrapping around if `periodic`). Edge and corner
+ * ghosts are not filled, which suits 5- and 7-point style stencils.
+ *
+ * The exchange is planned once by the constructor. Each (tile, face) pair
+ * becomes a precomputed strided copy: a source pointer, a destination
+ * global_ptr and extents, with strides shared by all tiles. Each exchange
+ * replays the plan. Faces whose destination is in local_team() are copied
+ * with memcpy, and the rest are issued as rput_strided's, all completing
+ * into a single promise.
+ *
+ * Construction is collective over the team and ends with a barrier.
+ * Destruction is collective too, and must not overlap an exchange of
+ * another rank. T must be TriviallySerializable.
+ */
+
+namespace upcxx {
+  template<typename T, int Dim>
+  class dist_array {
+    static_assert(Dim >= 1, "dist_array needs at least one dimension.");
+    static_assert(is_trivially_serializable<T>::value,
+      "dist_array elements must be TriviallySerializable.");
+
+  public:
+    using index_type = std::array<std::ptrdiff_t, Dim>;
+    using extents_type = std::array<std::size_t, Dim>;
+    using grid_type = std::array<intrank_t, Dim>;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // tile: One tile of this rank, addressed by global index. Indices may
+    // stray `ghost` cells outside [lo, hi) in each dimension.
+
+    class tile {
+      friend class dist_array;
+
+      T *origin_; // element at global index lo()
+      index_type lo_, hi_;
+      index_type stride_; // in elements
+
+    public:
+      index_type const& lo() const { return lo_; }
+      index_type const& hi() const { return hi_; }
+
+      std::size_t size() const {
+        std::size_t n = 1;
+        for(int d=0; d < Dim; d++)
+          n *= std::size_t(hi_[d] - lo_[d]);
+        return n;
+      }
+
+      T& operator[](index_type const &i) const {
+        std::ptrdiff_t off = 0;
+        for(int d=0; d < Dim; d++)
+          off += (i[d] - lo_[d])*stride_[d];
+        return origin_[off];
+      }
+
+      template<typename ...I>
+      T& operator()(I ...i) const {
+        static_assert(sizeof...(I) == Dim, "Wrong number of indices.");
+        return (*this)[index_type{{std::ptrdiff_t(i)...}}];
+      }
+
+      // Element strides within the tile's padded storage.
+      index_type const& strides() const { return stride_; }
+    };
+
+  private:
+    // One ghost face to fill, strides and dimension order as rput_strided
+    // takes them (fastest varying first).
+    struct face {
+      T *src;
+      global_ptr<T> dst;
+      std::array<std::size_t, Dim> extent;
+    };
+
+    upcxx::team const *tm_;
+    extents_type extent_, block_;
+    grid_type procs_;
+    std::size_t ghost_;
+    bool periodic_;
+
+    extents_type tiles_total_; // per dimension, over all ranks
+    grid_type me_at_; // my coordinates in the process grid
+    extents_type my_tiles_; // per dimension
+    std::size_t my_tile_n_;
+
+    index_type pad_stride_; // element strides of a padded tile, row-major
+    std::size_t tile_elts_; // elements in a padded tile
+
+    global_ptr<T> mine_;
+    dist_object<global_ptr<T>> bases_;
+
+    std::array<std::ptrdiff_t, Dim> face_strides_; // bytes, fastest first
+    std::vector<face> faces_;
+
+    static std::size_t ceil_div(std::size_t a, std::size_t b) {
+      return (a + b - 1)/b;
+    }
+
+    grid_type grid_of(intrank_t rank) const {
+      grid_type at;
+      for(int d=Dim-1; d >= 0; d--) {
+        at[d] = rank % procs_[d];
+        rank /= procs_[d];
+      }
+      return at;
+    }
+
+    intrank_t rank_of(grid_type const &at) const {
+      intrank_t rank = 0;
+      for(int d=0; d < Dim; d++)
+        rank = rank*procs_[d] + at[d];
+      return rank;
+    }
+
+    // Tiles along dimension `d` held by ranks at grid coordinate `p`.
+    std::size_t tiles_along(int d, intrank_t p) const {
+      return std::size_t(p) < tiles_total_[d]
+        ? ceil_div(tiles_total_[d] - p, procs_[d])
+        : 0;
+    }
+
+    // Offset of global tile `t` within its owner's allocation.
+    std::size_t tile_offset(extents_type const &t) const {
+      grid_type at;
+      for(int d=0; d < Dim; d++)
+        at[d] = intrank_t(t[d] % procs_[d]);
+
+      std::size_t local = 0;
+      for(int d=0; d < Dim; d++)
+        local = local*tiles_along(d, at[d]) + t[d]/procs_[d];
+      return local*tile_elts_;
+    }
+
+    // Offset within a padded tile of the element at padded coordinates `p`.
+    std::size_t padded_offset(extents_type const &p) const {
+      std::size_t off = 0;
+      for(int d=0; d < Dim; d++)
+        off += p[d]*pad_stride_[d];
+      return off;
+    }
+
+    std::size_t tile_extent(int d, std::size_t t) const {
+      std::size_t lo = t*block_[d];
+      return std::min(block_[d], extent_[d] - lo);
+    }
+
+    extents_type my_global_tile(std::size_t i) const {
+      extents_type t;
+      for(int d=Dim-1; d >= 0; d--) {
+        t[d] = (i % my_tiles_[d])*procs_[d] + me_at_[d];
+        i /= my_tiles_[d];
+      }
+      return t;
+    }
+
+    void plan_exchange();
+
+    static void copy_face(T *dst, T const *src, std::array<std::size_t, Dim> const &ext,
+                          std::array<std::ptrdiff_t, Dim> const &stride_bytes);
+
+  public:
+    // Block-cyclic layout with tiles of `block` elements per dimension.
+    dist_array(const upcxx::team &tm, extents_type extent, grid_type procs,
+               extents_type block, std::size_t ghost = 0, bool periodic = false);
+
+    // Block layout over the world: one tile per rank.
+    dist_array(extents_type extent, grid_type procs,
+               std::size_t ghost = 0, bool periodic = false):
+      dist_array(upcxx::world(), extent, procs,
+                 [&]() {
+                   extents_type b;
+                   for(int d=0; d < Dim; d++)
+                     b[d] = ceil_div(extent[d], procs[d]);
+                   return b;
+                 }(),
+                 ghost, periodic) {
+    }
+
+    dist_array(dist_array const&) = delete;
+
+    ~dist_array() {
+      if(mine_)
+        upcxx::delete_array(mine_);
+    }
+
+    upcxx::team& team() const { return *const_cast<upcxx::team*>(tm_); }
+
+    extents_type const& extent() const { return extent_; }
+    extents_type const& block() const { return block_; }
+    grid_type const& procs() const { return procs_; }
+    std::size_t ghost() const { return ghost_; }
+
+    intrank_t owner(index_type const &i) const {
+      grid_type at;
+      for(int d=0; d < Dim; d++)
+        at[d] = intrank_t((std::size_t(i[d])/block_[d]) % procs_[d]);
+      return rank_of(at);
+    }
+
+    std::size_t tile_n() const { return my_tile_n_; }
+
+    tile local_tile(std::size_t i) const {
+      extents_type t = my_global_tile(i);
+      extents_type p;
+      tile ans;
+      for(int d=0; d < Dim; d++) {
+        ans.lo_[d] = std::ptrdiff_t(t[d]*block_[d]);
+        ans.hi_[d] = ans.lo_[d] + std::ptrdiff_t(tile_extent(d, t[d]));
+        p[d] = ghost_;
+      }
+      ans.stride_ = pad_stride_;
+      ans.origin_ = mine_.local() + i*tile_elts_ + padded_offset(p);
+      return ans;
+    }
+
+    // Pointer to global element `i` if this rank owns it, else null.
+    T* local_ptr(index_type const &i) const {
+      if(owner(i) != tm_->rank_me())
+        return nullptr;
+
+      extents_type t, p;
+      for(int d=0; d < Dim; d++) {
+        t[d] = std::size_t(i[d])/block_[d];
+        p[d] = std::size_t(i[d]) - t[d]*block_[d] + ghost_;
+      }
+      return mine_.local() + tile_offset(t) + padded_offset(p);
+    }
+
+    // Fills this rank's neighbours' ghost cells from its tiles. The future
+    // readies once this rank's part is done, so a barrier is still needed
+    // before reading ghosts or writing tiles again.
+    future<> exchange_async();
+
+    // Barrier, exchange_async().wait(), barrier.
+    void exchange() {
+      upcxx::barrier(*tm_);
+      exchange_async().wait();
+      upcxx::barrier(*tm_);
+    }
+  };
+
+  template<typename T, int Dim>
+  dist_array<T,Dim>::dist_array(
+      const upcxx::team &tm, extents_type extent, grid_type procs,
+      extents_type block, std::size_t ghost, bool periodic
+    ):
+    tm_(&tm),
+    extent_(extent),
+    block_(block),
+    procs_(procs),
+    ghost_(ghost),
+    periodic_(periodic),
+    bases_(tm, global_ptr<T>()) {
+
+    intrank_t grid_n = 1;
+    for(int d=0; d < Dim; d++) {
+      UPCXX_ASSERT_ALWAYS(procs_[d] > 0 && block_[d] > 0 && extent_[d] > 0,
+        "dist_array: extents, block sizes and process grid must be positive");
+      grid_n *= procs_[d];
+    }
+    UPCXX_ASSERT_ALWAYS(grid_n == tm.rank_n(),
+      "dist_array: process grid holds " << grid_n << " ranks but team has " << tm.rank_n());
+
+    me_at_ = grid_of(tm.rank_me());
+    my_tile_n_ = 1;
+    tile_elts_ = 1;
+    for(int d=Dim-1; d >= 0; d--) {
+      tiles_total_[d] = ceil_div(extent_[d], block_[d]);
+      my_tiles_[d] = tiles_along(d, me_at_[d]);
+      my_tile_n_ *= my_tiles_[d];
+
+      UPCXX_ASSERT_ALWAYS(ghost_ <= tile_extent(d, tiles_total_[d]-1),
+        "dist_array: ghost width exceeds the extent of a tile");
+
+      pad_stride_[d] = std::ptrdiff_t(tile_elts_);
+      tile_elts_ *= block_[d] + 2*ghost_;
+    }
+
+    mine_ = my_tile_n_ != 0 ? upcxx::new_array<T>(my_tile_n_*tile_elts_) : global_ptr<T>();
+    *bases_ = mine_;
+
+    if(ghost_ != 0) {
+      // bases_ exists before it holds our allocation, so fetches must wait
+      upcxx::barrier(tm);
+      plan_exchange();
+    }
+
+    // neighbours may still be fetching our base
+    upcxx::barrier(tm);
+  }
+
+  template<typename T, int Dim>
+  void dist_array<T,Dim>::plan_exchange() {
+    for(int k=0; k < Dim; k++)
+      face_strides_[k] = pad_stride_[Dim-1-k]*std::ptrdiff_t(sizeof(T));
+
+    std::unordered_map<intrank_t, future<global_ptr<T>>> base_of;
+
+    struct pending {
+      std::size_t src_off;
+      intrank_t rank;
+      std::size_t dst_off;
+      std::array<std::size_t, Dim> extent;
+    };
+    std::vector<pending> todo;
+
+    for(std::size_t i=0; i < my_tile_n_; i++) {
+      extents_type t = my_global_tile(i);
+
+      for(int d=0; d < Dim; d++) {
+        for(int side: {-1, +1}) {
+          extents_type nt = t;
+          if(side < 0 && t[d] == 0) {
+            if(!periodic_) continue;
+            nt[d] = tiles_total_[d] - 1;
+          }
+          else if(side > 0 && t[d] == tiles_total_[d]-1) {
+            if(!periodic_) continue;
+            nt[d] = 0;
+          }
+          else
+            nt[d] = t[d] + side;
+
+          // Our `ghost` layers nearest the neighbour go to its ghost face on
+          // the far side. Other dimensions cover our interior, which is also
+          // the neighbour's since tiles line up.
+          extents_type src_at, dst_at;
+          std::array<std::size_t, Dim> ext;
+          for(int e=0; e < Dim; e++) {
+            src_at[e] = dst_at[e] = ghost_;
+            ext[Dim-1-e] = tile_extent(e, t[e]);
+          }
+          ext[Dim-1-d] = ghost_;
+
+          if(side < 0)
+            dst_at[d] = ghost_ + tile_extent(d, nt[d]);
+          else {
+            src_at[d] = ghost_ + tile_extent(d, t[d]) - ghost_;
+            dst_at[d] = 0;
+          }
+
+          grid_type at;
+          for(int e=0; e < Dim; e++)
+            at[e] = intrank_t(nt[e] % procs_[e]);
+          intrank_t rank = rank_of(at);
+
+          if(base_of.count(rank) == 0) {
+            if(rank == tm_->rank_me())
+              base_of[rank] = make_future(mine_);
+            else
+              base_of[rank] = bases_.fetch(rank);
+          }
+
+          todo.push_back(pending{
+            i*tile_elts_ + padded_offset(src_at),
+            rank,
+            tile_offset(nt) + padded_offset(dst_at),
+            ext
+          });
+        }
+      }
+    }
+
+    faces_.reserve(todo.size());
+    for(pending const &p: todo) {
+      global_ptr<T> base = base_of[p.rank].wait();
+      faces_.push_back(face{mine_.local() + p.src_off, base + p.dst_off, p.extent});
+    }
+  }
+
+  template<typename T, int Dim>
+  void dist_array<T,Dim>::copy_face(
+      T *dst, T const *src, std::array<std::size_t, Dim> const &ext,
+      std::array<std::ptrdiff_t, Dim> const &stride_bytes
+    ) {
+    // ext[0] runs are contiguous, odometer over the rest
+    std::size_t run = ext[0]*sizeof(T);
+    std::array<std::size_t, Dim> at{};
+    char *d = reinterpret_cast<char*>(dst);
+    char const *s = reinterpret_cast<char const*>(src);
+
+    while(true) {
+      std::memcpy(d, s, run);
+
+      int k = 1;
+      for(; k < Dim; k++) {
+        d += stride_bytes[k];
+        s += stride_bytes[k];
+        if(++at[k] < ext[k])
+          break;
+        d -= stride_bytes[k]*std::ptrdiff_t(ext[k]);
+        s -= stride_bytes[k]*std::ptrdiff_t(ext[k]);
+        at[k] = 0;
+      }
+      if(k == Dim)
+        return;
+    }
+  }
+
+  template<typename T, int Dim>
+  future<> dist_array<T,Dim>::exchange_async() {
+    promise<> pro;
+
+    for(face const &f: faces_) {
+      if(f.dst.is_local())
+        copy_face(f.dst.local(), f.src, f.extent, face_strides_);
+      else
+        upcxx::rput_strided<Dim>(
+          f.src, face_strides_, f.dst, face_strides_, f.extent,
+          operation_cx::as_promise(pro)
+        );
+    }
+
+    return pro.finalize();
+  }
+}
+#endif
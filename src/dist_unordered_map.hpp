@@ -0,0 +1,448 @@
+#ifndef _c47e2a19_6b3d_4f08_a5e1_3d9b72f0c864
+#define _c47e2a19_6b3d_4f08_a5e1_3d9b72f0c864
+
+#include <upcxx/dist_object.hpp>
+#include <upcxx/future.hpp>
+#include <upcxx/persona.hpp>
+#include <upcxx/rpc.hpp>
+#include <upcxx/team.hpp>
+#include <upcxx/utility.hpp>
+#include <upcxx/view.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/* upcxx::dist_unordered_map<Key, T, Hash, KeyEqual>: A hash map partitioned
+ * across the ranks of a team, key `k` living on rank `Hash()(k) % rank_n`.
+ *
+ * Construction and destruction are collective over the team, and like
+ * dist_object the map may only be used with the master persona. Because
+ * destruction frees this rank's shard while peers may still be sending to
+ * it, every rank must `flush()`, see its operations complete (futures
+ * readied, rpc_ff quiescence arranged), and then barrier before destroying
+ * the map. Destroying it with operations still batched is an error.
+ *
+ * Operations on remote keys are not sent one per rpc. `insert`, `insert_ff`
+ * and `find` append to a per-destination batch, and a batch goes out as one
+ * rpc when it holds `batch_n` operations, when `flush()` is called, or at
+ * the next user-level progress of the master persona, whichever comes
+ * first. So a loop issuing operations without making progress is
+ * aggregated, and waiting on any of their futures ships them.
+ *
+ * - `insert(k, v)` returns a future readied once (k, v) is in its shard.
+ *   Like std::unordered_map::insert, an existing mapping is not replaced.
+ * - `insert_ff(k, v)` is the same without completion notification. As
+ *   with rpc_ff, the application arranges its own quiescence.
+ * - `find(k)` returns a `future<bool, T>`: whether k was found, and its value
+ *   (or a default constructed T). Operations from one rank to another are
+ *   not ordered, so a find only sees inserts whose futures have readied.
+ *
+ * Each shard is an open-addressing table of (Key, T) pairs, reached with
+ * `local()`, which can be iterated and queried without communication.
+ */
+
+namespace upcxx {
+  //////////////////////////////////////////////////////////////////////////////
+  // dist_unordered_map_shard: One rank's part of the map. Linear probing over
+  // slots holding a hash tag (zero when empty) next to the pair, grown to keep
+  // the load at most 3/4.
+
+  template<typename Key, typename T,
+           typename Hash = std::hash<Key>,
+           typename KeyEqual = std::equal_to<Key>>
+  class dist_unordered_map_shard {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+
+  private:
+    struct slot {
+      std::uint64_t tag;
+      detail::raw_storage<value_type> kv;
+    };
+
+    slot *slots_ = nullptr;
+    std::size_t mask_ = 0; // capacity - 1, or 0 when nothing allocated
+    std::size_t size_ = 0;
+    int shift_ = 64;
+    Hash hash_;
+    KeyEqual eq_;
+
+    static std::uint64_t tag_of(std::uint64_t h) {
+      return h | 1; // never zero
+    }
+
+    std::size_t home_of(std::uint64_t tag) const {
+      // Fibonacci hashing takes the high bits, which stay well spread even
+      // though every key here has the same `hash % rank_n`.
+      return std::size_t((tag * 0x9e3779b97f4a7c15ull) >> shift_);
+    }
+
+    slot* probe(Key const &k, std::uint64_t tag) const {
+      std::size_t i = home_of(tag);
+      while(true) {
+        slot *s = &slots_[i];
+        if(s->tag == 0 || (s->tag == tag && eq_(s->kv.value().first, k)))
+          return s;
+        i = (i + 1) & mask_;
+      }
+    }
+
+    void rehash(std::size_t cap) {
+      slot *old = slots_;
+      std::size_t old_cap = old ? mask_ + 1 : 0;
+
+      slots_ = static_cast<slot*>(std::malloc(cap*sizeof(slot)));
+      UPCXX_ASSERT_ALWAYS(slots_ != nullptr, "dist_unordered_map shard out of memory");
+      for(std::size_t i=0; i < cap; i++)
+        slots_[i].tag = 0;
+      mask_ = cap - 1;
+      shift_ = 64;
+      for(std::size_t c = cap; c > 1; c >>= 1)
+        shift_ -= 1;
+
+      for(std::size_t i=0; i < old_cap; i++) {
+        if(old[i].tag != 0) {
+          slot *s = probe(old[i].kv.value().first, old[i].tag);
+          s->tag = old[i].tag;
+          ::new(&s->kv) value_type(old[i].kv.value_and_destruct());
+        }
+      }
+      std::free(old);
+    }
+
+  public:
+    class const_iterator {
+      friend class dist_unordered_map_shard;
+      slot const *s_, *end_;
+
+      const_iterator(slot const *s, slot const *end): s_(s), end_(end) {
+        while(s_ != end_ && s_->tag == 0) ++s_;
+      }
+
+    public:
+      using difference_type = std::ptrdiff_t;
+      using value_type = dist_unordered_map_shard::value_type;
+      using pointer = value_type const*;
+      using reference = value_type const&;
+      using iterator_category = std::forward_iterator_tag;
+
+      const_iterator(): s_(nullptr), end_(nullptr) {}
+
+      reference operator*() const { return const_cast<slot*>(s_)->kv.value(); }
+      pointer operator->() const { return &**this; }
+
+      const_iterator& operator++() {
+        do ++s_; while(s_ != end_ && s_->tag == 0);
+        return *this;
+      }
+      const_iterator operator++(int) {
+        const_iterator old = *this;
+        ++*this;
+        return old;
+      }
+
+      friend bool operator==(const_iterator a, const_iterator b) { return a.s_ == b.s_; }
+      friend bool operator!=(const_iterator a, const_iterator b) { return a.s_ != b.s_; }
+    };
+
+    dist_unordered_map_shard(Hash hash = Hash(), KeyEqual eq = KeyEqual()):
+      hash_(std::move(hash)),
+      eq_(std::move(eq)) {
+    }
+    dist_unordered_map_shard(dist_unordered_map_shard const&) = delete;
+
+    dist_unordered_map_shard(dist_unordered_map_shard &&that) noexcept:
+      slots_(that.slots_), mask_(that.mask_), size_(that.size_), shift_(that.shift_),
+      hash_(std::move(that.hash_)), eq_(std::move(that.eq_)) {
+      that.slots_ = nullptr;
+      that.mask_ = 0;
+      that.size_ = 0;
+    }
+
+    ~dist_unordered_map_shard() {
+      clear();
+      std::free(slots_);
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const {
+      return slots_ ? const_iterator(slots_, slots_ + mask_ + 1) : const_iterator();
+    }
+    const_iterator end() const {
+      return slots_ ? const_iterator(slots_ + mask_ + 1, slots_ + mask_ + 1) : const_iterator();
+    }
+
+    // Pointer to the value mapped to `k`, or null.
+    T* find(Key const &k) {
+      if(size_ == 0)
+        return nullptr;
+      slot *s = probe(k, tag_of(hash_(k)));
+      return s->tag != 0 ? &s->kv.value().second : nullptr;
+    }
+    T const* find(Key const &k) const {
+      return const_cast<dist_unordered_map_shard*>(this)->find(k);
+    }
+
+    // Returns false, leaving the old value, if `k` is already present.
+    template<typename K1, typename T1>
+    bool insert(K1 &&k, T1 &&val) {
+      if(slots_ == nullptr)
+        rehash(16);
+
+      std::uint64_t tag = tag_of(hash_(k));
+      slot *s = probe(k, tag);
+      if(s->tag != 0)
+        return false;
+
+      if(4*(size_ + 1) > 3*(mask_ + 1)) {
+        rehash(2*(mask_ + 1));
+        s = probe(k, tag);
+      }
+
+      ::new(&s->kv) value_type(std::forward<K1>(k), std::forward<T1>(val));
+      s->tag = tag;
+      size_ += 1;
+      return true;
+    }
+
+    void clear() {
+      if(slots_ == nullptr)
+        return;
+      for(std::size_t i=0; i <= mask_; i++) {
+        if(slots_[i].tag != 0) {
+          slots_[i].kv.destruct();
+          slots_[i].tag = 0;
+        }
+      }
+      size_ = 0;
+    }
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  // dist_unordered_map
+
+  template<typename Key, typename T,
+           typename Hash = std::hash<Key>,
+           typename KeyEqual = std::equal_to<Key>>
+  class dist_unordered_map {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using shard_type = dist_unordered_map_shard<Key, T, Hash, KeyEqual>;
+
+  private:
+    using dobj_t = dist_object<shard_type>;
+
+    struct insert_batch {
+      std::vector<std::pair<Key, T>> kvs;
+      promise<> *acked = nullptr; // present if any insert wants a future
+    };
+
+    struct find_batch {
+      std::vector<Key> keys;
+      std::vector<promise<bool, T>> found;
+    };
+
+    // Outgoing batches live apart from the map so the lpc that flushes
+    // them at the next progress can tell whether the map is still alive.
+    struct outbox {
+      dist_unordered_map *map;
+      std::vector<insert_batch> inserts;
+      std::vector<find_batch> finds;
+      std::vector<intrank_t> dirty; // ranks with batches since the last flush
+      std::vector<char> is_dirty;
+      bool flush_queued = false;
+    };
+
+    struct fulfill_finds {
+      std::vector<promise<bool, T>> found;
+
+      void operator()(std::vector<std::pair<bool, T>> const &results) {
+        for(std::size_t i=0; i < found.size(); i++)
+          found[i].fulfill_result(results[i].first, results[i].second);
+      }
+    };
+
+    dobj_t shards_;
+    intrank_t rank_n_;
+    std::size_t batch_n_;
+    Hash hash_;
+    std::shared_ptr<outbox> out_;
+
+    void note_dirty(intrank_t rank) {
+      UPCXX_ASSERT(master_persona().active_with_caller(),
+        "dist_unordered_map may only be used with the master persona");
+
+      outbox &o = *out_;
+      if(!o.is_dirty[rank]) {
+        o.is_dirty[rank] = 1;
+        o.dirty.push_back(rank);
+      }
+
+      if(!o.flush_queued) {
+        o.flush_queued = true;
+        std::shared_ptr<outbox> keep = out_;
+        master_persona().lpc_ff([=]() {
+          keep->flush_queued = false;
+          if(keep->map)
+            keep->map->flush();
+        });
+      }
+    }
+
+    void send_inserts(intrank_t rank) {
+      insert_batch &b = out_->inserts[rank];
+      if(b.kvs.empty())
+        return;
+
+      auto insert_all = [](dobj_t &shard, view<std::pair<Key, T>> kvs) {
+        for(std::pair<Key, T> kv: kvs)
+          shard->insert(std::move(kv.first), std::move(kv.second));
+      };
+
+      if(b.acked != nullptr) {
+        upcxx::rpc(shards_.team(), rank, operation_cx::as_promise(*b.acked),
+            insert_all, shards_, make_view(b.kvs));
+        b.acked->finalize();
+        delete b.acked;
+        b.acked = nullptr;
+      }
+      else
+        upcxx::rpc_ff(shards_.team(), rank, insert_all, shards_, make_view(b.kvs));
+
+      b.kvs.clear();
+    }
+
+    void send_finds(intrank_t rank) {
+      find_batch &b = out_->finds[rank];
+      if(b.keys.empty())
+        return;
+
+      upcxx::rpc(shards_.team(), rank,
+          [](dobj_t &shard, view<Key> keys) {
+            std::vector<std::pair<bool, T>> results;
+            results.reserve(keys.size());
+            for(Key const &k: keys) {
+              T const *v = shard->find(k);
+              if(v)
+                results.emplace_back(true, *v);
+              else
+                results.emplace_back(false, T());
+            }
+            return results;
+          },
+          shards_, make_view(b.keys)
+        ).then(fulfill_finds{std::move(b.found)});
+
+      b.keys.clear();
+      b.found.clear();
+    }
+
+  public:
+    // Collective over `tm`. Each destination's batch is sent once it holds
+    // `batch_n` operations.
+    dist_unordered_map(const upcxx::team &tm = upcxx::world(),
+                       std::size_t batch_n = 256,
+                       Hash hash = Hash(), KeyEqual eq = KeyEqual()):
+      shards_(tm, hash, eq),
+      rank_n_(tm.rank_n()),
+      batch_n_(batch_n < 1 ? 1 : batch_n),
+      hash_(std::move(hash)),
+      out_(new outbox) {
+      out_->map = this;
+      out_->inserts.resize(tm.rank_n());
+      out_->finds.resize(tm.rank_n());
+      out_->is_dirty.resize(tm.rank_n(), 0);
+    }
+
+    dist_unordered_map(dist_unordered_map const&) = delete;
+
+    // Collective. See the header comment for what must precede it.
+    ~dist_unordered_map() {
+      UPCXX_ASSERT(!pending(),
+        "dist_unordered_map destroyed with unsent operations, flush() and barrier first");
+      out_->map = nullptr;
+    }
+
+    upcxx::team& team() { return shards_.team(); }
+
+    intrank_t owner_of(Key const &k) const {
+      return intrank_t(hash_(k) % std::size_t(rank_n_));
+    }
+
+    // This rank's shard.
+    shard_type& local() { return *shards_; }
+    shard_type const& local() const { return *shards_; }
+
+    future<> insert(Key const &k, T const &val) {
+      intrank_t rank = owner_of(k);
+      note_dirty(rank);
+
+      insert_batch &b = out_->inserts[rank];
+      if(b.acked == nullptr)
+        b.acked = new promise<>;
+      b.kvs.emplace_back(k, val);
+      future<> ans = b.acked->get_future();
+
+      if(b.kvs.size() >= batch_n_)
+        send_inserts(rank);
+      return ans;
+    }
+
+    void insert_ff(Key const &k, T const &val) {
+      intrank_t rank = owner_of(k);
+      note_dirty(rank);
+
+      insert_batch &b = out_->inserts[rank];
+      b.kvs.emplace_back(k, val);
+
+      if(b.kvs.size() >= batch_n_)
+        send_inserts(rank);
+    }
+
+    future<bool, T> find(Key const &k) {
+      intrank_t rank = owner_of(k);
+      note_dirty(rank);
+
+      find_batch &b = out_->finds[rank];
+      b.keys.push_back(k);
+      b.found.emplace_back();
+      future<bool, T> ans = b.found.back().get_future();
+
+      if(b.keys.size() >= batch_n_)
+        send_finds(rank);
+      return ans;
+    }
+
+    // Whether any operation is batched but not yet sent.
+    bool pending() const {
+      for(intrank_t rank: out_->dirty) {
+        if(!out_->inserts[rank].kvs.empty() || !out_->finds[rank].keys.empty())
+          return true;
+      }
+      return false;
+    }
+
+    // Sends every pending batch now.
+    void flush() {
+      for(intrank_t rank: out_->dirty) {
+        send_inserts(rank);
+        send_finds(rank);
+        out_->is_dirty[rank] = 0;
+      }
+      out_->dirty.clear();
+    }
+  };
+}
+#endif
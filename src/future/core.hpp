@@ -5,31 +5,18 @@
 
 #include <upcxx/diagnostic.hpp>
 #include <upcxx/lpc.hpp>
+#include <upcxx/object_cache.hpp>
 #include <upcxx/utility.hpp>
 
 #include <cstddef>
 #include <new>
 
-/* Place this macro in a class definition to give it overrides of operator
- * new/delete that just call the language provided defaults. This might seem
- * pointless now, but if we ever customize our own allocator we'll need
- * something like this slapped on all of our classes (except it won't just
- * call the std defaults). The reason we're doing this here (and now) is because
- * there is code in "./core.cpp" that wants to delete `void*` storage which it
- * *knows* must have been allocated for a `future_body`. Without these stubs,
- * calling `future_body::operator delete(x)` would be invalid. Adding these
- * stubs seems better than dumbing down offending code to always call the generic
- * deallocate, which if we get custom allocation might be slower or just wrong.
+/* Every header and body class carries UPCXX_OPNEW_CACHED so their blocks
+ * come from the runtime's object cache (upcxx/object_cache.hpp). There is
+ * code in "./core.cpp" that wants to delete `void*` storage which it *knows*
+ * must have been allocated for a `future_body`, which is why these are class
+ * overrides instead of calls to a generic deallocate.
  */
-#ifndef UPCXX_OPNEW_AS_STD // pretty sure not defined anywhere, just thinking ahead.
-  #define UPCXX_OPNEW_AS_STD \
-    static void* operator new(std::size_t size) {\
-      return ::operator new(size);\
-    }\
-    static void operator delete(void *p) {\
-      ::operator delete(p);\
-    }
-#endif
 
 #if __PGI // TODO: range of impacted versions and/or C++ standard?
   // Work around a bug leading to nullptr initialization for a function pointer
@@ -43,7 +30,7 @@ namespace upcxx {
     // future headers...
   
     struct future_header {
-      UPCXX_OPNEW_AS_STD
+      UPCXX_OPNEW_CACHED
       
       // Our refcount. A negative value indicates a static lifetime.
       int ref_n_;
@@ -294,7 +281,7 @@ namespace upcxx {
     
     // Base type for all future bodies.
     struct future_body {
-      UPCXX_OPNEW_AS_STD
+      UPCXX_OPNEW_CACHED
       
       // The memory block holding this body. Managed by future_body::operator new/delete().
       void *storage_;
@@ -337,7 +324,7 @@ namespace upcxx {
     
     template<typename ...T>
     struct future_header_result {
-      UPCXX_OPNEW_AS_STD
+      UPCXX_OPNEW_CACHED
       
       future_header base_header;
       
@@ -444,7 +431,7 @@ namespace upcxx {
     
     template<>
     struct future_header_result<> {
-      UPCXX_OPNEW_AS_STD
+      UPCXX_OPNEW_CACHED
       
       static future_header the_always;
       
@@ -562,7 +549,7 @@ namespace upcxx {
     // The future header of a promise.
     template<typename ...T>
     struct future_header_promise {
-      UPCXX_OPNEW_AS_STD
+      UPCXX_OPNEW_CACHED
       
       // We "inherit" from future_header_result<T...> use "first member of standard
       // layout" since real inheritance would break standard layout.
@@ -52,12 +52,14 @@ namespace upcxx {
   namespace detail {
     #ifdef UPCXX_BACKEND
       struct future_wait_upcxx_progress_user {
+        mutable int idle_ = 0; // consecutive fruitless progress passes
+        
         void operator()() const {
           UPCXX_ASSERT(
             -1 == detail::progressing(),
             "You have attempted to wait() on a non-ready future within upcxx progress, this is prohibited because it will never complete."
           );
-          upcxx::progress();
+          detail::progress_wait(idle_);
         }
       };
     #endif
@@ -5,6 +5,9 @@
 #include <upcxx/future/body_pure.hpp>
 #include <upcxx/utility.hpp>
 
+#include <cstddef>
+#include <vector>
+
 namespace upcxx {
   //////////////////////////////////////////////////////////////////////
   // future_is_trivially_ready: future_impl_when_all specialization
@@ -225,6 +228,133 @@ namespace upcxx {
         return hdr;
       }
     };
+    
+    //////////////////////////////////////////////////////////////////////
+    // when_all_range_result: Result type of `when_all(begin, end)` given
+    // the `results_type` of the range's futures, and a builder collecting
+    // their results into a ready header.
+    
+    template<typename Results>
+    struct when_all_range_result;
+    
+    template<>
+    struct when_all_range_result<std::tuple<>> {
+      using future_type = future<>;
+      
+      struct builder {
+        builder(std::size_t) {}
+        
+        template<typename LrefsGetter>
+        void add(LrefsGetter const&) {}
+        
+        future_header* finish() {
+          return &future_header_result<>::the_always;
+        }
+      };
+    };
+    
+    template<typename T>
+    struct when_all_range_result<std::tuple<T>> {
+      static_assert(!std::is_reference<T>::value,
+        "when_all(begin, end) does not support futures of references."
+      );
+      
+      using future_type = future<std::vector<T>>;
+      
+      struct builder {
+        std::vector<T> values_;
+        
+        builder(std::size_t n) {
+          values_.reserve(n);
+        }
+        
+        template<typename LrefsGetter>
+        void add(LrefsGetter const &getter) {
+          values_.push_back(std::get<0>(getter()));
+        }
+        
+        future_header* finish() {
+          return &(new future_header_result<std::vector<T>>(
+              /*not_ready=*/false,
+              /*values=*/std::tuple<std::vector<T>>(std::move(values_))
+            ))->base_header;
+        }
+      };
+    };
+    
+    //////////////////////////////////////////////////////////////////////
+    // future_body_when_all_range: Body for `when_all(begin, end)`. The
+    // dependencies on all n futures live in the same allocation as the
+    // body and count down the one successor header's `status_`, so waiting
+    // on n futures costs one header and one body regardless of n.
+    
+    template<typename FuArg>
+    struct future_body_when_all_range final: future_body {
+      using dep_type = future_dependency<FuArg>;
+      using result_type = when_all_range_result<typename FuArg::results_type>;
+      
+      std::size_t n_;
+      dep_type *deps_;
+      
+      static constexpr std::size_t deps_offset() {
+        return (sizeof(future_body_when_all_range) + alignof(dep_type)-1) & ~(alignof(dep_type)-1);
+      }
+      
+      static std::size_t storage_size(std::size_t n) {
+        return deps_offset() + n*sizeof(dep_type);
+      }
+      
+      // `storage` must be at least `storage_size(n)` bytes
+      template<typename Iter>
+      future_body_when_all_range(
+          void *storage, future_header_dependent *suc_hdr,
+          Iter begin, std::size_t n
+        ):
+        future_body(storage),
+        n_(n),
+        deps_(reinterpret_cast<dep_type*>((char*)storage + deps_offset())) {
+        
+        for(std::size_t i=0; i < n; i++, ++begin)
+          ::new(&deps_[i]) dep_type(suc_hdr, FuArg(*begin));
+      }
+      
+      void destruct_early() {
+        for(std::size_t i=0; i < n_; i++) {
+          deps_[i].cleanup_early();
+          deps_[i].~dep_type();
+        }
+        this->~future_body_when_all_range();
+      }
+      
+      void leave_active(future_header_dependent *hdr) {
+        void *storage = this->storage_;
+        
+        if(0 == hdr->decref(1)) { // left active queue
+          for(std::size_t i=0; i < n_; i++) {
+            deps_[i].cleanup_ready();
+            deps_[i].~dep_type();
+          }
+          this->~future_body_when_all_range();
+          future_body::operator delete(storage);
+          delete hdr;
+        }
+        else {
+          typename result_type::builder results(n_);
+          
+          for(std::size_t i=0; i < n_; i++)
+            results.add(deps_[i].result_lrefs_getter());
+          
+          for(std::size_t i=0; i < n_; i++) {
+            deps_[i].cleanup_ready();
+            deps_[i].~dep_type();
+          }
+          this->~future_body_when_all_range();
+          future_body::operator delete(storage);
+          
+          hdr->enter_ready(results.finish());
+        }
+      }
+    };
   }
 }
 #endif
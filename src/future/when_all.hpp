@@ -2,8 +2,11 @@
 #define _eb1a60f5_4086_4689_a513_8486eacfd815
 
 #include <upcxx/future/core.hpp>
+#include <upcxx/future/future1.hpp>
 #include <upcxx/future/impl_when_all.hpp>
 
+#include <cstddef>
+
 namespace upcxx {
   //////////////////////////////////////////////////////////////////////
   // when_all()
@@ -43,5 +46,55 @@ namespace upcxx {
       std::move(args)...
     };
   }
+  
+  //////////////////////////////////////////////////////////////////////
+  // when_all(begin, end): Waits on a runtime-sized range of futures given
+  // by forward iterators. Futures with no values combine into `future<>`,
+  // futures of `T` into `future<std::vector<T>>` holding the values in
+  // range order. The range's futures are copied, not consumed.
+  
+  namespace detail {
+    template<typename Iter, bool is_future = is_future1<Iter>::value>
+    struct when_all_range_return {
+      using future_arg = typename std::decay<decltype(*std::declval<Iter&>())>::type;
+      using type = typename when_all_range_result<typename future_arg::results_type>::future_type;
+    };
+    
+    // two futures of the same type go to the variadic when_all
+    template<typename Iter>
+    struct when_all_range_return<Iter, /*is_future=*/true> {};
+  }
+  
+  template<typename Iter>
+  typename detail::when_all_range_return<Iter>::type when_all(Iter begin, Iter end) {
+    using future_arg = typename detail::when_all_range_return<Iter>::future_arg;
+    using result_type = detail::when_all_range_result<typename future_arg::results_type>;
+    using body_type = detail::future_body_when_all_range<future_arg>;
+    
+    std::size_t n = 0;
+    bool ready = true;
+    for(Iter it = begin; it != end; ++it) {
+      n += 1;
+      ready &= it->ready();
+    }
+    
+    if(ready) {
+      typename result_type::builder results(n);
+      for(Iter it = begin; it != end; ++it)
+        results.add(it->impl_.result_lrefs_getter());
+      
+      return typename result_type::future_type::impl_type(results.finish());
+    }
+    
+    detail::future_header_dependent *hdr = new detail::future_header_dependent;
+    
+    void *storage = detail::future_body::operator new(body_type::storage_size(n));
+    hdr->body_ = ::new(storage) body_type(storage, hdr, begin, n);
+    
+    if(hdr->status_ == detail::future_header::status_active)
+      hdr->entered_active();
+    
+    return typename result_type::future_type::impl_type(hdr);
+  }
 }
 #endif
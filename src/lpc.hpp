@@ -5,10 +5,19 @@
 #include <upcxx/intru_queue.hpp>
 #include <upcxx/utility.hpp>
 
+#include <atomic>
+#include <cstdint>
+
 namespace upcxx {
   namespace detail {
     struct lpc_base;
     
+    // Whether this process collects performance counters, set once by
+    // upcxx::init() (see upcxx/perf_counters.hpp).
+    extern bool perf_counters_on;
+    // Records an inbox having reached `depth` lpc's.
+    void perf_note_lpc_depth(std::int64_t depth);
+    
     struct lpc_vtable {
       // Function pointer to be called against `this` instance whose job is to
       // do *something* and take responsibility for the memory behind this
@@ -94,9 +103,11 @@ namespace upcxx {
     template<detail::intru_queue_safety safety>
     class lpc_inbox {
       detail::intru_queue<lpc_base, safety, &lpc_base::intruder> q_;
+      // lpc's enqueued minus executed, kept only while perf_counters_on
+      std::atomic<std::int64_t> depth_;
     
     public:
-      constexpr lpc_inbox(): q_() {}
+      constexpr lpc_inbox(): q_(), depth_(0) {}
       
       bool empty() const {
         return q_.empty();
@@ -105,16 +116,23 @@ namespace upcxx {
       template<typename Fn1>
       void send(Fn1 &&fn) {
         using Fn = typename std::decay<Fn1>::type;
-        q_.enqueue(new lpc_impl_fn<Fn>{std::forward<Fn1>(fn)});
+        this->enqueue(new lpc_impl_fn<Fn>{std::forward<Fn1>(fn)});
       }
       
       void enqueue(lpc_base *m) {
+        // counted before it becomes visible, so the consumer never takes
+        // the depth below zero
+        if(perf_counters_on)
+          perf_note_lpc_depth(1 + depth_.fetch_add(1, std::memory_order_relaxed));
         q_.enqueue(m);
       }
       
       // returns num lpc's executed
       int burst(int max_n = 100) {
-        return q_.burst(max_n, [](lpc_base *m) { m->vtbl->execute_and_delete(m); });
+        int exec_n = q_.burst(max_n, [](lpc_base *m) { m->vtbl->execute_and_delete(m); });
+        if(perf_counters_on && exec_n != 0)
+          depth_.fetch_sub(exec_n, std::memory_order_relaxed);
+        return exec_n;
       }
     };
   }
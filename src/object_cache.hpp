@@ -0,0 +1,40 @@
+#ifndef _298182fe_6e7d_414f_b20b_0d0bb27ce4d0
+#define _298182fe_6e7d_414f_b20b_0d0bb27ce4d0
+
+#include <cstddef>
+
+/* Allocator for the small, short-lived objects the runtime creates on every
+ * communication operation: future headers and bodies, handle_cb's, and the
+ * rpc_as_lpc's of received eager rpc's.
+ *
+ * Freed blocks go to a per-thread cache of size-class freelists (bounded by
+ * UPCXX_OBJECT_CACHE_SIZE bytes per thread) from which later allocations of
+ * that thread are served without calling malloc. Each block carries a small
+ * prefix naming its class, so any thread may free any block and no size is
+ * needed to free. The `object_cache_hits` performance counter tallies the
+ * mallocs avoided.
+ */
+
+namespace upcxx {
+  namespace detail {
+    // Block aligned to at least `object_align`.
+    void* object_alloc(std::size_t size);
+    void* object_alloc_aligned(std::size_t size, std::size_t align);
+    void object_free(void *p);
+    
+    constexpr std::size_t object_align = 16;
+  }
+}
+
+/* Place this macro in a class definition to have its instances, and those of
+ * its derived classes, allocated by detail::object_alloc.
+ */
+#define UPCXX_OPNEW_CACHED \
+  static void* operator new(std::size_t size) {\
+    return ::upcxx::detail::object_alloc(size);\
+  }\
+  static void operator delete(void *p) {\
+    ::upcxx::detail::object_free(p);\
+  }
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef _0df16f5f_8f52_4383_8e6f_1d6e5d02a6e6
+#define _0df16f5f_8f52_4383_8e6f_1d6e5d02a6e6
+
+#include <cstdint>
+#include <ostream>
+
+/* Runtime performance counters.
+ *
+ * Each thread accumulates into its own block of counters (single writer,
+ * relaxed atomics) so the hot path never contends. Queries sum over every
+ * thread that has touched the runtime. Counting happens only when enabled at
+ * run time (UPCXX_PERF_COUNTERS_ENABLED or UPCXX_PERF_COUNTERS_DUMP), and
+ * costs one untaken branch per event otherwise. Building the library with
+ * -DUPCXX_PERF_COUNTERS=0 compiles all counting out. Either way, disabled
+ * counters read zero.
+ *
+ * Peer class "local" means the peer is in local_team() (shared memory),
+ * "remote" means it is off-node. "hcb" bursts are the network completion
+ * callbacks (handle_cb's) reaped in one pass of progress. `lpc_inbox_depth_max`
+ * is the high-water mark of any one persona inbox, as lpc's enqueued minus
+ * lpc's executed, sampled at each enqueue by the enqueuing thread. Eager
+ * messages to local peers that went through a shared-memory ring
+ * (UPCXX_SHM_RING_SIZE) are counted both as `am_eager_sends_local` and
+ * `shm_ring_sends`; `shm_ring_full` counts the ones that found their ring
+ * full and fell back to an AM. `object_cache_hits` counts runtime objects
+ * (futures, completion callbacks, received rpc's) allocated without malloc
+ * (see upcxx/object_cache.hpp).
+ */
+
+#ifndef UPCXX_PERF_COUNTERS
+  #define UPCXX_PERF_COUNTERS 1
+#endif
+
+// X(name, aggregation) where aggregation is `sum` or `max`
+#define UPCXX_PERF_COUNTER_LIST(X) \
+  X(am_eager_sends_local, sum) \
+  X(am_eager_sends_remote, sum) \
+  X(am_eager_send_bytes_local, sum) \
+  X(am_eager_send_bytes_remote, sum) \
+  X(am_rdzv_sends_local, sum) \
+  X(am_rdzv_sends_remote, sum) \
+  X(am_rdzv_send_bytes_local, sum) \
+  X(am_rdzv_send_bytes_remote, sum) \
+  X(am_eager_recvs_local, sum) \
+  X(am_eager_recvs_remote, sum) \
+  X(am_eager_recv_bytes_local, sum) \
+  X(am_eager_recv_bytes_remote, sum) \
+  X(am_rdzv_recvs_local, sum) \
+  X(am_rdzv_recvs_remote, sum) \
+  X(am_rdzv_recv_bytes_local, sum) \
+  X(am_rdzv_recv_bytes_remote, sum) \
+  X(shm_ring_sends, sum) \
+  X(shm_ring_full, sum) \
+  X(object_cache_hits, sum) \
+  X(hcb_bursts, sum) \
+  X(hcb_burst_execs, sum) \
+  X(hcb_burst_max, max) \
+  X(lpc_inbox_depth_max, max) \
+  X(progress_calls, sum) \
+  X(progress_ns, sum) \
+  X(progress_limit_hits, sum) \
+  X(after_gasnet_limit_hits, sum) \
+  X(wait_yields, sum) \
+  X(wait_blocks, sum)
+
+namespace upcxx {
+  struct perf_counters {
+    #define UPCXX_PERF_COUNTER_FIELD(name, agg) std::uint64_t name;
+    UPCXX_PERF_COUNTER_LIST(UPCXX_PERF_COUNTER_FIELD)
+    #undef UPCXX_PERF_COUNTER_FIELD
+  };
+
+  // Counters of the calling thread only.
+  perf_counters perf_counters_thread();
+
+  // Counters summed (or max'd) over all threads of this process.
+  perf_counters perf_counters_process();
+
+  // Human readable rendering, one counter per line.
+  std::ostream& operator<<(std::ostream &o, const perf_counters &pc);
+}
+
+#endif
@@ -397,8 +397,10 @@ namespace upcxx {
   void persona::lpc_ff(detail::persona_tls &tls, Fn fn) {
     if(this->active_with_caller(tls))
       this->self_inbox_[(int)progress_level::user].send(std::move(fn));
-    else
+    else {
       this->peer_inbox_[(int)progress_level::user].send(std::move(fn));
+      detail::wait_wake();
+    }
   }
   
   template<typename Fn>
@@ -601,8 +603,10 @@ namespace upcxx {
       else
         p.self_inbox_[(int)level].send(std::forward<Fn>(fn));
     }
-    else
+    else {
       p.peer_inbox_[(int)level].send(std::forward<Fn>(fn));
+      detail::wait_wake();
+    }
   }
   
   template<typename ...T>
@@ -647,8 +651,10 @@ namespace upcxx {
     
     if(known_active || p.active_with_caller(tls))
       p.self_inbox_[(int)level].send(std::forward<Fn>(fn));
-    else
+    else {
       p.peer_inbox_[(int)level].send(std::forward<Fn>(fn));
+      detail::wait_wake();
+    }
   }
 
   template<bool known_active>
@@ -662,8 +668,10 @@ namespace upcxx {
     
     if(known_active || p.active_with_caller(tls))
       p.self_inbox_[(int)level].enqueue(m);
-    else
+    else {
       p.peer_inbox_[(int)level].enqueue(m);
+      detail::wait_wake();
+    }
   }
 
   template<typename ...T, bool known_active>
@@ -684,8 +692,10 @@ namespace upcxx {
       else
         target.self_inbox_[(int)level].enqueue(&meta->base);
     }
-    else
+    else {
       target.peer_inbox_[(int)level].enqueue(&meta->base);
+      detail::wait_wake();
+    }
   }
   
   inline bool detail::persona_tls::progress_required() {
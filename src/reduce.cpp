@@ -49,6 +49,14 @@ void upcxx::detail::reduce_one_or_all_trivial_erased(
       upcxx::say()<<"gex_Coll_ReduceToXxxNB(dt="<<ty_id<<", op="<<op_id<<")";
   #endif
   
+  if(tm.base(detail::internal_only()).via_world) {
+    gasnet::am_coll(
+      tm, root_or_all >= 0 ? root_or_all : 0, true, root_or_all < 0,
+      src, dst, elt_sz, elt_n, ty_id, op_id, op_vecfn, op_data, cb
+    );
+    return;
+  }
+  
   gex_Event_t e = root_or_all >= 0
     ? gex_Coll_ReduceToOneNB(
         gasnet::handle_of(tm), root_or_all,
@@ -7,6 +7,7 @@
 #include <upcxx/team.hpp>
 #include <upcxx/utility.hpp>
 
+#include <memory>
 #include <type_traits>
 
 /* NOTE: Reductions have full completions support, unlike the other
@@ -361,6 +362,7 @@ namespace upcxx {
     template<typename T, typename Op, bool one_not_all, typename Cxs>
     struct reduce_state {
       intrank_t root; // root rank for reduction tree
+      intrank_t parent; // rank receiving our partial result, -1 if we are root
       int incoming; // number of ranks sending us a contribution, counts down to zero.
       T accum; // accumulates contributions from local user and other ranks.
       
@@ -627,32 +629,18 @@ namespace upcxx {
       UPCXX_ASSERT(backend::master.active_with_caller());
       detail::persona_scope_redundant master_as_top(backend::master, detail::the_persona_tls);
       
-      intrank_t rank_n = tm.rank_n();
-      
-      // Use rank indexing scheme where the root is zero.
-      intrank_t rank_me = tm.rank_me() - root;
-      rank_me += rank_me < 0 ? rank_n : 0;
-      
       auto it_and_inserted = detail::registry.insert({id, nullptr});
       reduce_state *state;
       
       if(it_and_inserted.second) {
         // `id` didn't exist in registry so we're first to contribute.
         
-        // Given the parent function which flips the least significant one-bit
-        //   parent(r) = r & (r-1)
-        // Count number of bitpatterns in [0,rank_n) which when asked for
-        // their parent, would produce us (rank_me).
-        int incoming = 0;
-        while(true) {
-          intrank_t child = rank_me | (intrank_t(1)<<incoming);
-          if(child == rank_me || rank_n <= child)
-            break;
-          incoming += 1;
-        }
-        incoming += 1; // add one for this rank
+        // The tree is the bcast tree read backwards: ranks first combine
+        // with their local_team() peers so only node leaders' partial
+        // results cross the network.
+        backend::gasnet::reduce_tree_links links = backend::gasnet::reduce_tree_links_of(tm, root);
         
-        state = new reduce_state{root, incoming, std::forward<T1>(value), {}};
+        state = new reduce_state{root, links.parent, links.child_n + 1/*this rank*/, std::forward<T1>(value), {}};
         it_and_inserted.first->second = state;
       }
       else {
@@ -666,7 +654,7 @@ namespace upcxx {
       
       if(0 == --state->incoming) {
         // We have all of our expected contributions.
-        if(rank_me == 0) {
+        if(state->parent < 0) {
           // We are root, time to broadcast result.
           auto bound = upcxx::bind([=](T &&value) {
                 auto it = detail::registry.find(id);
@@ -687,12 +675,8 @@ namespace upcxx {
           detail::registry.erase(id);
         }
         else {
-          // Send our result to parent. Parent rank's index is the same as ours
-          // except with the least significant one-bit set to zero.
-          intrank_t parent = rank_me & (rank_me-1);
-          // Translate back to team's indexing scheme
-          parent += root;
-          parent -= parent >= rank_n ? rank_n : 0;
+          // Send our result to parent.
+          intrank_t parent = state->parent;
           
           team_id tm_id = tm.id();
           
@@ -701,7 +685,16 @@ namespace upcxx {
             upcxx::bind(
               //[=](T &value, decltype(detail::globalize_fnptr(std::declval<Op>())) const &op) {
               [=](T &&value, typename detail::globalize_fnptr_return<Op>::type const &op)->void {
-                reduce_state::contribute(tm_id.here(), root, id, op, static_cast<T&&>(value), nullptr);
+                if(detail::registry.count(tm_id.dig_) != 0)
+                  reduce_state::contribute(tm_id.here(), root, id, op, static_cast<T&&>(value), nullptr);
+                else {
+                  // the parent got here before constructing the team
+                  std::shared_ptr<T> early = std::make_shared<T>(static_cast<T&&>(value));
+                  typename detail::globalize_fnptr_return<Op>::type op1 = op;
+                  detail::team_when_here(tm_id, [=]() {
+                    reduce_state::contribute(tm_id.here(), root, id, op1, std::move(*early), nullptr);
+                  });
+                }
               },
               state->accum, detail::globalize_fnptr(op)
             )
@@ -0,0 +1,139 @@
+#ifndef _5b8f0c2e_1d7a_4c39_9e64_8a2f6d3b7c11
+#define _5b8f0c2e_1d7a_4c39_9e64_8a2f6d3b7c11
+
+#include <upcxx/diagnostic.hpp>
+#include <upcxx/digest.hpp>
+
+#include <cstddef>
+#include <utility>
+
+/* detail::registry_table: The master persona's map from digest to the local
+ * state of a dist_object, team or in-flight collective.
+ *
+ * Linear probing over a flat array of (digest, pointer) slots kept at most
+ * half full, so a lookup is one or two cache lines. Digests come out of
+ * SpookyHash so their low bits index the table directly. Deletion shifts
+ * later entries of the probe run back instead of leaving tombstones.
+ *
+ * The last slot found or inserted is remembered. A lookup first checks
+ * whether that slot still holds the digest, which makes a stream of rpc's
+ * bound to the same dist_object a single compare. Slots move when the
+ * table grows or an entry is erased, so iterators (slot pointers) are only
+ * valid until the next insert or erase.
+ *
+ * The digest with both words all ones marks an empty slot. It is the id
+ * moved-from dist_objects and teams take, which is never registered.
+ */
+
+namespace upcxx {
+  namespace detail {
+    class registry_table {
+    public:
+      struct slot {
+        digest first;
+        void *second;
+      };
+      using iterator = slot*;
+
+    private:
+      slot *slots_;
+      std::size_t mask_; // capacity - 1
+      std::size_t size_;
+      std::size_t hot_; // last slot hit, validated against its digest
+
+      static constexpr digest empty_key() {
+        return digest{~0ull, ~0ull};
+      }
+
+      std::size_t home_of(digest key) const {
+        return std::size_t(key.w0 ^ (key.w1 >> 32)) & mask_;
+      }
+
+      // Slot holding `key`, or the empty slot ending its probe run.
+      slot* probe(digest key) const {
+        std::size_t i = home_of(key);
+        while(true) {
+          slot *s = &slots_[i];
+          if(s->first == key || s->first == empty_key())
+            return s;
+          i = (i + 1) & mask_;
+        }
+      }
+
+      void grow();
+
+    public:
+      registry_table();
+      registry_table(registry_table const&) = delete;
+      ~registry_table();
+
+      std::size_t size() const { return size_; }
+
+      iterator end() const { return nullptr; }
+
+      iterator find(digest key) {
+        slot *s = &slots_[hot_];
+        if(s->first == key)
+          return s;
+
+        s = probe(key);
+        if(s->first == empty_key())
+          return nullptr;
+
+        hot_ = s - slots_;
+        return s;
+      }
+
+      std::size_t count(digest key) {
+        return find(key) != nullptr ? 1 : 0;
+      }
+
+      // Same contract as std::unordered_map::insert.
+      std::pair<iterator, bool> insert(std::pair<digest, void*> kv) {
+        UPCXX_ASSERT(kv.first != empty_key());
+
+        slot *s = &slots_[hot_];
+        if(s->first == kv.first)
+          return {s, false};
+
+        s = probe(kv.first);
+        if(s->first == kv.first) {
+          hot_ = s - slots_;
+          return {s, false};
+        }
+
+        if(2*(size_ + 1) > mask_ + 1) {
+          grow();
+          s = probe(kv.first);
+        }
+
+        s->first = kv.first;
+        s->second = kv.second;
+        size_ += 1;
+        hot_ = s - slots_;
+        return {s, true};
+      }
+
+      void*& operator[](digest key) {
+        return insert({key, nullptr}).first->second;
+      }
+
+      void*& at(digest key) {
+        slot *s = find(key);
+        UPCXX_ASSERT(s != nullptr, "digest " << key << " not in registry");
+        return s->second;
+      }
+
+      void erase(iterator it);
+
+      std::size_t erase(digest key) {
+        slot *s = find(key);
+        if(s == nullptr)
+          return 0;
+        erase(s);
+        return 1;
+      }
+    };
+  }
+}
+#endif
@@ -77,3 +77,17 @@ void upcxx::detail::serialization_writer<false>::compact_and_invalidate_(void *b
   size_ = 0; align_ = 1;
   head_ = tail_ = nullptr;
 }
+
+void* upcxx::detail::serialization_measuring_writer::sink(std::size_t size) {
+  // Reuse the initial buffer, its contents are already abandoned.
+  if(size <= capacity_)
+    return buf_;
+  
+  if(size > sink_size_) {
+    if(sink_size_ != 0)
+      std::free(sink_);
+    sink_size_ = std::max<std::size_t>(size, 2*sink_size_);
+    sink_ = detail::alloc_aligned(sink_size_, align_max);
+  }
+  return sink_;
+}
@@ -586,6 +586,118 @@ namespace upcxx {
       }
     };
 
+    // Writes into a caller-provided buffer for as long as everything fits.
+    // Once something would overflow it, stops storing and only keeps
+    // measuring the size and alignment of what is written. A caller that
+    // finds `!contained_in_initial()` can then allocate exactly `size()`
+    // bytes and serialize the same objects again with
+    // `serialization_writer<true>`, rather than paying for the hunks and the
+    // compacting copy of `serialization_writer<false>`.
+    class serialization_measuring_writer:
+      public serialization_writer_base<serialization_measuring_writer> {
+      
+      char *buf_;
+      std::size_t capacity_;
+      std::size_t size_, align_;
+      
+      // Bytes handed out by place() after overflowing, contents are junk.
+      void *sink_;
+      std::size_t sink_size_;
+      
+      void* sink(std::size_t size);
+      
+    public:
+      serialization_measuring_writer(void *buf, std::size_t capacity):
+        buf_((char*)buf),
+        capacity_(capacity),
+        size_(0), align_(1),
+        sink_(nullptr), sink_size_(0) {
+        UPCXX_ASSERT(detail::is_aligned(buf, serialization_align_max));
+      }
+      
+      serialization_measuring_writer(serialization_measuring_writer const&) = delete;
+      
+      serialization_measuring_writer(serialization_measuring_writer &&that):
+        buf_(that.buf_),
+        capacity_(that.capacity_),
+        size_(that.size_), align_(that.align_),
+        sink_(that.sink_), sink_size_(that.sink_size_) {
+        that.sink_ = nullptr;
+        that.sink_size_ = 0;
+      }
+      
+      ~serialization_measuring_writer() {
+        if(sink_size_ != 0)
+          std::free(sink_);
+      }
+      
+      std::size_t size() const { return size_; }
+      std::size_t align() const { return align_; }
+      
+      bool contained_in_initial() const {
+        return size_ <= capacity_;
+      }
+      
+      void compact_and_invalidate(void *buf) {
+        UPCXX_ASSERT(contained_in_initial());
+        std::memcpy(buf, buf_, size_);
+      }
+      
+      void* place(std::size_t obj_size, std::size_t obj_align) {
+        std::size_t size0 = (size_ + obj_align-1) & -obj_align;
+        size_ = size0 + obj_size;
+        align_ = obj_align > align_ ? obj_align : align_;
+        
+        if(size_ <= capacity_)
+          return buf_ + size0;
+        else
+          return this->sink(obj_size);
+      }
+      
+      using serialization_writer_base<serialization_measuring_writer>::place;
+      
+    private:
+      template<typename T, typename Iter>
+      std::size_t write_sequence_(Iter beg, Iter end, std::size_t n, std::true_type trivial_and_contiguous) {
+        if(n == std::size_t(-1))
+          n = std::distance(beg, end);
+        
+        const std::size_t alignof_T = n == 0 ? 1 : alignof(T);
+        std::size_t size0 = (size_ + alignof_T-1) & -alignof_T;
+        
+        // once overflowing, arrays are just counted
+        if(size0 + n*sizeof(T) <= capacity_)
+          detail::template memcpy_aligned<alignof(T)>(buf_ + size0, &*beg, n*sizeof(T));
+        
+        size_ = size0 + n*sizeof(T);
+        align_ = alignof_T > align_ ? alignof_T : align_;
+        return n;
+      }
+      
+      template<typename T, typename Iter>
+      std::size_t write_sequence_(Iter beg, Iter end, std::size_t n, std::false_type trivial_and_contiguous) {
+        n = 0;
+        for(Iter x=beg; x != end; ++x, ++n)
+          upcxx::template serialization_traits<T>::serialize(*this, *x);
+        return n;
+      }
+      
+    public:
+      template<typename Iter>
+      std::size_t write_sequence(Iter beg, Iter end, std::size_t n=-1) {
+        using T = typename std::remove_cv<
+            typename std::iterator_traits<Iter>::value_type
+          >::type;
+        
+        return this->template write_sequence_<T,Iter>(beg, end, n,
+          /*trivial_and_contiguous=*/std::integral_constant<bool,
+              serialization_traits<T>::is_actually_trivially_serializable &&
+              is_iterator_contiguous<Iter>::value
+            >()
+        );
+      }
+    };
+
     class serialization_reader {
       std::uintptr_t head_;
       
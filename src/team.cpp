@@ -1,20 +1,162 @@
 #include <upcxx/team.hpp>
+#include <upcxx/reduce.hpp>
 
 #include <upcxx/backend/gasnet/runtime_internal.hpp>
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 using namespace std;
 
 namespace detail = upcxx::detail;
 namespace backend = upcxx::backend;
 namespace gasnet = upcxx::backend::gasnet;
 
+using upcxx::intrank_t;
 using upcxx::team;
 using detail::raw_storage;
 
 raw_storage<team> detail::the_world_team;
 raw_storage<team> detail::the_local_team;
 
-std::unordered_map<upcxx::digest, void*> upcxx::detail::registry;
+detail::registry_table upcxx::detail::registry;
+
+////////////////////////////////////////////////////////////////////////////////
+// registry_table
+
+detail::registry_table::registry_table():
+  mask_(64-1),
+  size_(0),
+  hot_(0) {
+  slots_ = (slot*)std::malloc((mask_+1)*sizeof(slot));
+  UPCXX_ASSERT_ALWAYS(slots_ != nullptr);
+  for(std::size_t i=0; i <= mask_; i++)
+    slots_[i].first = empty_key();
+}
+
+detail::registry_table::~registry_table() {
+  std::free(slots_);
+}
+
+void detail::registry_table::grow() {
+  slot *old = slots_;
+  std::size_t old_cap = mask_ + 1;
+
+  mask_ = 2*old_cap - 1;
+  slots_ = (slot*)std::malloc(2*old_cap*sizeof(slot));
+  UPCXX_ASSERT_ALWAYS(slots_ != nullptr);
+  for(std::size_t i=0; i <= mask_; i++)
+    slots_[i].first = empty_key();
+
+  for(std::size_t i=0; i < old_cap; i++) {
+    if(old[i].first != empty_key())
+      *probe(old[i].first) = old[i];
+  }
+
+  std::free(old);
+  hot_ = 0;
+}
+
+void detail::registry_table::erase(iterator it) {
+  // Backward shift: walk the rest of the probe run and pull back every entry
+  // whose home is not cyclically within (hole, entry], so no run is broken.
+  std::size_t hole = it - slots_;
+  std::size_t j = hole;
+  while(true) {
+    j = (j + 1) & mask_;
+    if(slots_[j].first == empty_key())
+      break;
+
+    std::size_t home = home_of(slots_[j].first);
+    bool stays = hole <= j ? (hole < home && home <= j)
+                           : (hole < home || home <= j);
+    if(!stays) {
+      slots_[hole] = slots_[j];
+      hole = j;
+    }
+  }
+
+  slots_[hole].first = empty_key();
+  size_ -= 1;
+}
+
+namespace {
+  // Fills in the rank translation of a team of `n` ranks whose rank `r` is
+  // world rank `world_of(r)`. Evenly spaced teams (world, local_team, splits
+  // by rank modulo) need no tables, anything else gets a dense array plus
+  // its inverse.
+  template<typename WorldOf>
+  void init_rank_maps(backend::team_base &b, intrank_t n, WorldOf &&world_of) {
+    if(n == 0)
+      return;
+    
+    std::unique_ptr<intrank_t[]> to_world{new intrank_t[n]};
+    bool even = true;
+    
+    for(intrank_t r=0; r < n; r++) {
+      to_world[r] = world_of(r);
+      if(r == 1)
+        b.world_stride = to_world[1] - to_world[0];
+      even &= to_world[r] == std::int64_t(to_world[0]) + std::int64_t(r)*b.world_stride;
+    }
+    
+    b.world_lb = to_world[0];
+    if(even)
+      return;
+    
+    std::uint32_t cap = 2;
+    while(cap < 2*std::uint32_t(n))
+      cap *= 2;
+    
+    b.from_world.reset(new intrank_t[cap]);
+    b.from_world_mask = cap-1;
+    for(std::uint32_t i=0; i < cap; i++)
+      b.from_world[i] = -1;
+    
+    for(intrank_t r=0; r < n; r++) {
+      std::uint32_t i = backend::team_base::from_world_hash(to_world[r]);
+      while(b.from_world[i & b.from_world_mask] >= 0)
+        i++;
+      b.from_world[i & b.from_world_mask] = r;
+    }
+    
+    b.to_world = std::move(to_world);
+  }
+  
+  // Base of a team with no gex team of its own whose rank `r` is world rank
+  // `world[r]`.
+  backend::team_base via_world_base(std::vector<intrank_t> const &world) {
+    backend::team_base b{reinterpret_cast<std::uintptr_t>(gasnet::handle_of(upcxx::world()))};
+    b.via_world = true;
+    init_rank_maps(b, (intrank_t)world.size(), [&](intrank_t r) { return world[r]; });
+    return b;
+  }
+  
+  // Teams made by split_async(), which the runtime owns until destroy().
+  std::unordered_set<team*> async_teams;
+  
+  // Number of teams team::create() has made so far from each rank list, so
+  // repeated creation from one list yields distinct ids.
+  std::unordered_map<upcxx::digest, std::uint64_t> create_counts;
+  
+  // Work from detail::team_when_here() on teams not yet constructed here.
+  std::unordered_map<upcxx::digest, std::vector<std::function<void()>>> team_waiters;
+}
+
+void detail::team_when_here(upcxx::team_id id, std::function<void()> fn) {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+  
+  if(detail::registry.count(id.dig_) != 0)
+    fn();
+  else
+    team_waiters[id.dig_].push_back(std::move(fn));
+}
 
 team::team(detail::internal_only, backend::team_base &&base, digest id, intrank_t n, intrank_t me):
   backend::team_base(std::move(base)),
@@ -23,7 +165,24 @@ team::team(detail::internal_only, backend::team_base &&base, digest id, intrank_
   n_(n),
   me_(me) {
   
+  if(!this->via_world) {
+    gex_TM_t tm = reinterpret_cast<gex_TM_t>(this->handle);
+    init_rank_maps(*this, n, [=](intrank_t r) {
+      return (intrank_t)gex_TM_TranslateRankToJobrank(tm, r);
+    });
+  }
+  
   detail::registry[id_] = this;
+  
+  auto waiting = team_waiters.find(id_);
+  if(waiting != team_waiters.end()) {
+    std::vector<std::function<void()>> fns = std::move(waiting->second);
+    team_waiters.erase(waiting);
+    
+    detail::persona_scope_redundant master_as_top(backend::master, detail::the_persona_tls);
+    for(std::function<void()> &fn: fns)
+      fn();
+  }
 }
 
 team::team(team &&that):
@@ -56,6 +215,15 @@ team team::split(intrank_t color, intrank_t key) const {
   UPCXX_ASSERT(backend::master.active_with_caller());
   UPCXX_ASSERT(color >= 0 || color == color_none);
   
+  if(this->via_world) {
+    // No gex team to split, so wait on the AM version and take its team.
+    team &made = this->split_async(color, key).wait();
+    team ans(std::move(made));
+    async_teams.erase(&made);
+    delete &made;
+    return ans;
+  }
+  
   gex_TM_t sub_tm = GEX_TM_INVALID;
   gex_TM_t *p_sub_tm = color == color_none ? nullptr : &sub_tm;
   
@@ -89,18 +257,106 @@ team team::split(intrank_t color, intrank_t key) const {
     );
 }
 
+upcxx::future<team&> team::split_async(intrank_t color, intrank_t key) const {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+  UPCXX_ASSERT(color >= 0 || color == color_none);
+  
+  digest id = const_cast<team*>(this)->next_collective_id(detail::internal_only()).eat(color);
+  team_id parent_id = this->id();
+  
+  // Every rank's (color, key) over the parent, gathered by a max-reduction
+  // of slots everyone else leaves at the minimum.
+  std::shared_ptr<std::vector<std::int64_t>> slots =
+    std::make_shared<std::vector<std::int64_t>>(2*std::size_t(n_), INT64_MIN);
+  (*slots)[2*me_ + 0] = color;
+  (*slots)[2*me_ + 1] = key;
+  
+  return upcxx::reduce_all(slots->data(), slots->data(), slots->size(), upcxx::op_fast_max, *this)
+    .then([=]() -> team& {
+      team const &parent = parent_id.here();
+      team *made;
+      
+      if(color == color_none)
+        made = new team(detail::internal_only(),
+          backend::team_base{reinterpret_cast<uintptr_t>(GEX_TM_INVALID)},
+          id, 0, -1
+        );
+      else {
+        std::vector<intrank_t> members;
+        for(intrank_t r=0; r < parent.rank_n(); r++) {
+          if((*slots)[2*r] == color)
+            members.push_back(r);
+        }
+        // ties in key are broken by parent rank, as gex_TM_Split does
+        std::stable_sort(members.begin(), members.end(),
+          [&](intrank_t a, intrank_t b) { return (*slots)[2*a + 1] < (*slots)[2*b + 1]; });
+        
+        std::vector<intrank_t> world(members.size());
+        intrank_t me = -1;
+        for(std::size_t r=0; r < members.size(); r++) {
+          world[r] = parent[members[r]];
+          if(members[r] == parent.rank_me())
+            me = (intrank_t)r;
+        }
+        
+        made = new team(detail::internal_only(), via_world_base(world), id,
+                        (intrank_t)members.size(), me);
+      }
+      
+      async_teams.insert(made);
+      return *made;
+    });
+}
+
+team team::create(detail::internal_only, std::vector<intrank_t> const &ranks) const {
+  UPCXX_ASSERT(backend::master.active_with_caller());
+  
+  // The id must not depend on anything but the parent and the list, so
+  // every member derives it alone.
+  digest list_id = id_.eat(~std::uint64_t(0)/*no collective's counter*/, ranks.size());
+  std::vector<intrank_t> world(ranks.size());
+  intrank_t me = -1;
+  
+  for(std::size_t r=0; r < ranks.size(); r++) {
+    UPCXX_ASSERT_ALWAYS(0 <= ranks[r] && ranks[r] < n_,
+      "team::create(): rank " << ranks[r] << " is not in the parent team");
+    UPCXX_ASSERT_ALWAYS(r == 0 || ranks[r-1] < ranks[r],
+      "team::create(): ranks must be listed in ascending order");
+    
+    list_id = list_id.eat(ranks[r]);
+    world[r] = (*this)[ranks[r]];
+    if(ranks[r] == me_)
+      me = (intrank_t)r;
+  }
+  
+  UPCXX_ASSERT_ALWAYS(me >= 0,
+    "team::create(): the calling rank must be in the list");
+  
+  std::uint64_t ordinal = create_counts[list_id]++;
+  
+  return team(detail::internal_only(), via_world_base(world), list_id.eat(ordinal),
+              (intrank_t)ranks.size(), me);
+}
+
 void team::destroy(entry_barrier eb) {
   UPCXX_ASSERT(backend::master.active_with_caller());
   
   if(this->handle != reinterpret_cast<uintptr_t>(GEX_TM_INVALID)) {
     backend::quiesce(*this, eb);
     
-    void *scratch = gex_TM_QueryCData(reinterpret_cast<gex_TM_t>(this->handle));
-    upcxx::deallocate(scratch);
+    if(!this->via_world) {
+      void *scratch = gex_TM_QueryCData(reinterpret_cast<gex_TM_t>(this->handle));
+      upcxx::deallocate(scratch);
+    }
     
     // TODO: destruct with GEX API call when that exists
   }
   
-  if(id_ != digest{~0ull, ~0ull})
+  if(id_ != digest{~0ull, ~0ull}) {
+    gasnet::bcast_tree_forget(*this);
     detail::registry.erase(id_);
+  }
+  
+  if(async_teams.erase(this))
+    delete this;
 }
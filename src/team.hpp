@@ -48,6 +48,22 @@ namespace upcxx {
     }
   }
   
+  inline future<team&> team_id::when_here() const {
+    if(detail::registry.count(dig_) != 0)
+      return make_future<team&>(here());
+    
+    detail::future_header_promise<team&> *pro = new detail::future_header_promise<team&>;
+    future<team&> ans = detail::promise_get_future(pro);
+    team_id id = *this;
+    
+    detail::team_when_here(id, [=]() {
+      backend::fulfill_during<progress_level::user>(
+        /*move ref*/pro, std::tuple<team&>(id.here()), backend::master
+      );
+    });
+    return ans;
+  }
+  
   inline bool local_team_contains(intrank_t rank) {
     return backend::rank_is_local(rank);
   }
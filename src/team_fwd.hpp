@@ -4,9 +4,12 @@
 #include <upcxx/bind.hpp>
 #include <upcxx/backend_fwd.hpp>
 #include <upcxx/digest.hpp>
+#include <upcxx/registry.hpp>
 #include <upcxx/utility.hpp>
 
-#include <unordered_map>
+#include <functional>
+#include <iterator>
+#include <vector>
 
 /* This is the forward declaration(s) of upcxx::team and friends. It does not
  * define the function bodies nor does it pull in the full backend header.
@@ -16,7 +19,7 @@
 
 namespace upcxx {
   namespace detail {
-    extern std::unordered_map<digest, void*> registry;
+    extern registry_table registry;
     
     // Get the promise pointer from the master map.
     template<typename T>
@@ -37,17 +40,12 @@ namespace upcxx {
     team_id() : dig_(digest::zero()) {} // issue 343: disable trivial default construction
 
     team& here() const {
-      return *static_cast<team*>(detail::registry[dig_]);
+      return *static_cast<team*>(detail::registry.at(dig_));
     }
 
-    future<team&> when_here() const {
-      team *pteam = static_cast<team*>(detail::registry[dig_]);
-      // issue170: Currently the only form of team construction has barrier semantics,
-      // such that a newly created team_id cannot arrive at user-level progress anywhere
-      // until after the local representative has been constructed.
-      UPCXX_ASSERT(pteam != nullptr);
-      return make_future<team&>(*pteam);
-    }
+    // Ready once this rank has constructed the team, which for teams from
+    // team::create() and team::split_async() may be after the id arrives.
+    future<team&> when_here() const; // defined in team.hpp
     
     #define UPCXX_COMPARATOR(op) \
       friend bool operator op(team_id a, team_id b) {\
@@ -93,14 +91,17 @@ namespace upcxx {
     intrank_t rank_me() const { return me_; }
     
     intrank_t from_world(intrank_t rank) const {
-      return backend::team_rank_from_world(*this, rank);
+      intrank_t peer = this->rank_from_world(rank, n_, -1);
+      UPCXX_ASSERT(peer >= 0, "world rank " << rank << " is not a member of this team");
+      return peer;
     }
     intrank_t from_world(intrank_t rank, intrank_t otherwise) const {
-      return backend::team_rank_from_world(*this, rank, otherwise);
+      return this->rank_from_world(rank, n_, otherwise);
     }
     
     intrank_t operator[](intrank_t peer) const {
-      return backend::team_rank_to_world(*this, peer);
+      UPCXX_ASSERT(0 <= peer && peer < n_);
+      return this->rank_to_world(peer);
     }
     
     team_id id() const {
@@ -111,11 +112,27 @@ namespace upcxx {
     
     team split(intrank_t color, intrank_t key) const;
     
+    // Collective like split() but without blocking: the new team is ready
+    // when the future is. It is owned by the runtime until destroy().
+    // Every rank gathers all of the parent's (color, key) pairs, which is
+    // O(parent size) per rank.
+    future<team&> split_async(intrank_t color, intrank_t key) const;
+    
+    // Non-collective: each rank in `ranks` (ranks of this team in ascending
+    // order, becoming new team ranks 0, 1, ...) creates the team on its own.
+    template<typename Container>
+    team create(Container const &ranks) const {
+      return create(detail::internal_only(),
+        std::vector<intrank_t>(std::begin(ranks), std::end(ranks)));
+    }
+    
     void destroy(entry_barrier eb = entry_barrier::user);
     
     ////////////////////////////////////////////////////////////////////////////
     // internal only
     
+    team create(detail::internal_only, std::vector<intrank_t> const &ranks) const;
+    
     const team_base& base(detail::internal_only) const {
       return *this;
     }
@@ -131,6 +148,12 @@ namespace upcxx {
   namespace detail {
     extern detail::raw_storage<team> the_world_team;
     extern detail::raw_storage<team> the_local_team;    
+    
+    // Calls `fn()` once this rank has constructed the team `id`, right away
+    // if it already has. Members of a team from create() or split_async()
+    // construct it each in their own time, so a message naming it can get
+    // here first. Master persona only.
+    void team_when_here(team_id id, std::function<void()> fn);
   }
 }
 #endif
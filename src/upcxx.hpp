@@ -15,16 +15,21 @@ namespace upcxx {
 }
 
 #include <upcxx/allocate.hpp>
+#include <upcxx/alltoall.hpp>
 #include <upcxx/atomic.hpp>
 #include <upcxx/backend.hpp>
 #include <upcxx/barrier.hpp>
 #include <upcxx/broadcast.hpp>
 #include <upcxx/copy.hpp>
+#include <upcxx/coroutine.hpp>
 #include <upcxx/cuda.hpp>
+#include <upcxx/dist_array.hpp>
 #include <upcxx/dist_object.hpp>
+#include <upcxx/dist_unordered_map.hpp>
 #include <upcxx/future.hpp>
 #include <upcxx/global_ptr.hpp>
 #include <upcxx/os_env.hpp>
+#include <upcxx/perf_counters.hpp>
 #include <upcxx/persona.hpp>
 #include <upcxx/reduce.hpp>
 #include <upcxx/rget.hpp>
@@ -276,6 +276,120 @@ namespace upcxx {
     return view<T,Iter>(static_cast<Iter&&>(begin), static_cast<Iter&&>(end), n);
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  // make_nested_view: A view of a container of containers (to any depth) whose
+  // elements are themselves views of the inner containers. Built on the fly
+  // without allocating, and when deserialized each level becomes a view into
+  // the serialized buffer. So an rpc sent a
+  // `make_nested_view(std::vector<std::string>)` receives a
+  // `view<view<char>>`, and a `make_nested_view(std::list<std::vector<int>>)`
+  // a `view<view<int>>`, with the characters and ints never copied out of
+  // the network buffer. Leaves which expose `data()` are viewed through
+  // pointers so they are serialized as one block.
+
+  namespace detail {
+    template<typename Bag, typename=void>
+    struct nested_view_of {
+      // not a container: a leaf element, taken as is
+      using type = Bag;
+      static constexpr bool is_leaf = true;
+
+      static Bag const& make(Bag const &x) noexcept { return x; }
+    };
+
+    template<typename Bag, typename=void>
+    struct nested_view_leaf_iter {
+      using type = typename Bag::const_iterator;
+
+      static type begin(Bag const &bag) noexcept { return bag.cbegin(); }
+      static type end(Bag const &bag) noexcept { return bag.cend(); }
+    };
+
+    template<typename Bag>
+    struct nested_view_leaf_iter<Bag,
+        typename std::enable_if<std::is_same<
+            decltype(std::declval<Bag const&>().data()),
+            typename Bag::value_type const*
+          >::value>::type
+      > {
+      using type = typename Bag::value_type const*;
+
+      static type begin(Bag const &bag) noexcept { return bag.data(); }
+      static type end(Bag const &bag) noexcept { return bag.data() + bag.size(); }
+    };
+
+    // Forward iterator producing nested views of the containers under `Iter`.
+    template<typename Iter>
+    class nested_view_iterator {
+      using elt_of = nested_view_of<typename std::iterator_traits<Iter>::value_type>;
+      Iter it_;
+
+    public:
+      using difference_type = std::ptrdiff_t;
+      using value_type = typename elt_of::type;
+      using pointer = value_type const*;
+      using reference = value_type;
+      using iterator_category = std::forward_iterator_tag;
+
+      nested_view_iterator(Iter it = Iter()): it_(std::move(it)) {}
+
+      value_type operator*() const { return elt_of::make(*it_); }
+
+      nested_view_iterator& operator++() { ++it_; return *this; }
+      nested_view_iterator operator++(int) {
+        nested_view_iterator old = *this;
+        ++it_;
+        return old;
+      }
+
+      friend bool operator==(nested_view_iterator const &a, nested_view_iterator const &b) {
+        return a.it_ == b.it_;
+      }
+      friend bool operator!=(nested_view_iterator const &a, nested_view_iterator const &b) {
+        return a.it_ != b.it_;
+      }
+    };
+
+    template<typename Bag,
+             bool leaf_elts = nested_view_of<typename Bag::value_type>::is_leaf>
+    struct nested_view_bag;
+
+    template<typename Bag>
+    struct nested_view_bag<Bag, /*leaf_elts=*/true> {
+      using iter = nested_view_leaf_iter<Bag>;
+      using type = view<typename Bag::value_type, typename iter::type>;
+
+      static type make(Bag const &bag) noexcept {
+        return type(iter::begin(bag), iter::end(bag), bag.size());
+      }
+    };
+
+    template<typename Bag>
+    struct nested_view_bag<Bag, /*leaf_elts=*/false> {
+      using iter = nested_view_iterator<typename Bag::const_iterator>;
+      using type = view<typename nested_view_of<typename Bag::value_type>::type, iter>;
+
+      static type make(Bag const &bag) noexcept {
+        return type(iter(bag.cbegin()), iter(bag.cend()), bag.size());
+      }
+    };
+
+    template<typename Bag>
+    struct nested_view_of<Bag,
+        typename std::conditional<true, void, decltype(
+          std::declval<Bag const&>().cbegin() != std::declval<Bag const&>().cend(),
+          std::declval<Bag const&>().size()
+        )>::type
+      >: nested_view_bag<Bag> {
+      static constexpr bool is_leaf = false;
+    };
+  }
+
+  template<typename Bag>
+  typename detail::nested_view_bag<Bag>::type make_nested_view(Bag const &bag) noexcept {
+    return detail::nested_view_bag<Bag>::make(bag);
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   // serialization<view>:
   
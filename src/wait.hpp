@@ -13,8 +13,9 @@ namespace upcxx {
   auto wait(future1<Kind, T...> const &f)
     -> decltype(f.result()) {
     
+    int idle = 0;
     while(!f.ready())
-      upcxx::progress();
+      detail::progress_wait(idle);
     
     return f.result();
   }
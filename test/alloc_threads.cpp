@@ -0,0 +1,96 @@
+#include <upcxx/upcxx.hpp>
+#include <upcxx/os_env.hpp>
+
+#include "util.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if !UPCXX_BACKEND_GASNET_PAR
+  #error "UPCXX_BACKEND=gasnet_par required."
+#endif
+
+// Many threads allocating and freeing small shared objects concurrently,
+// with half the frees issued by a thread other than the allocator, to
+// exercise the per-thread shared heap caches (UPCXX_USER_ALLOC_CACHE_SIZE).
+
+using namespace std;
+
+template<typename Fn>
+void run_threads(int tn, Fn &&fn) {
+  std::vector<std::thread*> ts;
+  ts.resize(tn);
+
+  for(int ti=1; ti < tn; ti++)
+    ts[ti] = new std::thread(fn, ti);
+  fn(0);
+
+  for(int ti=1; ti < tn; ti++) {
+    ts[ti]->join();
+    delete ts[ti];
+  }
+}
+
+int main() {
+  upcxx::init();
+  print_test_header();
+
+  const int tn = upcxx::os_env<int>("THREADS", 4);
+  const int objs = 2000;
+
+  if(upcxx::rank_me() == 0)
+    std::cout<<"Threads: "<<tn<<'\n';
+
+  // hand-off slots: thread ti frees the second half of thread (ti+1)%tn's objects
+  std::vector<std::vector<std::pair<char*,size_t>>> handoff(tn);
+  std::atomic<int> tbarrier(0);
+
+  run_threads(tn, [&](int ti) {
+    std::vector<std::pair<char*,size_t>> mine;
+
+    for(int round = 0; round < 3; round++) {
+      for(int i = 0; i < objs; i++) {
+        size_t size = 1 + (i*37 + ti*11 + round) % 3000;
+        char *p = (char*)upcxx::allocate(size, i % 3 == 0 ? 8 : 16);
+        UPCXX_ASSERT_ALWAYS(p != nullptr, "allocation failed");
+        UPCXX_ASSERT_ALWAYS(reinterpret_cast<uintptr_t>(p) % 8 == 0);
+        std::memset(p, char(ti*31 + i), size);
+        mine.push_back({p, size});
+
+        // interleave some frees so caches both fill and drain
+        if(i % 5 == 4) {
+          auto q = mine[mine.size()-2];
+          mine.erase(mine.end()-2);
+          for(size_t b = 0; b < q.second; b++)
+            UPCXX_ASSERT_ALWAYS(q.first[b] == char(ti*31 + i-1), "block overwritten");
+          upcxx::deallocate(q.first);
+        }
+      }
+      // typed objects take the same path
+      upcxx::global_ptr<double> d = upcxx::new_array<double>(3 + ti);
+      upcxx::delete_array(d);
+    }
+
+    handoff[ti].assign(mine.begin() + mine.size()/2, mine.end());
+    mine.resize(mine.size()/2);
+
+    tbarrier.fetch_add(1);
+    while(tbarrier.load() != tn)
+      sched_yield();
+
+    for(auto q: mine)
+      upcxx::deallocate(q.first);
+    for(auto q: handoff[(ti + 1) % tn])
+      upcxx::deallocate(q.first);
+  });
+
+  if(upcxx::rank_me() == 0)
+    std::cout << upcxx::detail::shared_heap_stats();
+
+  upcxx::barrier();
+  print_test_success();
+  upcxx::finalize();
+  return 0;
+}
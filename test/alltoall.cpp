@@ -0,0 +1,164 @@
+#include <upcxx/upcxx.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Runs alltoall and alltoallv over world, a split team and a created team
+// (which has no gasnet team of its own), at block sizes that take Bruck,
+// pairwise eager and pairwise rput, into private and shared-segment
+// buffers. One rank joins each exchange late so the others' blocks and
+// landing addresses arrive first.
+
+using upcxx::intrank_t;
+using upcxx::team;
+
+std::int64_t value(intrank_t from, intrank_t to, std::size_t i) {
+  return std::int64_t(from)*1000003 + std::int64_t(to)*1009 + std::int64_t(i);
+}
+
+void dawdle(team &tm) {
+  if(tm.rank_me() == tm.rank_n() - 1) {
+    auto t0 = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(10))
+      upcxx::progress();
+  }
+}
+
+void check_alltoall(team &tm, std::size_t count, bool shared_dst, char const *what) {
+  const intrank_t me = tm.rank_me(), n = tm.rank_n();
+
+  std::vector<std::int64_t> src(n*count);
+  for(intrank_t r=0; r < n; r++)
+    for(std::size_t i=0; i < count; i++)
+      src[r*count + i] = value(me, r, i);
+
+  upcxx::global_ptr<std::int64_t> dst_gp;
+  std::vector<std::int64_t> dst_vec;
+  std::int64_t *dst;
+  if(shared_dst) {
+    dst_gp = upcxx::new_array<std::int64_t>(n*count + 1);
+    dst = dst_gp.local();
+  }
+  else {
+    dst_vec.resize(n*count + 1);
+    dst = dst_vec.data();
+  }
+  std::fill(dst, dst + n*count + 1, -1);
+
+  dawdle(tm);
+  upcxx::alltoall(src.data(), dst, count, tm).wait();
+
+  for(intrank_t r=0; r < n; r++)
+    for(std::size_t i=0; i < count; i++)
+      UPCXX_ASSERT_ALWAYS(dst[r*count + i] == value(r, me, i),
+        what << ": count " << count << " block from " << r << "[" << i << "] is " << dst[r*count + i]);
+  UPCXX_ASSERT_ALWAYS(dst[n*count] == -1, what << ": count " << count << " wrote past the end");
+
+  if(shared_dst)
+    upcxx::delete_array(dst_gp);
+}
+
+// Rank r sends (r + s) % 4 * scale elements to rank s, some of them none.
+void check_alltoallv(team &tm, std::size_t scale, char const *what) {
+  const intrank_t me = tm.rank_me(), n = tm.rank_n();
+  auto count_of = [=](intrank_t from, intrank_t to) {
+    return std::size_t((from + to) % 4)*scale;
+  };
+
+  std::vector<std::size_t> send_counts(n), send_displs(n), recv_counts(n), recv_displs(n);
+  std::size_t send_n = 0, recv_n = 0;
+  // sends packed back to front, receives with a gap between blocks
+  for(intrank_t r=n; r-- > 0;) {
+    send_counts[r] = count_of(me, r);
+    send_displs[r] = send_n;
+    send_n += send_counts[r];
+  }
+  for(intrank_t r=0; r < n; r++) {
+    recv_counts[r] = count_of(r, me);
+    recv_displs[r] = recv_n;
+    recv_n += recv_counts[r] + 1;
+  }
+
+  std::vector<std::int64_t> src(send_n), dst(recv_n, -1);
+  for(intrank_t r=0; r < n; r++)
+    for(std::size_t i=0; i < send_counts[r]; i++)
+      src[send_displs[r] + i] = value(me, r, i);
+
+  dawdle(tm);
+  upcxx::future<> done = upcxx::alltoallv(
+    src.data(), send_counts.data(), send_displs.data(),
+    dst.data(), recv_counts.data(), recv_displs.data(),
+    tm
+  );
+  // the arrays need not outlive the call
+  send_counts.assign(n, 0);
+  recv_displs.assign(n, 0);
+  done.wait();
+
+  std::size_t at = 0;
+  for(intrank_t r=0; r < n; r++) {
+    for(std::size_t i=0; i < count_of(r, me); i++, at++)
+      UPCXX_ASSERT_ALWAYS(dst[at] == value(r, me, i),
+        what << ": alltoallv scale " << scale << " block from " << r << "[" << i << "] is " << dst[at]);
+    UPCXX_ASSERT_ALWAYS(dst[at++] == -1, what << ": alltoallv scale " << scale << " overran block from " << r);
+  }
+}
+
+void check_team(team &tm, char const *what) {
+  // 2 and 16 elements take Bruck, 100 pairwise eager, 5000 pairwise rput
+  for(std::size_t count: {0, 1, 2, 16, 100, 5000}) {
+    check_alltoall(tm, count, false, what);
+    check_alltoall(tm, count, true, what);
+  }
+
+  for(std::size_t scale: {1, 50, 2000})
+    check_alltoallv(tm, scale, what);
+
+  // several in flight at once
+  const intrank_t n = tm.rank_n();
+  std::vector<std::vector<std::int64_t>> srcs(4), dsts(4);
+  upcxx::future<> all = upcxx::make_future();
+  for(int k=0; k < 4; k++) {
+    std::size_t count = k % 2 ? 3 : 1500;
+    srcs[k].assign(n*count, k);
+    dsts[k].assign(n*count, -1);
+    all = upcxx::when_all(all, upcxx::alltoall(srcs[k].data(), dsts[k].data(), count, tm));
+  }
+  all.wait();
+  for(int k=0; k < 4; k++)
+    for(std::int64_t x: dsts[k])
+      UPCXX_ASSERT_ALWAYS(x == k, what << ": overlapped alltoall " << k << " gave " << x);
+
+  upcxx::barrier(tm);
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const intrank_t me = upcxx::rank_me(), n = upcxx::rank_n();
+  team &world = upcxx::world();
+
+  check_team(world, "world");
+
+  team halves = world.split(me % 2, -me);
+  check_team(halves, "split");
+  halves.destroy();
+
+  std::vector<intrank_t> mine;
+  for(intrank_t w = me % 2; w < n; w += 2)
+    mine.push_back(w);
+  team created = world.create(mine);
+  check_team(created, "create");
+  created.destroy();
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "util.hpp"
+
+// Builds a distributed histogram with atomic_domain's bulk operations and
+// checks it against counts every rank keeps on the side. inc_bulk and
+// add_bulk hit duplicate addresses within a batch (which add_bulk may
+// combine), and fetch_add_bulk on a shared counter must hand out each value
+// below the total exactly once. atomic_bulk_gex.cpp and atomic_bulk_am.cpp
+// rerun it with GASNet atomics forced, and with every batch shipped to its
+// target rank, through ATOMIC_BULK_SETUP.
+
+using upcxx::atomic_op;
+using upcxx::global_ptr;
+
+template<typename T>
+void check(char const *name) {
+  const int me = upcxx::rank_me(), n = upcxx::rank_n();
+  if(me == 0)
+    std::cout << "Testing " << name << std::endl;
+
+  upcxx::atomic_domain<T> ad({atomic_op::inc, atomic_op::add, atomic_op::fetch_add, atomic_op::load});
+
+  const int bins = 16, hits = 1000;
+  global_ptr<T> mine = upcxx::new_array<T>(bins);
+  for(int b=0; b < bins; b++) mine.local()[b] = T(0);
+  upcxx::dist_object<global_ptr<T>> hist(mine);
+
+  std::vector<global_ptr<T>> base(n);
+  for(int r=0; r < n; r++)
+    base[r] = hist.fetch(r).wait();
+  upcxx::barrier();
+
+  // expected[r*bins + b], summed over ranks at the end
+  std::vector<long> expected(n*bins, 0);
+  std::mt19937 rng(me);
+
+  std::vector<global_ptr<T>> where(hits);
+  std::vector<T> amount(hits);
+  for(int i=0; i < hits; i++) {
+    int r = rng() % n, b = rng() % 4; // few bins so batches repeat addresses
+    where[i] = base[r] + b;
+    expected[r*bins + b] += 1;
+  }
+  ad.inc_bulk(where.data(), hits, std::memory_order_relaxed).wait();
+
+  for(int i=0; i < hits; i++) {
+    int r = rng() % n, b = 4 + rng() % (bins-4);
+    where[i] = base[r] + b;
+    amount[i] = T(1 + rng() % 3);
+    expected[r*bins + b] += long(amount[i]);
+  }
+  ad.add_bulk(where.data(), amount.data(), hits, std::memory_order_relaxed).wait();
+
+  // an empty batch is fine too
+  ad.add_bulk(nullptr, nullptr, 0, std::memory_order_relaxed).wait();
+
+  upcxx::barrier();
+
+  for(int r=0; r < n; r++) {
+    for(int b=0; b < bins; b++) {
+      long want = upcxx::reduce_one(expected[r*bins + b], upcxx::op_fast_add, r).wait();
+      if(r == me) {
+        T got = ad.load(mine + b, std::memory_order_relaxed).wait();
+        UPCXX_ASSERT_ALWAYS(long(got) == want,
+          "rank " << me << " bin " << b << " holds " << long(got) << " expected " << want);
+      }
+    }
+  }
+  upcxx::barrier();
+
+  // every rank takes tickets from rank 0's bin 0, reset to 0 first
+  if(me == 0) mine.local()[0] = T(0);
+  upcxx::barrier();
+
+  const int tickets = 50;
+  std::vector<global_ptr<T>> counter(tickets, base[0]);
+  std::vector<T> ones(tickets, T(1)), got(tickets);
+  ad.fetch_add_bulk(counter.data(), ones.data(), got.data(), tickets, std::memory_order_relaxed).wait();
+
+  upcxx::dist_object<std::vector<T>> all(got);
+  if(me == 0) {
+    std::vector<int> seen(n*tickets, 0);
+    for(int r=0; r < n; r++) {
+      for(T t: all.fetch(r).wait()) {
+        UPCXX_ASSERT_ALWAYS(0 <= long(t) && long(t) < n*tickets, "ticket " << long(t) << " out of range");
+        seen[long(t)] += 1;
+      }
+    }
+    for(int t=0; t < n*tickets; t++)
+      UPCXX_ASSERT_ALWAYS(seen[t] == 1, "ticket " << t << " handed out " << seen[t] << " times");
+  }
+  upcxx::barrier();
+
+  ad.destroy();
+  upcxx::delete_array(mine);
+}
+
+#ifndef ATOMIC_BULK_SETUP
+  #define ATOMIC_BULK_SETUP()
+#endif
+
+int main() {
+  ATOMIC_BULK_SETUP();
+  upcxx::init();
+
+  print_test_header();
+
+  check<std::int32_t>("int32_t");
+  check<std::uint64_t>("uint64_t");
+  check<long long>("long long"); // may differ from the domain's proxy type
+  check<double>("double");
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
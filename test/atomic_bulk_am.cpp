@@ -0,0 +1,10 @@
+// atomic_bulk.cpp with CPU atomics disabled and every batch shipped to its
+// target rank, so a run on one node takes the path used for off-node
+// targets, operand combining included.
+#include <cstdlib>
+
+#define ATOMIC_BULK_SETUP() ( \
+    setenv("UPCXX_CPU_ATOMICS", "0", /*overwrite=*/0), \
+    setenv("UPCXX_BULK_ATOMICS_LOCAL", "0", /*overwrite=*/0) \
+  )
+#include "atomic_bulk.cpp"
@@ -0,0 +1,6 @@
+// atomic_bulk.cpp with CPU atomics disabled, so a run on one node takes
+// gasnet's NBI access regions.
+#include <cstdlib>
+
+#define ATOMIC_BULK_SETUP() setenv("UPCXX_CPU_ATOMICS", "0", /*overwrite=*/0)
+#include "atomic_bulk.cpp"
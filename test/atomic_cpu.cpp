@@ -0,0 +1,178 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Checks every atomic_domain operation against a sequential model on each
+// rank's own slot, then has all ranks hammer one counter with fetching and
+// non-fetching ops under each completion kind. On a team confined to one
+// node (local_team(), or world under smp) the domain uses CPU atomics, so
+// a single progress() must deliver completion. UPCXX_CPU_ATOMICS=0 runs the
+// same checks through gasnet.
+
+using upcxx::atomic_op;
+using upcxx::global_ptr;
+using upcxx::team;
+
+const bool cpu_path = upcxx::os_env<bool>("UPCXX_CPU_ATOMICS", true);
+
+template<typename T>
+std::vector<atomic_op> ops_for() {
+  std::vector<atomic_op> ops = {
+    atomic_op::load, atomic_op::store, atomic_op::compare_exchange,
+    atomic_op::add, atomic_op::fetch_add, atomic_op::sub, atomic_op::fetch_sub,
+    atomic_op::inc, atomic_op::fetch_inc, atomic_op::dec, atomic_op::fetch_dec,
+    atomic_op::mul, atomic_op::fetch_mul, atomic_op::min, atomic_op::fetch_min,
+    atomic_op::max, atomic_op::fetch_max
+  };
+  if(std::is_integral<T>::value) {
+    for(atomic_op op: {atomic_op::bit_and, atomic_op::fetch_bit_and,
+                       atomic_op::bit_or, atomic_op::fetch_bit_or,
+                       atomic_op::bit_xor, atomic_op::fetch_bit_xor})
+      ops.push_back(op);
+  }
+  return ops;
+}
+
+template<typename Fut, typename T>
+void expect(Fut f, T want, char const *what) {
+  upcxx::progress();
+  UPCXX_ASSERT_ALWAYS(!cpu_path || f.ready(), what << " not ready after one progress");
+  T got = f.wait();
+  UPCXX_ASSERT_ALWAYS(got == want, what << " fetched " << got << " expected " << want);
+}
+
+template<typename Fut>
+void expect_done(Fut f, char const *what) {
+  upcxx::progress();
+  UPCXX_ASSERT_ALWAYS(!cpu_path || f.ready(), what << " not ready after one progress");
+  f.wait();
+}
+
+template<typename T, bool integral = std::is_integral<T>::value>
+struct bitwise {
+  static void check(upcxx::atomic_domain<T> &, global_ptr<T>, T &) {}
+};
+
+template<typename T>
+struct bitwise<T, true> {
+  static void check(upcxx::atomic_domain<T> &ad, global_ptr<T> p, T &model) {
+    auto mo = std::memory_order_acq_rel;
+    expect(ad.fetch_bit_or(p, T(0x5a), mo), model, "fetch_bit_or"); model |= T(0x5a);
+    expect_done(ad.bit_and(p, T(0x4e), mo), "bit_and"); model &= T(0x4e);
+    expect(ad.fetch_bit_xor(p, T(0x33), mo), model, "fetch_bit_xor"); model ^= T(0x33);
+    expect_done(ad.bit_or(p, T(0x80), mo), "bit_or"); model |= T(0x80);
+    expect(ad.fetch_bit_and(p, T(0xf0), mo), model, "fetch_bit_and"); model &= T(0xf0);
+    expect_done(ad.bit_xor(p, T(0x0f), mo), "bit_xor"); model ^= T(0x0f);
+  }
+};
+
+template<typename T>
+void check_ops(team &tm) {
+  upcxx::atomic_domain<T> ad(ops_for<T>(), tm);
+
+  global_ptr<T> mine = upcxx::new_<T>(T(0));
+  upcxx::dist_object<global_ptr<T>> slots(mine, tm);
+  // operate on the next rank's slot so the target is not always us
+  global_ptr<T> p = slots.fetch((tm.rank_me() + 1) % tm.rank_n()).wait();
+  upcxx::barrier(tm);
+
+  T model = T(0);
+  auto rlx = std::memory_order_relaxed;
+  auto acq = std::memory_order_acquire;
+  auto rel = std::memory_order_release;
+
+  expect_done(ad.store(p, T(7), rel), "store"); model = T(7);
+  expect(ad.load(p, acq), model, "load");
+  expect(ad.fetch_add(p, T(5), rlx), model, "fetch_add"); model += T(5);
+  expect_done(ad.add(p, T(3), rlx), "add"); model += T(3);
+  expect(ad.fetch_sub(p, T(2), rlx), model, "fetch_sub"); model -= T(2);
+  expect_done(ad.sub(p, T(1), rlx), "sub"); model -= T(1);
+  expect(ad.fetch_inc(p, rlx), model, "fetch_inc"); model += T(1);
+  expect_done(ad.inc(p, rlx), "inc"); model += T(1);
+  expect(ad.fetch_dec(p, rlx), model, "fetch_dec"); model -= T(1);
+  expect_done(ad.dec(p, rlx), "dec"); model -= T(1);
+  expect(ad.fetch_mul(p, T(3), rlx), model, "fetch_mul"); model *= T(3);
+  expect_done(ad.mul(p, T(2), rlx), "mul"); model *= T(2);
+  expect(ad.fetch_min(p, T(100), rlx), model, "fetch_min"); model = model < T(100) ? model : T(100);
+  expect_done(ad.min(p, T(20), rlx), "min"); model = model < T(20) ? model : T(20);
+  expect(ad.fetch_max(p, T(50), rlx), model, "fetch_max"); model = model > T(50) ? model : T(50);
+  expect_done(ad.max(p, T(10), rlx), "max"); model = model > T(10) ? model : T(10);
+  expect(ad.compare_exchange(p, T(1), T(2), rlx), model, "failing compare_exchange");
+  expect(ad.compare_exchange(p, model, T(60), rlx), model, "compare_exchange"); model = T(60);
+  bitwise<T>::check(ad, p, model);
+  expect(ad.load(p, rlx), model, "final load");
+
+  upcxx::barrier(tm);
+
+  // everyone hammers the slot of team rank 0, through each completion kind
+  global_ptr<T> hot = slots.fetch(0).wait();
+  if(tm.rank_me() == 0)
+    ad.store(hot, T(0), rlx).wait();
+  upcxx::barrier(tm);
+
+  const int iters = 200;
+  upcxx::promise<> pro;
+  int lpcs = 0;
+  for(int i=0; i < iters; i++) {
+    switch(i % 4) {
+    case 0:
+      ad.add(hot, T(1), rlx).wait();
+      break;
+    case 1:
+      ad.inc(hot, rlx, upcxx::operation_cx::as_promise(pro));
+      break;
+    case 2:
+      ad.fetch_add(hot, T(1), rlx,
+        upcxx::operation_cx::as_lpc(upcxx::current_persona(), [&](T) { lpcs += 1; }));
+      break;
+    case 3:
+      ad.fetch_inc(hot, rlx).wait();
+      break;
+    }
+  }
+  pro.finalize().wait();
+  while(lpcs != iters/4)
+    upcxx::progress();
+
+  upcxx::barrier(tm);
+  if(tm.rank_me() == 0) {
+    T total = ad.load(hot, std::memory_order_acquire).wait();
+    UPCXX_ASSERT_ALWAYS(total == T(iters*tm.rank_n()),
+      "hot counter reached " << total << " expected " << iters*tm.rank_n());
+  }
+  upcxx::barrier(tm);
+
+  ad.destroy();
+  upcxx::delete_(mine);
+}
+
+template<typename T>
+void check_type(char const *name) {
+  if(upcxx::rank_me() == 0)
+    std::cout << "Testing " << name << std::endl;
+  check_ops<T>(upcxx::world());
+  check_ops<T>(upcxx::local_team());
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  check_type<std::int32_t>("int32_t");
+  check_type<std::uint32_t>("uint32_t");
+  check_type<std::int64_t>("int64_t");
+  check_type<std::uint64_t>("uint64_t");
+  check_type<float>("float");
+  check_type<double>("double");
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
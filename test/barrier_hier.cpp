@@ -0,0 +1,106 @@
+#include <upcxx/upcxx.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "util.hpp"
+
+// Runs with UPCXX_BARRIER=hier (unless overridden in the environment) and
+// checks that world barriers still separate phases when ranks arrive skewed,
+// that several barrier_async's in flight complete in order, and that
+// barriers over other teams, which keep using gasnet, interleave with them.
+// Variants force other settings through BARRIER_HIER_SETUP.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+#ifndef BARRIER_HIER_SETUP
+  #define BARRIER_HIER_SETUP()
+#endif
+
+int main() {
+  setenv("UPCXX_BARRIER", "hier", /*overwrite=*/0);
+  BARRIER_HIER_SETUP();
+
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+
+  upcxx::global_ptr<int> cells = upcxx::new_array<int>(n);
+  for(int r=0; r < n; r++) cells.local()[r] = -1;
+  upcxx::dist_object<upcxx::global_ptr<int>> all_cells(cells);
+
+  std::vector<upcxx::global_ptr<int>> peer_cells(n);
+  for(int r=0; r < n; r++)
+    peer_cells[r] = all_cells.fetch(r).wait();
+  upcxx::barrier();
+
+  if(me == 0)
+    std::cout << "Skewed blocking barriers" << std::endl;
+
+  const int rounds = 50;
+  for(int i=0; i < rounds; i++) {
+    // one rank per round shows up late
+    if(i % n == me)
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    for(int r=0; r < n; r++)
+      upcxx::rput(i, peer_cells[r] + me).wait();
+
+    upcxx::barrier();
+
+    for(int r=0; r < n; r++)
+      UPCXX_ASSERT_ALWAYS(cells.local()[r] == i,
+        "round " << i << ": cell of rank " << r << " holds " << cells.local()[r]);
+
+    upcxx::barrier();
+  }
+
+  if(me == 0)
+    std::cout << "barrier_async's in flight" << std::endl;
+
+  const int depth = 8;
+  for(int i=0; i < rounds; i++) {
+    int done = 0;
+    std::vector<upcxx::future<>> futs;
+    for(int d=0; d < depth; d++) {
+      futs.push_back(upcxx::barrier_async().then([&done, d]() {
+        UPCXX_ASSERT_ALWAYS(done == d, "barrier_async " << d << " completed after " << done << " others");
+        done += 1;
+      }));
+    }
+    if(i % n == me)
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    for(upcxx::future<> &f: futs)
+      f.wait();
+    UPCXX_ASSERT_ALWAYS(done == depth);
+  }
+
+  if(me == 0)
+    std::cout << "Mixed with other teams" << std::endl;
+
+  upcxx::team &local = upcxx::local_team();
+  upcxx::team halves = upcxx::world().split(me % 2, me);
+  for(int i=0; i < rounds; i++) {
+    upcxx::future<> f = upcxx::barrier_async();
+    upcxx::barrier(local);
+    upcxx::barrier_async(halves).wait();
+    upcxx::barrier();
+    f.wait();
+  }
+  halves.destroy();
+
+  upcxx::barrier();
+  upcxx::delete_array(cells);
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
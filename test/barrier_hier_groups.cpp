@@ -0,0 +1,6 @@
+// barrier_hier.cpp with barrier groups of two ranks, so a run on one node
+// has several leaders and takes the dissemination rounds between them.
+#include <cstdlib>
+
+#define BARRIER_HIER_SETUP() setenv("UPCXX_BARRIER_GROUP_SIZE", "2", /*overwrite=*/0)
+#include "barrier_hier.cpp"
@@ -0,0 +1,70 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "util.hpp"
+
+// Broadcasts small (eager) and large (rendezvous) values from every root over
+// world, a strided split of world, and local_team, with small tree radices
+// so that even modest rank counts get multi-level trees. Defaults can be
+// overridden with UPCXX_BCAST_RADIX and UPCXX_BCAST_LOCAL_RADIX.
+
+using upcxx::team;
+
+int check_team(team &tm) {
+  int checks = 0;
+
+  for(int root = 0; root < tm.rank_n(); root++) {
+    int small = upcxx::broadcast(1000*root + 7, root, tm).wait();
+    UPCXX_ASSERT_ALWAYS(small == 1000*root + 7, "eager bcast from " << root << " got " << small);
+
+    std::vector<int> big;
+    if(tm.rank_me() == root) {
+      big.resize(64<<10);
+      std::iota(big.begin(), big.end(), root);
+    }
+    big = upcxx::broadcast_nontrivial(std::move(big), root, tm).wait();
+    UPCXX_ASSERT_ALWAYS(big.size() == 64<<10, "rdzv bcast from " << root << " size " << big.size());
+    for(int i = 0; i < (int)big.size(); i++)
+      UPCXX_ASSERT_ALWAYS(big[i] == root + i, "rdzv bcast from " << root << " corrupt at " << i);
+
+    checks += 2;
+  }
+
+  return checks;
+}
+
+int main() {
+  setenv("UPCXX_BCAST_RADIX", "2", /*overwrite=*/0);
+  setenv("UPCXX_BCAST_LOCAL_RADIX", "2", 0);
+
+  upcxx::init();
+
+  print_test_header();
+
+  int checks = 0;
+
+  checks += check_team(upcxx::world());
+
+  {
+    int me = upcxx::rank_me();
+    team strided = upcxx::world().split(me % 2, upcxx::rank_n() - me);
+    checks += check_team(strided);
+    strided.destroy();
+  }
+
+  checks += check_team(upcxx::local_team());
+
+  upcxx::barrier();
+
+  if(upcxx::rank_me() == 0)
+    std::cout << "Checked " << checks << " broadcasts on rank 0" << std::endl;
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "util.hpp"
+
+// Latency-bound rpc pipelines written as C++20 coroutines that co_await
+// upcxx futures. bld/tests.mak builds it with -std=c++20. A compiler without
+// coroutine support only checks that upcxx.hpp still compiles, and the test
+// reports itself SKIPPED rather than SUCCESS.
+
+#if UPCXX_COROUTINES
+
+using upcxx::future;
+
+// each hop is one rpc whose result feeds the next
+future<long> ring_walk(int hops, long token) {
+  const int n = upcxx::rank_n();
+  int at = upcxx::rank_me();
+
+  for(int h = 0; h < hops; h++) {
+    at = (at + 1) % n;
+    token = co_await upcxx::rpc(at, [](long t) { return t + upcxx::rank_me(); }, token);
+  }
+
+  co_return token;
+}
+
+future<> put_then_check(upcxx::global_ptr<int> cell, int value) {
+  co_await upcxx::rput(value, cell);
+  int got = co_await upcxx::rget(cell);
+  UPCXX_ASSERT_ALWAYS(got == value, "rget saw " << got << " after rput of " << value);
+}
+
+future<std::string, int> pair_of(int x) {
+  co_await upcxx::make_future();
+  co_return std::tuple<std::string, int>{std::to_string(x), x};
+}
+
+// awaits another coroutine, a multi-valued future and a ready future
+future<int> nested(int x) {
+  std::tuple<std::string, int> p = co_await pair_of(x);
+  int twice = co_await upcxx::make_future(2*x);
+  co_return int(std::get<0>(p).size()) + std::get<1>(p) + twice;
+}
+
+// suspends on a promise fulfilled by someone else, possibly much later
+future<std::vector<int>> await_promise(upcxx::promise<std::vector<int>> pro) {
+  std::vector<int> v = co_await pro.get_future();
+  v.push_back(-1);
+  co_return v;
+}
+
+#endif
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  #if UPCXX_COROUTINES
+  {
+    const int me = upcxx::rank_me();
+    const int n = upcxx::rank_n();
+
+    // ring walks: hop h adds the rank it lands on
+    const int hops = 3*n;
+    long expect = me;
+    for(int h = 1; h <= hops; h++)
+      expect += (me + h) % n;
+
+    std::vector<future<long>> walks;
+    for(int i = 0; i < 10; i++)
+      walks.push_back(ring_walk(hops, me + i));
+    for(int i = 0; i < 10; i++)
+      UPCXX_ASSERT_ALWAYS(walks[i].wait() == expect + i, "walk " << i << " got " << walks[i].result());
+
+    upcxx::global_ptr<int> mine = upcxx::new_<int>(0);
+    upcxx::dist_object<upcxx::global_ptr<int>> dobj(mine);
+    upcxx::global_ptr<int> theirs = dobj.fetch((me + 1) % n).wait();
+    upcxx::barrier();
+    for(int i = 0; i < 20; i++)
+      put_then_check(theirs, 1000*me + i).wait();
+
+    UPCXX_ASSERT_ALWAYS(nested(12).wait() == 2 + 12 + 24);
+
+    upcxx::promise<std::vector<int>> pro;
+    future<std::vector<int>> v = await_promise(pro);
+    UPCXX_ASSERT_ALWAYS(!v.ready());
+    pro.fulfill_result(std::vector<int>{1, 2, 3});
+    UPCXX_ASSERT_ALWAYS(!v.ready()); // resumption waits for user progress
+    std::vector<int> got = v.wait();
+    UPCXX_ASSERT_ALWAYS(got.size() == 4 && got[2] == 3 && got[3] == -1);
+
+    upcxx::barrier();
+    upcxx::delete_(mine);
+  }
+  #else
+    // say so where the test runners collect results rather than pass
+    upcxx::barrier();
+    if(upcxx::rank_me() == 0)
+      std::cout << KLGREEN << "Test result: SKIPPED (compiled without C++20 coroutines)" << KNORM << std::endl;
+    upcxx::finalize();
+    return 0;
+  #endif
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <upcxx/upcxx.hpp>
+#include <upcxx/dist_array.hpp>
+
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include "util.hpp"
+
+// Fills dist_array tiles with a function of the global index, exchanges
+// ghosts, and checks every face ghost against that function, for block and
+// block-cyclic layouts in 1, 2 and 3 dimensions, periodic or not. Also
+// checks owner() and local_ptr() agree with the tiles.
+
+using upcxx::dist_array;
+
+template<int Dim>
+double value_at(std::array<std::ptrdiff_t, Dim> const &i, std::array<std::size_t, Dim> const &ext) {
+  double x = 0;
+  for(int d=0; d < Dim; d++)
+    x = x*double(ext[d]) + double(i[d]);
+  return x;
+}
+
+// visits every index in the box [lo, hi)
+template<int Dim, typename Fn>
+void for_box(std::array<std::ptrdiff_t, Dim> lo, std::array<std::ptrdiff_t, Dim> hi, Fn fn) {
+  for(int d=0; d < Dim; d++)
+    if(lo[d] >= hi[d]) return;
+
+  std::array<std::ptrdiff_t, Dim> i = lo;
+  while(true) {
+    fn(i);
+    int d = Dim-1;
+    for(; d >= 0; d--) {
+      if(++i[d] < hi[d]) break;
+      i[d] = lo[d];
+    }
+    if(d < 0) return;
+  }
+}
+
+template<int Dim>
+void check(dist_array<double, Dim> &a, bool periodic) {
+  using index = std::array<std::ptrdiff_t, Dim>;
+  auto const &ext = a.extent();
+  const std::ptrdiff_t g = a.ghost();
+
+  std::size_t owned = 0;
+  for(std::size_t t=0; t < a.tile_n(); t++) {
+    auto tile = a.local_tile(t);
+    for_box<Dim>(tile.lo(), tile.hi(), [&](index const &i) {
+      tile[i] = value_at<Dim>(i, ext);
+      UPCXX_ASSERT_ALWAYS(a.owner(i) == upcxx::rank_me());
+      UPCXX_ASSERT_ALWAYS(a.local_ptr(i) == &tile[i]);
+      owned += 1;
+    });
+  }
+
+  index zero{}, top;
+  for(int d=0; d < Dim; d++) top[d] = std::ptrdiff_t(ext[d]);
+  std::size_t total = 0;
+  for_box<Dim>(zero, top, [&](index const &i) {
+    total += 1;
+    UPCXX_ASSERT_ALWAYS((a.owner(i) == upcxx::rank_me()) == (a.local_ptr(i) != nullptr));
+  });
+  total = upcxx::reduce_all(owned, upcxx::op_fast_add).wait() == total ? total : 0;
+  UPCXX_ASSERT_ALWAYS(total != 0, "tiles do not cover the array exactly once");
+
+  for(int round=0; round < 2; round++) {
+    a.exchange();
+
+    std::size_t checked = 0;
+    for(std::size_t t=0; t < a.tile_n(); t++) {
+      auto tile = a.local_tile(t);
+      for(int d=0; d < Dim; d++) {
+        for(int side: {-1, +1}) {
+          index lo = tile.lo(), hi = tile.hi();
+          if(side < 0) { lo[d] = tile.lo()[d] - g; hi[d] = tile.lo()[d]; }
+          else         { lo[d] = tile.hi()[d]; hi[d] = tile.hi()[d] + g; }
+
+          for_box<Dim>(lo, hi, [&](index const &i) {
+            index w = i;
+            if(w[d] < 0 || w[d] >= std::ptrdiff_t(ext[d])) {
+              if(!periodic) return;
+              w[d] = (w[d] + std::ptrdiff_t(ext[d])) % std::ptrdiff_t(ext[d]);
+            }
+            UPCXX_ASSERT_ALWAYS(tile[i] == value_at<Dim>(w, ext),
+              "rank " << upcxx::rank_me() << " dim " << d << " side " << side <<
+              " ghost holds " << tile[i] << " expected " << value_at<Dim>(w, ext));
+            checked += 1;
+          });
+        }
+      }
+    }
+    UPCXX_ASSERT_ALWAYS(g == 0 || a.tile_n() == 0 || !periodic || checked != 0);
+
+    // change the interior so the second round can't pass on stale ghosts
+    for(std::size_t t=0; t < a.tile_n(); t++) {
+      auto tile = a.local_tile(t);
+      for_box<Dim>(tile.lo(), tile.hi(), [&](index const &i) { tile[i] = -1; });
+    }
+    upcxx::barrier();
+    for(std::size_t t=0; t < a.tile_n(); t++) {
+      auto tile = a.local_tile(t);
+      for_box<Dim>(tile.lo(), tile.hi(), [&](index const &i) { tile[i] = value_at<Dim>(i, ext); });
+    }
+  }
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int n = upcxx::rank_n();
+  int p0 = 1;
+  for(int p = 1; p*p <= n; p++)
+    if(n % p == 0) p0 = p;
+  const int p1 = n / p0;
+
+  {
+    dist_array<double, 1> a({{std::size_t(25*n + 3)}}, {{n}}, /*ghost=*/2, /*periodic=*/true);
+    check(a, true);
+  }
+  {
+    dist_array<double, 1> a(upcxx::world(), {{101}}, {{n}}, {{7}}, /*ghost=*/3, /*periodic=*/true);
+    check(a, true);
+  }
+  {
+    dist_array<double, 2> a({{37, 29}}, {{p0, p1}}, /*ghost=*/1);
+    check(a, false);
+  }
+  {
+    dist_array<double, 2> a(upcxx::world(), {{37, 30}}, {{p0, p1}}, {{5, 4}}, /*ghost=*/2, /*periodic=*/true);
+    check(a, true);
+  }
+  {
+    dist_array<double, 3> a({{8, 9, 10}}, {{n, 1, 1}}, /*ghost=*/1, /*periodic=*/true);
+    check(a, true);
+  }
+  {
+    dist_array<double, 3> a(upcxx::world(), {{11, 6, 9}}, {{p1, 1, p0}}, {{3, 4, 2}}, /*ghost=*/1);
+    check(a, false);
+  }
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
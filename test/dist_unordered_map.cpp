@@ -0,0 +1,113 @@
+#include <upcxx/upcxx.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// Exercises upcxx::dist_unordered_map: batched inserts with futures and
+// fire-and-forget, batched finds of present and absent keys, and iteration
+// of the local shard. Small batch sizes force batches out mid-loop as well
+// as from the progress-time flush.
+
+using upcxx::dist_unordered_map;
+using upcxx::future;
+
+std::string key_of(int i) {
+  return "key-" + std::to_string(i);
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = upcxx::rank_me();
+  const int n = upcxx::rank_n();
+  const int per_rank = 2000;
+
+  // int -> long, inserts with futures
+  {
+    dist_unordered_map<int, long> map(upcxx::world(), /*batch_n=*/37);
+
+    std::vector<future<>> done;
+    for(int i = 0; i < per_rank; i++) {
+      int k = me*per_rank + i;
+      done.push_back(map.insert(k, 3L*k));
+    }
+    upcxx::when_all(done.begin(), done.end()).wait();
+
+    // a second insert of an existing key leaves the first value
+    map.insert(me*per_rank, -1).wait();
+
+    upcxx::barrier();
+
+    long local_n = 0;
+    for(auto const &kv: map.local()) {
+      UPCXX_ASSERT_ALWAYS(map.owner_of(kv.first) == me);
+      UPCXX_ASSERT_ALWAYS(kv.second == 3L*kv.first);
+      local_n += 1;
+    }
+    UPCXX_ASSERT_ALWAYS(local_n == (long)map.local().size());
+    long total = upcxx::reduce_all(local_n, upcxx::op_fast_add).wait();
+    UPCXX_ASSERT_ALWAYS(total == long(n)*per_rank, "map holds " << total);
+
+    // every rank looks up a slice of everybody's keys, plus some absent ones
+    std::vector<future<bool, long>> found;
+    for(int i = 0; i < per_rank; i++)
+      found.push_back(map.find((i*7919 + me) % (n*per_rank)));
+    for(int i = 0; i < 100; i++)
+      found.push_back(map.find(-1 - i));
+
+    for(int i = 0; i < per_rank; i++) {
+      long k = (i*7919 + me) % (n*per_rank);
+      UPCXX_ASSERT_ALWAYS(found[i].wait<0>() && found[i].wait<1>() == 3*k,
+        "find(" << k << ") gave " << found[i].wait<1>());
+    }
+    for(int i = per_rank; i < per_rank + 100; i++)
+      UPCXX_ASSERT_ALWAYS(!found[i].wait<0>() && found[i].wait<1>() == 0);
+
+    upcxx::barrier();
+  }
+
+  // string -> string, fire-and-forget inserts with counted quiescence
+  {
+    dist_unordered_map<std::string, std::string> map;
+
+    std::vector<long> sent(n, 0);
+    for(int i = me; i < n*per_rank; i += n) {
+      std::string k = key_of(i);
+      sent[map.owner_of(k)] += 1;
+      map.insert_ff(k, std::string(i % 50, 'v'));
+    }
+    map.flush();
+
+    long expect = 0;
+    for(int r = 0; r < n; r++) {
+      long x = upcxx::reduce_one(sent[r], upcxx::op_fast_add, r).wait();
+      if(r == me) expect = x;
+    }
+    while((long)map.local().size() != expect)
+      upcxx::progress();
+
+    upcxx::barrier();
+
+    for(int i = 0; i < 300; i++) {
+      int k = (i*31 + me*17) % (n*per_rank);
+      map.find(key_of(k)).then([=](bool found, std::string const &v) {
+        UPCXX_ASSERT_ALWAYS(found && v == std::string(k % 50, 'v'));
+      }).wait();
+    }
+
+    std::string const *v = map.local().find(key_of(-5));
+    UPCXX_ASSERT_ALWAYS(v == nullptr);
+
+    upcxx::barrier();
+  }
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Keeps thousands of rput's and rget's in flight at once, a share of them
+// with source, operation and remote completions chained on one another, and
+// checks each completion fires once with the right data visible.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+long remote_hits = 0;
+
+int main() {
+  upcxx::init();
+  
+  print_test_header();
+  
+  const int me = rank_me();
+  const int n = rank_n();
+  const int slots = 4096;
+  const int rounds = 3;
+  
+  upcxx::global_ptr<long> mine = upcxx::new_array<long>(slots);
+  upcxx::dist_object<upcxx::global_ptr<long>> dobj(mine);
+  upcxx::global_ptr<long> theirs = dobj.fetch((me + 1) % n).wait();
+  upcxx::barrier();
+  
+  long expect_remote = 0;
+  
+  for(int r = 0; r < rounds; r++) {
+    int src_n = 0, op_n = 0;
+    std::vector<long> vals(slots);
+    upcxx::future<> all = upcxx::make_future();
+    
+    for(int i = 0; i < slots; i++) {
+      vals[i] = long(r)*slots + i;
+      
+      if(i % 3 == 0) {
+        // source completion first, then operation and remote ones
+        upcxx::future<> src, op;
+        std::tie(src, op) = upcxx::rput(&vals[i], theirs + i, 1,
+          upcxx::source_cx::as_future() |
+          upcxx::operation_cx::as_future() |
+          upcxx::remote_cx::as_rpc([]() { remote_hits += 1; })
+        );
+        all = upcxx::when_all(all,
+          src.then([&]() { src_n += 1; }),
+          op.then([&]() { op_n += 1; })
+        );
+        expect_remote += 1;
+      }
+      else
+        all = upcxx::when_all(all, upcxx::rput(vals[i], theirs + i).then([&]() { op_n += 1; }));
+    }
+    
+    all.wait();
+    UPCXX_ASSERT_ALWAYS(src_n == (slots + 2)/3, "source completions " << src_n);
+    UPCXX_ASSERT_ALWAYS(op_n == slots, "operation completions " << op_n);
+    
+    upcxx::barrier();
+    
+    // read them all back, again all in flight at once
+    std::vector<long> got(slots, -1);
+    upcxx::future<> gets = upcxx::make_future();
+    for(int i = 0; i < slots; i++)
+      gets = upcxx::when_all(gets, upcxx::rget(theirs + i, &got[i], 1));
+    gets.wait();
+    
+    for(int i = 0; i < slots; i++)
+      UPCXX_ASSERT_ALWAYS(got[i] == long(r)*slots + i, "slot " << i << " read " << got[i]);
+    
+    upcxx::barrier();
+  }
+  
+  while(remote_hits != expect_remote)
+    upcxx::progress();
+  
+  upcxx::barrier();
+  upcxx::delete_array(mine);
+  
+  print_test_success();
+  
+  upcxx::finalize();
+  return 0;
+}
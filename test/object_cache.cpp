@@ -0,0 +1,80 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// Drives rput's, rpc's and promise/future chains in a steady-state loop and
+// checks the runtime's per-thread object cache (UPCXX_OBJECT_CACHE_SIZE)
+// serves their allocations, and that the results are still right.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+long received = 0;
+
+int main() {
+  setenv("UPCXX_PERF_COUNTERS_ENABLED", "1", /*overwrite=*/0); // checked below
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const int iters = 1000;
+  const int target = (me + 1) % n;
+
+  upcxx::global_ptr<long> mine = upcxx::new_array<long>(iters);
+  upcxx::dist_object<upcxx::global_ptr<long>> dobj(mine);
+  upcxx::global_ptr<long> theirs = dobj.fetch(target).wait();
+  upcxx::barrier();
+
+  upcxx::perf_counters c0 = upcxx::perf_counters_thread();
+
+  for(int i = 0; i < iters; i++) {
+    upcxx::promise<> pro;
+    upcxx::rput(long(i), theirs + i, upcxx::operation_cx::as_promise(pro));
+    upcxx::future<int> f = upcxx::rpc(target,
+      [](std::vector<char> const &v, int i) {
+        received += 1;
+        return int(v.size()) + i;
+      }, std::vector<char>(i % 64, 'x'), i
+    );
+    int got = upcxx::when_all(pro.finalize(), f).then([](int x) { return x + 1; }).wait();
+    UPCXX_ASSERT_ALWAYS(got == i % 64 + i + 1, "iteration " << i << " got " << got);
+  }
+
+  upcxx::barrier();
+  UPCXX_ASSERT_ALWAYS(received == iters, "received " << received << " of " << iters);
+
+  for(int i = 0; i < iters; i++)
+    UPCXX_ASSERT_ALWAYS(mine.local()[i] == i, "rput value wrong at " << i);
+
+  upcxx::perf_counters c1 = upcxx::perf_counters_thread();
+
+  #if UPCXX_PERF_COUNTERS
+    uint64_t hits = c1.object_cache_hits - c0.object_cache_hits;
+    const char *sz = std::getenv("UPCXX_OBJECT_CACHE_SIZE");
+    bool enabled = sz == nullptr || std::string(sz) != "0";
+
+    // each iteration allocates several futures and callbacks
+    if(enabled)
+      UPCXX_ASSERT_ALWAYS(hits >= uint64_t(iters), "object cache hits " << hits);
+    else
+      UPCXX_ASSERT_ALWAYS(hits == 0, "object cache disabled but hit " << hits << " times");
+
+    if(me == 0)
+      std::cout << "Rank 0 object cache hits: " << hits << std::endl;
+  #endif
+
+  upcxx::barrier();
+  upcxx::delete_array(mine);
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Checks the runtime performance counters move the way they should across a
+// known pattern of eager and rendezvous rpc's. Run with
+// UPCXX_PERF_COUNTERS_DUMP=yes to also see the job-wide report at finalize.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+long received = 0;
+
+int main() {
+  setenv("UPCXX_PERF_COUNTERS_ENABLED", "1", /*overwrite=*/0); // checked below
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const int iters = 100;
+  const int target = (me + 1) % n;
+  const bool target_local = upcxx::local_team_contains(target);
+
+  upcxx::barrier();
+
+  upcxx::perf_counters c0 = upcxx::perf_counters_thread();
+
+  for(int i = 0; i < iters; i++) {
+    // alternate tiny payloads with ones well beyond any cutover
+    std::vector<char> v(i % 2 ? 16 : 256<<10, char(i));
+    upcxx::rpc(target,
+      [](std::vector<char> const &v, int i) {
+        UPCXX_ASSERT_ALWAYS(v.back() == char(i), "corrupt payload");
+        received += 1;
+      }, v, i
+    ).wait();
+  }
+
+  upcxx::barrier();
+  UPCXX_ASSERT_ALWAYS(received == iters, "received " << received << " of " << iters);
+
+  upcxx::perf_counters c1 = upcxx::perf_counters_thread();
+
+  #if UPCXX_PERF_COUNTERS
+    uint64_t eager = target_local
+      ? c1.am_eager_sends_local - c0.am_eager_sends_local
+      : c1.am_eager_sends_remote - c0.am_eager_sends_remote;
+    uint64_t rdzv = target_local
+      ? c1.am_rdzv_sends_local - c0.am_rdzv_sends_local
+      : c1.am_rdzv_sends_remote - c0.am_rdzv_sends_remote;
+    uint64_t recvs = (c1.am_eager_recvs_local + c1.am_eager_recvs_remote)
+                   - (c0.am_eager_recvs_local + c0.am_eager_recvs_remote);
+
+    // every big payload travels rendezvous; small ones and the rendezvous
+    // control messages travel eager
+    UPCXX_ASSERT_ALWAYS(rdzv >= uint64_t(iters/2), "rdzv sends " << rdzv);
+    UPCXX_ASSERT_ALWAYS(eager >= uint64_t(iters/2), "eager sends " << eager);
+    UPCXX_ASSERT_ALWAYS(recvs > 0, "no eager receives counted");
+    UPCXX_ASSERT_ALWAYS(c1.progress_calls > c0.progress_calls);
+    UPCXX_ASSERT_ALWAYS(c1.lpc_inbox_depth_max >= 1);
+
+    // process totals cover at least this thread
+    upcxx::perf_counters p = upcxx::perf_counters_process();
+    UPCXX_ASSERT_ALWAYS(p.progress_calls >= c1.progress_calls);
+  #else
+    UPCXX_ASSERT_ALWAYS(c1.progress_calls == 0);
+  #endif
+
+  if(me == 0)
+    std::cout << "Counters on rank 0:\n" << c1 << std::flush;
+
+  upcxx::barrier();
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
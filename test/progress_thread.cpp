@@ -0,0 +1,83 @@
+#include <upcxx/upcxx.hpp>
+
+#include "util.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#if !UPCXX_BACKEND_GASNET_PAR
+  #error "UPCXX_BACKEND=gasnet_par required."
+#endif
+
+// Mixes long compute phases (no calls into upcxx) with rpc floods, rputs and
+// collectives. Intended to run with UPCXX_PROGRESS_THREAD=yes so that the
+// runtime's progress thread polls concurrently with the application thread,
+// but is valid without it.
+
+using namespace std;
+
+long hits = 0;
+
+double compute(int ms) {
+  auto t0 = chrono::steady_clock::now();
+  double x = 1.0;
+  while(chrono::steady_clock::now() - t0 < chrono::milliseconds(ms))
+    for(int i = 0; i < 1000; i++)
+      x = x*1.0000001 + 1e-9;
+  return x;
+}
+
+int main() {
+  upcxx::init();
+  print_test_header();
+
+  const int me = upcxx::rank_me();
+  const int n = upcxx::rank_n();
+  const int rounds = 10;
+  const int per_round = 200;
+
+  upcxx::global_ptr<long> mine = upcxx::new_array<long>(n*rounds);
+  upcxx::global_ptr<long> theirs;
+  {
+    upcxx::dist_object<upcxx::global_ptr<long>> dobj(mine);
+    theirs = dobj.fetch((me + 1) % n).wait();
+    upcxx::barrier();
+  }
+
+  double sink = 0;
+
+  for(int r = 0; r < rounds; r++) {
+    for(int i = 0; i < per_round; i++) {
+      std::vector<char> payload((i % 4) * 700, 'x'); // eager and rendezvous
+      upcxx::rpc_ff((me + 1 + i) % n, [](std::vector<char> const &) { hits += 1; }, payload);
+    }
+
+    upcxx::future<> f = upcxx::rput((long)r, theirs + me*rounds + r);
+
+    // peers keep sending while we aren't calling progress
+    sink += compute(20);
+
+    f.wait();
+    upcxx::barrier();
+  }
+
+  long expect = long(rounds)*per_round;
+  long total = upcxx::reduce_all(hits, upcxx::op_fast_add).wait();
+  UPCXX_ASSERT_ALWAYS(total == expect*n, "rpc count " << total << " != " << expect*n);
+
+  upcxx::barrier();
+
+  int left = (me + n - 1) % n;
+  for(int r = 0; r < rounds; r++)
+    UPCXX_ASSERT_ALWAYS(mine.local()[left*rounds + r] == r, "rput value wrong");
+
+  if(sink == 0) cout << "unreachable" << endl;
+
+  upcxx::barrier();
+  upcxx::delete_array(mine);
+
+  print_test_success();
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Reduces nontrivial values (vectors holding one flag per team rank) to every
+// root and to all over world, a strided split of world, and local_team, with
+// small tree radices so that even modest rank counts get multi-level trees.
+// Each rank's flag must arrive exactly once.
+
+using upcxx::team;
+
+struct merge_flags {
+  std::vector<int> operator()(std::vector<int> a, std::vector<int> const &b) const {
+    for(std::size_t i = 0; i < a.size(); i++)
+      a[i] += b[i];
+    return a;
+  }
+};
+
+void check_flags(std::vector<int> const &v, team &tm, const char *what) {
+  UPCXX_ASSERT_ALWAYS(v.size() == (std::size_t)tm.rank_n(), what << " size " << v.size());
+  for(int r = 0; r < tm.rank_n(); r++)
+    UPCXX_ASSERT_ALWAYS(v[r] == 1, what << " saw rank " << r << " " << v[r] << " times");
+}
+
+int check_team(team &tm) {
+  int checks = 0;
+  
+  std::vector<int> mine(tm.rank_n(), 0);
+  mine[tm.rank_me()] = 1;
+  
+  for(int root = 0; root < tm.rank_n(); root++) {
+    std::vector<int> got = upcxx::reduce_one_nontrivial(mine, merge_flags(), root, tm).wait();
+    if(tm.rank_me() == root)
+      check_flags(got, tm, "reduce_one");
+    checks += 1;
+  }
+  
+  for(int i = 0; i < 4; i++) {
+    std::vector<int> got = upcxx::reduce_all_nontrivial(mine, merge_flags(), tm).wait();
+    check_flags(got, tm, "reduce_all");
+    checks += 1;
+  }
+  
+  return checks;
+}
+
+int main() {
+  setenv("UPCXX_BCAST_RADIX", "2", /*overwrite=*/0);
+  setenv("UPCXX_BCAST_LOCAL_RADIX", "2", 0);
+  
+  upcxx::init();
+  
+  print_test_header();
+  
+  int checks = 0;
+  
+  checks += check_team(upcxx::world());
+  
+  {
+    int me = upcxx::rank_me();
+    team strided = upcxx::world().split(me % 2, upcxx::rank_n() - me);
+    checks += check_team(strided);
+    strided.destroy();
+  }
+  
+  checks += check_team(upcxx::local_team());
+  
+  upcxx::barrier();
+  
+  if(upcxx::rank_me() == 0)
+    std::cout << "Checked " << checks << " reductions on rank 0" << std::endl;
+  
+  print_test_success();
+  
+  upcxx::finalize();
+  return 0;
+}
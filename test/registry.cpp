@@ -0,0 +1,99 @@
+#include <upcxx/upcxx.hpp>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "util.hpp"
+
+// Checks detail::registry_table against std::map under random insert/erase
+// churn (forcing growth and backward-shift deletes across colliding runs),
+// then churns dist_objects with rpc's bound to them through the real registry.
+
+using upcxx::digest;
+
+void table_vs_map() {
+  upcxx::detail::registry_table tab;
+  std::map<digest, void*> ref;
+  std::mt19937_64 rng(0x5eed);
+
+  std::vector<digest> keys;
+  for(int i = 0; i < 3000; i++) {
+    // half the keys collide in their low bits to make long probe runs
+    std::uint64_t w0 = rng();
+    if(i % 2) w0 &= ~std::uint64_t(0xfff);
+    keys.push_back(digest{w0, std::uint64_t(i)});
+  }
+
+  for(int step = 0; step < 200000; step++) {
+    digest k = keys[rng() % keys.size()];
+    void *v = reinterpret_cast<void*>(std::uintptr_t(step + 1));
+
+    switch(rng() % 4) {
+    case 0:
+    case 1: {
+        auto ins = tab.insert({k, v});
+        auto ref_ins = ref.insert({k, v});
+        UPCXX_ASSERT_ALWAYS(ins.second == ref_ins.second);
+        UPCXX_ASSERT_ALWAYS(ins.first->first == k);
+        UPCXX_ASSERT_ALWAYS(ins.first->second == ref_ins.first->second);
+      } break;
+    case 2: {
+        std::size_t n = tab.erase(k);
+        UPCXX_ASSERT_ALWAYS(n == ref.erase(k));
+      } break;
+    case 3: {
+        auto it = tab.find(k);
+        auto ref_it = ref.find(k);
+        UPCXX_ASSERT_ALWAYS((it == tab.end()) == (ref_it == ref.end()));
+        if(it != tab.end())
+          UPCXX_ASSERT_ALWAYS(it->second == ref_it->second);
+      } break;
+    }
+
+    UPCXX_ASSERT_ALWAYS(tab.size() == ref.size());
+  }
+
+  for(auto const &kv: ref)
+    UPCXX_ASSERT_ALWAYS(tab.at(kv.first) == kv.second);
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  if(upcxx::rank_me() == 0)
+    table_vs_map();
+
+  const int me = upcxx::rank_me();
+  const int n = upcxx::rank_n();
+
+  // many live dist_objects, rpc's to random ones, then tear down in waves
+  for(int wave = 0; wave < 4; wave++) {
+    std::vector<std::unique_ptr<upcxx::dist_object<int>>> objs;
+    for(int i = 0; i < 500; i++)
+      objs.emplace_back(new upcxx::dist_object<int>(1000*wave + i));
+
+    std::vector<upcxx::future<int>> got;
+    for(int i = 0; i < 2000; i++) {
+      int which = (i*7 + me) % 500;
+      got.push_back(upcxx::rpc((me + i) % n,
+        [](upcxx::dist_object<int> &obj) { return *obj; }, *objs[which]));
+    }
+    for(int i = 0; i < 2000; i++)
+      UPCXX_ASSERT_ALWAYS(got[i].wait() == 1000*wave + (i*7 + me) % 500);
+
+    upcxx::barrier();
+    // destroy every other one first, then the rest
+    for(int i = 0; i < 500; i += 2)
+      objs[i].reset();
+    upcxx::barrier();
+  }
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
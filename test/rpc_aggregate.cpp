@@ -0,0 +1,82 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <string>
+
+#include "util.hpp"
+
+// Exercises rpc traffic patterns which are candidates for per-destination
+// aggregation (UPCXX_RPC_AGGREGATE=yes). The test is valid with aggregation
+// disabled as well.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+int received = 0;
+long received_sum = 0;
+
+long checksum(const std::string &s) {
+  long h = 0;
+  for(char c: s) h = 31*h + c;
+  return h;
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int rounds = 50;
+  const int me = rank_me();
+  const int n = rank_n();
+  long expect_sum = 0;
+
+  upcxx::barrier();
+
+  for(int round = 0; round < rounds; round++) {
+    for(int i = 0; i < n; i++) {
+      int target = (me + i) % n;
+      // mostly tiny commands with the occasional one large enough to travel
+      // by rendezvous, interleaved to the same destination
+      std::size_t len = (round % 17 == 16) ? 4096 + round : round % 23;
+      std::string s(len, char('a' + (me + round) % 26));
+
+      upcxx::rpc_ff(target, [](std::string const &s) {
+        received += 1;
+        received_sum += checksum(s);
+      }, s);
+    }
+
+    if(round % 10 == 0)
+      upcxx::rpc_aggregate_flush();
+  }
+
+  // every rank sends one of each string to every rank
+  for(int round = 0; round < rounds; round++) {
+    for(int origin = 0; origin < n; origin++) {
+      std::size_t len = (round % 17 == 16) ? 4096 + round : round % 23;
+      expect_sum += checksum(std::string(len, char('a' + (origin + round) % 26)));
+    }
+  }
+
+  while(received != rounds*n)
+    upcxx::progress();
+
+  UPCXX_ASSERT_ALWAYS(received_sum == expect_sum, "payload checksum mismatch");
+
+  // round trip rpc's must still complete while waiting on their futures
+  upcxx::future<int> all = upcxx::make_future(0);
+  for(int i = 0; i < n; i++) {
+    all = upcxx::when_all(all, upcxx::rpc((me + i) % n, [](int x) { return x + 1; }, i))
+      .then([](int a, int b) { return a + b; });
+  }
+  int total = all.wait();
+  UPCXX_ASSERT_ALWAYS(total == n*(n-1)/2 + n, "rpc results wrong: " << total);
+
+  upcxx::barrier();
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Sends rpc's with payloads straddling the eager/rendezvous cutover to every
+// rank, checking delivery and that the cutovers reported by
+// detail::rdzv_cutover() stay sane. Run with UPCXX_RDZV_CUTOVER_ADAPT=yes to
+// exercise online tuning.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const std::size_t lo = upcxx::backend::gasnet::am_size_rdzv_cutover_min;
+
+  for(bool local: {true, false}) {
+    std::size_t c = upcxx::detail::rdzv_cutover(local);
+    UPCXX_ASSERT_ALWAYS(c >= lo, "cutover below minimum: " << c);
+    if(me == 0)
+      std::cout << "Initial " << (local ? "local" : "remote") << " cutover: " << c << std::endl;
+  }
+
+  const int iters = 2000;
+  long sent = 0, acked = 0;
+
+  for(int i = 0; i < iters; i++) {
+    int target = (me + i) % n;
+    // sweep sizes between a quarter and four times the current cutover
+    std::size_t cut = upcxx::detail::rdzv_cutover(upcxx::local_team_contains(target));
+    std::size_t len = cut/4 + (i*97) % (4*cut);
+    std::vector<char> v(len, char(i));
+
+    upcxx::future<std::size_t> f = upcxx::rpc(target,
+      [](std::vector<char> const &v, int i) -> std::size_t {
+        for(char c: v)
+          UPCXX_ASSERT_ALWAYS(c == char(i), "corrupt payload");
+        return v.size();
+      }, v, i);
+
+    sent += len;
+    acked += f.wait();
+
+    for(bool local: {true, false}) {
+      std::size_t c = upcxx::detail::rdzv_cutover(local);
+      UPCXX_ASSERT_ALWAYS(c >= lo, "cutover below minimum: " << c);
+    }
+  }
+
+  UPCXX_ASSERT_ALWAYS(sent == acked, "sent " << sent << " but acked " << acked);
+
+  upcxx::barrier();
+
+  if(me == 0)
+    std::cout << "Final cutovers: local " << upcxx::detail::rdzv_cutover(true)
+              << ", remote " << upcxx::detail::rdzv_cutover(false) << std::endl;
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
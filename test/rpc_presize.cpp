@@ -0,0 +1,89 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// Rpc's and broadcasts whose arguments have no serialization upper bound
+// (containers of strings and of containers), at sizes below the inline
+// buffer, between it and the rendezvous cutover, and well past the cutover.
+// Such commands are measured first and then serialized straight into their
+// eager or rendezvous buffer.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+std::vector<std::string> make_strings(std::size_t bytes, int salt) {
+  std::vector<std::string> v;
+  for(std::size_t total = 0, i = 0; total < bytes; i++) {
+    v.push_back(std::string(1 + (i*7 + salt) % 97, char('a' + (i + salt) % 26)));
+    total += v.back().size();
+  }
+  return v;
+}
+
+std::vector<std::vector<int>> make_rows(std::size_t bytes, int salt) {
+  std::vector<std::vector<int>> rows;
+  for(std::size_t total = 0, i = 0; total < bytes; i++) {
+    rows.push_back(std::vector<int>(i % 300, int(i) + salt));
+    total += rows.back().size()*sizeof(int);
+  }
+  return rows;
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const int target = (me + 1) % n;
+
+  const std::size_t sizes[] = {64, 3000, 64<<10, 4<<20};
+
+  for(std::size_t bytes: sizes) {
+    std::vector<std::string> strs = make_strings(bytes, me);
+    std::size_t got = upcxx::rpc(target,
+      [=](std::vector<std::string> const &v, std::list<std::string> const &l) {
+        std::vector<std::string> expect = make_strings(bytes, (rank_me() + rank_n() - 1) % rank_n());
+        UPCXX_ASSERT_ALWAYS(v == expect, "strings of " << bytes << " bytes corrupted");
+        UPCXX_ASSERT_ALWAYS(l.size() == 2 && l.front() == "front" && l.back() == v.back());
+        return v.size();
+      }, strs, std::list<std::string>{"front", strs.back()}
+    ).wait();
+    UPCXX_ASSERT_ALWAYS(got == strs.size());
+
+    std::vector<std::vector<int>> rows = make_rows(bytes, me);
+    long sum = upcxx::rpc(target,
+      [=](std::vector<std::vector<int>> const &rows) {
+        UPCXX_ASSERT_ALWAYS(rows == make_rows(bytes, (rank_me() + rank_n() - 1) % rank_n()), "rows of " << bytes << " bytes corrupted");
+        long s = 0;
+        for(auto const &r: rows)
+          s += r.size();
+        return s;
+      }, rows
+    ).wait();
+    long expect = 0;
+    for(auto const &r: rows)
+      expect += r.size();
+    UPCXX_ASSERT_ALWAYS(sum == expect);
+
+    for(int root = 0; root < n; root++) {
+      std::vector<std::string> b = upcxx::broadcast_nontrivial(
+        me == root ? make_strings(bytes, root) : std::vector<std::string>(), root
+      ).wait();
+      UPCXX_ASSERT_ALWAYS(b == make_strings(bytes, root), "broadcast of " << bytes << " bytes corrupted");
+    }
+
+    upcxx::barrier();
+  }
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Floods neighbors with rendezvous-sized rpc's of assorted sizes so that
+// rendezvous buffers cycle through the per-thread buffer caches
+// (UPCXX_RDZV_POOL_SIZE), then checks the shared heap is usable afterwards.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+long received = 0;
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const int iters = 200;
+  const int window = 16;
+
+  upcxx::barrier();
+
+  upcxx::future<> all = upcxx::make_future();
+  for(int i = 0; i < iters; i++) {
+    int target = (me + 1 + i) % n;
+    std::size_t len = 2048 << (i % 6); // 2K..64K
+    std::vector<char> v(len, char(i));
+
+    all = upcxx::when_all(all,
+      upcxx::rpc(target,
+        [](std::vector<char> const &v, int i) {
+          for(char c: v)
+            UPCXX_ASSERT_ALWAYS(c == char(i), "corrupt payload");
+          received += 1;
+        }, v, i)
+    );
+
+    if(i % window == window-1) {
+      all.wait();
+      all = upcxx::make_future();
+    }
+  }
+  all.wait();
+
+  upcxx::barrier();
+  UPCXX_ASSERT_ALWAYS(received == iters, "received " << received << " of " << iters);
+
+  if(me == 0)
+    std::cout << upcxx::detail::shared_heap_stats();
+
+  // recycled buffers must not get in the way of user allocations
+  upcxx::global_ptr<char> p = upcxx::new_array<char>(1<<20);
+  UPCXX_ASSERT_ALWAYS(p != nullptr);
+  upcxx::delete_array(p);
+
+  upcxx::barrier();
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
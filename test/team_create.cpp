@@ -0,0 +1,283 @@
+#include <upcxx/upcxx.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// Builds teams with team::create() and team::split_async(), which have no
+// gasnet team of their own, and runs every collective over them: barrier,
+// broadcast, reduce (built-in and user ops), dist_object, a blocking split
+// and a split_async of such a team. One rank creates its team late so the
+// others' collective AMs reach it before the team does, and the members of
+// other teams finish creating them one after another before going straight
+// into collectives that look the team up on arrival. Ranks also receive a
+// team's id ahead of creating it and wait with team_id::when_here().
+// Several split_async's stay in flight while world keeps communicating.
+
+using upcxx::intrank_t;
+using upcxx::team;
+
+void check_members(team &tm, std::vector<intrank_t> const &members, char const *what) {
+  UPCXX_ASSERT_ALWAYS(tm.rank_n() == (intrank_t)members.size(), what << ": rank_n " << tm.rank_n());
+  UPCXX_ASSERT_ALWAYS(tm[tm.rank_me()] == upcxx::rank_me(), what << ": rank_me " << tm.rank_me());
+
+  for(intrank_t r=0; r < tm.rank_n(); r++) {
+    UPCXX_ASSERT_ALWAYS(tm[r] == members[r], what << ": team rank " << r << " is world " << tm[r] << " expected " << members[r]);
+    UPCXX_ASSERT_ALWAYS(tm.from_world(members[r]) == r, what << ": from_world(" << members[r] << ")");
+  }
+}
+
+void check_collectives(team &tm, char const *what) {
+  const intrank_t me = tm.rank_me(), n = tm.rank_n();
+
+  for(int i=0; i < 3; i++)
+    upcxx::barrier(tm);
+  upcxx::barrier_async(tm).wait();
+
+  for(intrank_t root=0; root < n; root++) {
+    long got = upcxx::broadcast(100*root + 7, root, tm).wait();
+    UPCXX_ASSERT_ALWAYS(got == 100*root + 7, what << ": broadcast from " << root << " gave " << got);
+
+    std::vector<double> buf(40, me == root ? 0.5*root : -1.0);
+    upcxx::broadcast(buf.data(), buf.size(), root, tm).wait();
+    for(double x: buf)
+      UPCXX_ASSERT_ALWAYS(x == 0.5*root, what << ": vector broadcast from " << root << " gave " << x);
+  }
+
+  long sum = upcxx::reduce_all(long(me + 1), upcxx::op_fast_add, tm).wait();
+  UPCXX_ASSERT_ALWAYS(sum == long(n)*(n + 1)/2, what << ": reduce_all add gave " << sum);
+
+  unsigned bits = upcxx::reduce_all(1u << (me % 32), upcxx::op_fast_bit_or, tm).wait();
+  UPCXX_ASSERT_ALWAYS(bits == (n >= 32 ? ~0u : (1u << n) - 1), what << ": reduce_all bit_or gave " << bits);
+
+  float top = upcxx::reduce_all(float(me), upcxx::op_fast_max, tm).wait();
+  UPCXX_ASSERT_ALWAYS(top == float(n - 1), what << ": reduce_all max gave " << top);
+
+  // a user op, combined through its vectorized function
+  long prod = upcxx::reduce_all(long(me % 3 + 1), [](long a, long b) { return a*b; }, tm).wait();
+  long want_prod = 1;
+  for(intrank_t r=0; r < n; r++) want_prod *= r % 3 + 1;
+  UPCXX_ASSERT_ALWAYS(prod == want_prod, what << ": reduce_all user op gave " << prod);
+
+  intrank_t root = n - 1;
+  std::vector<int> src(10), dst(10, -5);
+  for(int i=0; i < 10; i++) src[i] = me + i;
+  upcxx::reduce_one(src.data(), dst.data(), 10, upcxx::op_fast_min, root, tm).wait();
+  for(int i=0; i < 10; i++)
+    UPCXX_ASSERT_ALWAYS(dst[i] == (me == root ? i : -5), what << ": reduce_one min dst[" << i << "] is " << dst[i]);
+
+  upcxx::dist_object<intrank_t> dobj(me, tm);
+  intrank_t peer = (me + 1) % n;
+  UPCXX_ASSERT_ALWAYS(dobj.fetch(peer).wait() == peer, what << ": dist_object fetch");
+  intrank_t ran_on = upcxx::rpc(tm, peer, []() { return upcxx::rank_me(); }).wait();
+  UPCXX_ASSERT_ALWAYS(ran_on == tm[peer], what << ": rpc to team rank " << peer << " ran on " << ran_on);
+
+  upcxx::barrier(tm);
+}
+
+void poll_for(int ms, upcxx::progress_level level = upcxx::progress_level::user) {
+  auto t0 = std::chrono::steady_clock::now();
+  while(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(ms))
+    upcxx::progress(level);
+}
+
+// Broadcasts and reductions whose receivers resolve the team by id, one of
+// them long enough to take the rendezvous path.
+void check_nontrivial(team &tm, char const *what) {
+  const intrank_t me = tm.rank_me(), n = tm.rank_n();
+
+  std::string small = upcxx::broadcast_nontrivial(std::string(me == 0 ? "hello" : ""), 0, tm).wait();
+  UPCXX_ASSERT_ALWAYS(small == "hello", what << ": broadcast_nontrivial gave '" << small << "'");
+
+  std::string big = upcxx::broadcast_nontrivial(std::string(me == 0 ? 100000 : 0, 'b'), 0, tm).wait();
+  UPCXX_ASSERT_ALWAYS(big.size() == 100000 && big[99999] == 'b',
+    what << ": large broadcast_nontrivial gave " << big.size() << " bytes");
+
+  std::string all = upcxx::reduce_all_nontrivial(std::string(1, char('a' + me % 26)),
+    [](std::string const &a, std::string const &b) { return a + b; }, tm).wait();
+  UPCXX_ASSERT_ALWAYS(all.size() == std::size_t(n), what << ": reduce_all_nontrivial gave '" << all << "'");
+
+  long sum = upcxx::reduce_one_nontrivial(long(me), upcxx::op_add, 0, tm).wait();
+  UPCXX_ASSERT_ALWAYS(me != 0 || sum == long(n)*(n - 1)/2, what << ": reduce_one_nontrivial gave " << sum);
+
+  upcxx::barrier(tm);
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const intrank_t me = upcxx::rank_me(), n = upcxx::rank_n();
+  upcxx::team &world = upcxx::world();
+
+  if(me == 0)
+    std::cout << "team::create" << std::endl;
+  {
+    // even and odd world ranks, each team's rank 0 (the root of its
+    // collectives) late to create
+    std::vector<intrank_t> mine;
+    for(intrank_t w = me % 2; w < n; w += 2)
+      mine.push_back(w);
+
+    if(me == mine.front()) {
+      // keep polling so the others' AMs for the team arrive before it does
+      poll_for(50);
+    }
+
+    team tm = world.create(mine);
+    check_members(tm, mine, "create");
+    check_collectives(tm, "create");
+
+    // the same list again makes a second, distinct team
+    team again = world.create(mine);
+    UPCXX_ASSERT_ALWAYS(again.id() != tm.id(), "repeated create() reused a team id");
+    check_collectives(again, "create again");
+    again.destroy();
+
+    // a blocking split of a created team, reversed
+    std::vector<intrank_t> rev(mine.rbegin(), mine.rend());
+    team sub = tm.split(0, tm.rank_n() - tm.rank_me());
+    check_members(sub, rev, "split of created");
+    check_collectives(sub, "split of created");
+    sub.destroy();
+
+    // a singleton team
+    team alone = world.create(std::vector<intrank_t>{me});
+    check_members(alone, {me}, "singleton");
+    check_collectives(alone, "singleton");
+    alone.destroy();
+
+    tm.destroy();
+  }
+
+  if(me == 0)
+    std::cout << "Staggered team::create" << std::endl;
+  {
+    std::vector<intrank_t> all;
+    for(intrank_t w=0; w < n; w++)
+      all.push_back(w);
+
+    // Early ranks broadcast to, then reduce into, ranks that have yet to
+    // create the team.
+    poll_for(10*me);
+    team up = world.create(all);
+    check_nontrivial(up, "create, rank 0 first");
+    check_collectives(up, "create, rank 0 first");
+    up.destroy();
+
+    poll_for(10*(n - 1 - me));
+    team down = world.create(all);
+    check_nontrivial(down, "create, rank 0 last");
+    down.destroy();
+  }
+
+  if(me == 0)
+    std::cout << "team_id ahead of its team" << std::endl;
+  {
+    std::vector<intrank_t> all;
+    for(intrank_t w=0; w < n; w++)
+      all.push_back(w);
+
+    // Rank 0 sends the new team's id to the others, which ask for the team
+    // before creating it themselves.
+    static upcxx::future<team&> *arrived = nullptr; // may be set before we get here
+
+    if(me == 0) {
+      team tm = world.create(all);
+      upcxx::future<> sent = upcxx::make_future();
+      for(intrank_t r=1; r < n; r++)
+        sent = upcxx::when_all(sent, upcxx::rpc(r, [](upcxx::team_id id) {
+          arrived = new upcxx::future<team&>(id.when_here());
+        }, tm.id()));
+      sent.wait();
+      UPCXX_ASSERT_ALWAYS(&tm.id().when_here().wait() == &tm, "when_here() of an existing team");
+      upcxx::barrier(tm);
+      tm.destroy();
+    }
+    else {
+      while(arrived == nullptr)
+        upcxx::progress();
+      UPCXX_ASSERT_ALWAYS(!arrived->ready(), "when_here() ready before the team was created");
+
+      team tm = world.create(all);
+      team &got = arrived->wait();
+      UPCXX_ASSERT_ALWAYS(&got == &tm && got.id() == tm.id(), "when_here() resolved to another team");
+      delete arrived;
+      upcxx::barrier(tm);
+      tm.destroy();
+    }
+  }
+
+  if(me == 0)
+    std::cout << "Staggered team::split_async" << std::endl;
+  {
+    // Odd world ranks only make internal progress for a while, so their
+    // split_async's have completed the exchange but not built the team
+    // while the others' collectives over it arrive.
+    upcxx::future<team&> f = world.split_async(0, me);
+    if(me % 2 == 1)
+      poll_for(50, upcxx::progress_level::internal);
+    team &tm = f.wait();
+    check_nontrivial(tm, "split_async, odd ranks late");
+    tm.destroy();
+  }
+
+  if(me == 0)
+    std::cout << "team::split_async" << std::endl;
+  {
+    // several in flight at once, overlapped with world traffic
+    upcxx::future<team&> halves = world.split_async(me % 2, -me);
+    upcxx::future<team&> thirds = world.split_async(me % 3, me);
+    upcxx::future<team&> all_but_0 = world.split_async(me == 0 ? team::color_none : 0, me);
+
+    long sum = upcxx::reduce_all(long(me), upcxx::op_fast_add).wait();
+    UPCXX_ASSERT_ALWAYS(sum == long(n)*(n - 1)/2);
+    upcxx::rpc((me + 1) % n, []() {}).wait();
+
+    team &h = halves.wait();
+    std::vector<intrank_t> h_members;
+    for(intrank_t w = me % 2; w < n; w += 2)
+      h_members.push_back(w);
+    std::reverse(h_members.begin(), h_members.end());
+    check_members(h, h_members, "split_async halves");
+    check_collectives(h, "split_async halves");
+
+    team &t = thirds.wait();
+    std::vector<intrank_t> t_members;
+    for(intrank_t w = me % 3; w < n; w += 3)
+      t_members.push_back(w);
+    check_members(t, t_members, "split_async thirds");
+
+    // split_async of a team with no gasnet team
+    team &tt = t.split_async(0, t.rank_n() - t.rank_me()).wait();
+    std::reverse(t_members.begin(), t_members.end());
+    check_members(tt, t_members, "split_async of split_async");
+    check_collectives(tt, "split_async of split_async");
+
+    team &a = all_but_0.wait();
+    if(me == 0)
+      UPCXX_ASSERT_ALWAYS(a.rank_n() == 0, "color_none gave a team of " << a.rank_n());
+    else {
+      std::vector<intrank_t> a_members;
+      for(intrank_t w=1; w < n; w++)
+        a_members.push_back(w);
+      check_members(a, a_members, "split_async color_none");
+      check_collectives(a, "split_async color_none");
+    }
+
+    tt.destroy();
+    t.destroy();
+    h.destroy();
+    a.destroy();
+  }
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
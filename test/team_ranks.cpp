@@ -0,0 +1,98 @@
+#include <upcxx/upcxx.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "util.hpp"
+
+// Splits world with a variety of colors and keys, including ones that leave
+// team ranks unevenly spaced over world, and checks team::operator[] and
+// team::from_world against the membership each rank expects. A split of a
+// split and an rpc round trip through every team rank check that the
+// translation is used consistently.
+
+using upcxx::intrank_t;
+using upcxx::team;
+
+void check(team &tm, std::vector<intrank_t> const &members, char const *what) {
+  const intrank_t n = upcxx::rank_n();
+
+  UPCXX_ASSERT_ALWAYS(tm.rank_n() == (intrank_t)members.size(), what << ": rank_n " << tm.rank_n());
+  UPCXX_ASSERT_ALWAYS(tm[tm.rank_me()] == upcxx::rank_me(), what << ": rank_me " << tm.rank_me());
+
+  for(intrank_t r=0; r < tm.rank_n(); r++) {
+    UPCXX_ASSERT_ALWAYS(tm[r] == members[r], what << ": team rank " << r << " is world " << tm[r] << " expected " << members[r]);
+    UPCXX_ASSERT_ALWAYS(tm.from_world(members[r]) == r, what << ": from_world(" << members[r] << ") = " << tm.from_world(members[r]));
+  }
+
+  for(intrank_t w=-2; w < n+2; w++) {
+    bool member = std::find(members.begin(), members.end(), w) != members.end();
+    if(!member)
+      UPCXX_ASSERT_ALWAYS(tm.from_world(w, -7) == -7, what << ": world " << w << " is not a member");
+  }
+
+  for(intrank_t r=0; r < tm.rank_n(); r++) {
+    intrank_t got = upcxx::rpc(tm, r, []() { return upcxx::rank_me(); }).wait();
+    UPCXX_ASSERT_ALWAYS(got == members[r], what << ": rpc to team rank " << r << " ran on " << got);
+  }
+
+  upcxx::barrier(tm);
+}
+
+// Splits world by `color(w)`, ordering each team by `key(w)`, and checks it.
+void check_split(std::function<intrank_t(intrank_t)> color,
+                 std::function<intrank_t(intrank_t)> key, char const *what) {
+  const intrank_t me = upcxx::rank_me(), n = upcxx::rank_n();
+
+  std::vector<intrank_t> members;
+  for(intrank_t w=0; w < n; w++)
+    if(color(w) == color(me))
+      members.push_back(w);
+  // ties in key are broken by parent rank
+  std::stable_sort(members.begin(), members.end(),
+    [&](intrank_t a, intrank_t b) { return key(a) < key(b); });
+
+  team tm = upcxx::world().split(color(me), key(me));
+  check(tm, members, what);
+
+  // split again, keeping every other rank of the new team in reverse order
+  std::vector<intrank_t> sub_members;
+  for(intrank_t r=0; r < tm.rank_n(); r++)
+    if(r % 2 == tm.rank_me() % 2)
+      sub_members.push_back(members[r]);
+  std::reverse(sub_members.begin(), sub_members.end());
+
+  team sub = tm.split(tm.rank_me() % 2, tm.rank_n() - tm.rank_me());
+  check(sub, sub_members, what);
+
+  sub.destroy();
+  tm.destroy();
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const intrank_t n = upcxx::rank_n();
+
+  {
+    std::vector<intrank_t> all(n);
+    for(intrank_t w=0; w < n; w++) all[w] = w;
+    check(upcxx::world(), all, "world");
+  }
+
+  check_split([](intrank_t) { return 0; }, [](intrank_t w) { return w; }, "identity");
+  check_split([](intrank_t) { return 0; }, [=](intrank_t w) { return n - w; }, "reversed");
+  check_split([](intrank_t w) { return w % 2; }, [](intrank_t w) { return w; }, "even/odd");
+  check_split([](intrank_t w) { return w / 3; }, [](intrank_t) { return 0; }, "blocks of 3");
+  check_split([](intrank_t) { return 0; }, [=](intrank_t w) { return (w*7 + 3) % (n + 1); }, "shuffled");
+  check_split([](intrank_t w) { return w % 3 == 1 ? 1 : 0; }, [=](intrank_t w) { return (n - w) % 4; }, "uneven");
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include <upcxx/upcxx.hpp>
+
+#include "util.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#if !UPCXX_BACKEND_GASNET_PAR
+  #error "UPCXX_BACKEND=gasnet_par required."
+#endif
+
+// Starts many short-lived threads one after another, each filling its
+// per-thread caches (rendezvous buffers, then shared heap allocations)
+// before exiting. The shared heap is small enough that it runs dry unless
+// every exiting thread hands its cached blocks back.
+
+int main() {
+  setenv("UPCXX_SHARED_HEAP_SIZE", "16", /*overwrite=*/0);
+
+  upcxx::init();
+  print_test_header();
+
+  const int me = upcxx::rank_me(), n = upcxx::rank_n();
+  const int churn = 64;
+
+  // Each thread caches about 1MB of rendezvous buffers (the default
+  // UPCXX_RDZV_POOL_SIZE) from rpc's too large to go eagerly.
+  for(int t = 0; t < churn; t++) {
+    std::atomic<bool> done(false);
+
+    std::thread th([&]() {
+      upcxx::future<> all = upcxx::make_future();
+      for(int i = 0; i < 8; i++) {
+        std::vector<char> v(100<<10, char(i));
+        all = upcxx::when_all(all,
+          upcxx::rpc((me + 1) % n, [](std::vector<char> const &v) {
+            UPCXX_ASSERT_ALWAYS(v.size() == 100<<10);
+          }, v)
+        );
+      }
+      all.wait();
+      done.store(true);
+    });
+
+    // the master persona serves our peers' rendezvous meanwhile
+    while(!done.load())
+      upcxx::progress();
+    th.join();
+  }
+
+  // Each thread caches about 256KB of small allocations (the default
+  // UPCXX_USER_ALLOC_CACHE_SIZE) across the size classes.
+  for(int t = 0; t < churn; t++) {
+    std::thread th([]() {
+      std::vector<void*> ps;
+      for(std::size_t size = 16; size <= 2048; size *= 2) {
+        for(int i = 0; i < 2*(32<<10)/int(size) + 2; i++) {
+          void *p = upcxx::allocate(size);
+          UPCXX_ASSERT_ALWAYS(p != nullptr, "shared heap exhausted");
+          ps.push_back(p);
+        }
+      }
+      for(void *p: ps)
+        upcxx::deallocate(p);
+    });
+    th.join();
+  }
+
+  upcxx::barrier();
+
+  print_test_success();
+  upcxx::finalize();
+  return 0;
+}
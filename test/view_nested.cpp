@@ -0,0 +1,145 @@
+#include <upcxx/upcxx.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "util.hpp"
+
+// Sends containers of containers through make_nested_view and checks the
+// receiver walks them as views into the rpc buffer, without allocating.
+
+using upcxx::view;
+using std::deque;
+using std::list;
+using std::string;
+using std::vector;
+
+std::atomic<long> allocs{0};
+
+void* operator new(std::size_t size) {
+  allocs.fetch_add(1, std::memory_order_relaxed);
+  void *p = std::malloc(size ? size : 1);
+  if(p == nullptr) throw std::bad_alloc();
+  return p;
+}
+// out of line so gcc does not pair the inlined free() with `new` and warn
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+  std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept {
+  ::operator delete(p);
+}
+
+// what each level deserializes as
+static_assert(std::is_same<
+    upcxx::deserialized_type_t<decltype(upcxx::make_nested_view(std::declval<vector<string>>()))>,
+    view<view<char>>
+  >::value, "ERROR");
+static_assert(std::is_same<
+    upcxx::deserialized_type_t<decltype(upcxx::make_nested_view(std::declval<list<vector<int>>>()))>,
+    view<view<int>>
+  >::value, "ERROR");
+static_assert(std::is_same<
+    upcxx::deserialized_type_t<decltype(upcxx::make_nested_view(std::declval<vector<deque<vector<string>>>>()))>,
+    view<view<view<view<char>>>>
+  >::value, "ERROR");
+// contiguous leaves are viewed by pointer
+static_assert(std::is_same<
+    decltype(*upcxx::make_nested_view(std::declval<vector<string>>()).begin()),
+    view<char, char const*>
+  >::value, "ERROR");
+
+long sum_of(string const &s) {
+  long x = 0;
+  for(char c: s) x += c;
+  return x;
+}
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = upcxx::rank_me();
+  const int target = (me + 1) % upcxx::rank_n();
+
+  for(int round = 0; round < 3; round++) {
+    const int n = 10 + 100*round;
+
+    vector<string> kmers;
+    list<vector<int>> rows;
+    vector<deque<vector<string>>> deep(3);
+    long kmer_sum = 0, row_sum = 0, deep_sum = 0;
+
+    for(int i = 0; i < n; i++) {
+      kmers.push_back(string(1 + (i*7 + me) % 31, char('A' + i % 26)));
+      kmer_sum += sum_of(kmers.back());
+
+      rows.push_back(vector<int>(i % 13));
+      for(int j = 0; j < i % 13; j++) {
+        rows.back()[j] = i*j + me;
+        row_sum += i*j + me;
+      }
+
+      deep[i % 3].push_back(vector<string>(i % 4, std::to_string(i)));
+      deep_sum += (i % 4) * sum_of(std::to_string(i));
+    }
+
+    long got_allocs = upcxx::rpc(target,
+      [=](view<view<char>> ks, view<view<int>> rs, view<view<view<view<char>>>> dp) {
+        long before = allocs.load(std::memory_order_relaxed);
+
+        UPCXX_ASSERT_ALWAYS(ks.size() == (size_t)n);
+        long ksum = 0;
+        int i = 0;
+        for(view<char> k: ks) {
+          UPCXX_ASSERT_ALWAYS(k.size() == size_t(1 + (i*7 + (me)) % 31));
+          UPCXX_ASSERT_ALWAYS(k.empty() || k[0] == char('A' + i % 26));
+          for(char c: k) ksum += c;
+          i++;
+        }
+        UPCXX_ASSERT_ALWAYS(ksum == kmer_sum, "kmer sum " << ksum << " != " << kmer_sum);
+
+        long rsum = 0;
+        i = 0;
+        for(view<int> r: rs) {
+          UPCXX_ASSERT_ALWAYS(r.size() == size_t(i % 13));
+          for(size_t j = 0; j < r.size(); j++) {
+            UPCXX_ASSERT_ALWAYS(r.data()[j] == i*int(j) + me);
+            rsum += r[j];
+          }
+          i++;
+        }
+        UPCXX_ASSERT_ALWAYS(rsum == row_sum);
+
+        long dsum = 0;
+        UPCXX_ASSERT_ALWAYS(dp.size() == 3);
+        for(view<view<view<char>>> d: dp)
+          for(view<view<char>> v: d)
+            for(view<char> s: v)
+              for(char c: s) dsum += c;
+        UPCXX_ASSERT_ALWAYS(dsum == deep_sum);
+
+        return allocs.load(std::memory_order_relaxed) - before;
+      },
+      upcxx::make_nested_view(kmers),
+      upcxx::make_nested_view(rows),
+      upcxx::make_nested_view(deep)
+    ).wait();
+
+    UPCXX_ASSERT_ALWAYS(got_allocs == 0, "receiver allocated " << got_allocs << " times");
+  }
+
+  upcxx::barrier();
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
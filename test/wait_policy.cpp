@@ -0,0 +1,88 @@
+#include <upcxx/upcxx.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "util.hpp"
+
+// Runs with UPCXX_WAIT_POLICY=block (unless overridden in the environment)
+// so that ranks waiting on a slow peer go idle, then checks that rpc's,
+// remote completions and collectives from that peer still wake them.
+
+using upcxx::rank_me;
+using upcxx::rank_n;
+
+int got = 0;
+
+int main() {
+  setenv("UPCXX_WAIT_POLICY", "block", /*overwrite=*/0);
+  setenv("UPCXX_WAIT_SPIN", "10", 0);
+  setenv("UPCXX_WAIT_YIELD", "10", 0);
+  setenv("UPCXX_PERF_COUNTERS_ENABLED", "1", 0);
+
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = rank_me();
+  const int n = rank_n();
+  const int rounds = 5;
+
+  upcxx::dist_object<upcxx::promise<int>> pro(upcxx::promise<int>{});
+  upcxx::global_ptr<int> cell = upcxx::new_<int>(-1);
+  upcxx::dist_object<upcxx::global_ptr<int>> cells(cell);
+  upcxx::barrier();
+
+  for(int r = 0; r < rounds; r++) {
+    int slow = r % n;
+
+    if(me == slow) {
+      // everyone else is waiting on us in the meantime
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+      for(int i = 0; i < n; i++) {
+        if(i == me) continue;
+        upcxx::global_ptr<int> c = cells.fetch(i).wait();
+        upcxx::rput(r, c,
+          upcxx::operation_cx::as_future() | upcxx::remote_cx::as_rpc([=]() { got += 1; })
+        ).wait();
+        upcxx::rpc(i,
+          [](upcxx::dist_object<upcxx::promise<int>> &pro, int r) {
+            pro->fulfill_result(r);
+          }, pro, r
+        ).wait();
+      }
+    }
+    else {
+      int r1 = pro->get_future().wait();
+      UPCXX_ASSERT_ALWAYS(r1 == r, "round " << r << " got " << r1);
+      UPCXX_ASSERT_ALWAYS(*cell.local() == r, "rput not visible");
+      *pro = upcxx::promise<int>();
+    }
+
+    // a collective entered late by the slow rank
+    int sum = upcxx::reduce_all(1, upcxx::op_fast_add).wait();
+    UPCXX_ASSERT_ALWAYS(sum == n);
+  }
+
+  // remote completions are not ordered with the rpc's that followed them
+  const int expect = rounds - (rounds + n - 1 - me)/n;
+  while(got != expect)
+    upcxx::progress();
+
+  upcxx::perf_counters pc = upcxx::perf_counters_thread();
+  if(me == 0)
+    std::cout << "Rank 0 idle yields: " << pc.wait_yields
+              << ", blocks: " << pc.wait_blocks << std::endl;
+
+  upcxx::barrier();
+  upcxx::delete_(cell);
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}
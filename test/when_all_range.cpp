@@ -0,0 +1,125 @@
+#include <upcxx/upcxx.hpp>
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "util.hpp"
+
+// Exercises when_all(begin, end) over empty, ready, pending and mixed ranges
+// of valueless and valued futures, including futures that stay pending until
+// long after the combined future was built, and a halo-exchange style wave of
+// rput's to every neighbor.
+
+using upcxx::future;
+using upcxx::promise;
+
+int main() {
+  upcxx::init();
+
+  print_test_header();
+
+  const int me = upcxx::rank_me();
+  const int n = upcxx::rank_n();
+
+  { // empty ranges are ready
+    std::vector<future<>> none;
+    UPCXX_ASSERT_ALWAYS(upcxx::when_all(none.begin(), none.end()).ready());
+
+    std::vector<future<int>> none_int;
+    future<std::vector<int>> f = upcxx::when_all(none_int.begin(), none_int.end());
+    UPCXX_ASSERT_ALWAYS(f.ready() && f.result().empty());
+  }
+
+  { // all ready: values come back in range order
+    std::list<future<std::string>> fs;
+    for(int i = 0; i < 10; i++)
+      fs.push_back(upcxx::make_future(std::to_string(i)));
+
+    future<std::vector<std::string>> f = upcxx::when_all(fs.begin(), fs.end());
+    UPCXX_ASSERT_ALWAYS(f.ready());
+    for(int i = 0; i < 10; i++)
+      UPCXX_ASSERT_ALWAYS(f.result()[i] == std::to_string(i));
+  }
+
+  { // pending promises fulfilled in reverse order, some already ready
+    const int k = 100;
+    std::vector<promise<int>> pros(k);
+    std::vector<future<int>> fs;
+    for(int i = 0; i < k; i++) {
+      if(i % 7 == 0) pros[i].fulfill_result(i*i);
+      fs.push_back(pros[i].get_future());
+    }
+
+    future<std::vector<int>> all = upcxx::when_all(fs.begin(), fs.end());
+    future<long> sum = all.then([](std::vector<int> const &v) {
+      long s = 0;
+      for(int x: v) s += x;
+      return s;
+    });
+    fs.clear(); // the combined future keeps its own references
+
+    for(int i = k-1; i >= 0; i--) {
+      if(i % 7 == 0) continue;
+      UPCXX_ASSERT_ALWAYS(!all.ready());
+      pros[i].fulfill_result(i*i);
+    }
+
+    std::vector<int> v = all.wait();
+    long expect = 0;
+    for(int i = 0; i < k; i++) {
+      UPCXX_ASSERT_ALWAYS(v[i] == i*i, "value " << i << " was " << v[i]);
+      expect += i*i;
+    }
+    UPCXX_ASSERT_ALWAYS(sum.wait() == expect);
+  }
+
+  { // a combined future dropped before its inputs are ready
+    promise<> pro;
+    std::vector<future<>> fs(3, pro.get_future());
+    upcxx::when_all(fs.begin(), fs.end());
+    pro.fulfill_anonymous(1);
+    UPCXX_ASSERT_ALWAYS(fs[0].ready());
+  }
+
+  { // halo exchange: one rput to every other rank per step
+    const int steps = 20;
+    upcxx::global_ptr<int> halo = upcxx::new_array<int>(n*steps);
+    upcxx::dist_object<upcxx::global_ptr<int>> dobj(halo);
+    std::vector<upcxx::global_ptr<int>> peers(n);
+    for(int r = 0; r < n; r++)
+      peers[r] = dobj.fetch(r).wait();
+
+    for(int s = 0; s < steps; s++) {
+      std::vector<future<>> puts;
+      for(int r = 0; r < n; r++)
+        puts.push_back(upcxx::rput(100*s + me, peers[r] + s*n + me));
+      upcxx::when_all(puts.begin(), puts.end()).wait();
+
+      std::vector<future<int>> sums;
+      for(int r = 0; r < n; r++)
+        sums.push_back(upcxx::rpc(r, [](int x) { return x + 1; }, s));
+      std::vector<int> got = upcxx::when_all(sums.begin(), sums.end()).wait();
+      for(int x: got)
+        UPCXX_ASSERT_ALWAYS(x == s + 1);
+    }
+
+    upcxx::barrier();
+    for(int s = 0; s < steps; s++)
+      for(int r = 0; r < n; r++)
+        UPCXX_ASSERT_ALWAYS(halo.local()[s*n + r] == 100*s + r, "halo step " << s << " from " << r);
+
+    upcxx::barrier();
+    upcxx::delete_array(halo);
+  }
+
+  // the variadic form still takes two futures of the same type
+  future<int, int> two = upcxx::when_all(upcxx::make_future(1), upcxx::make_future(2));
+  UPCXX_ASSERT_ALWAYS(two.result<0>() + two.result<1>() == 3);
+
+  print_test_success();
+
+  upcxx::finalize();
+  return 0;
+}